@@ -0,0 +1,52 @@
+#ifndef ALIGNED_ALLOCATOR_HPP_
+#define ALIGNED_ALLOCATOR_HPP_
+
+#include <cstddef>
+#include <new>
+#include <vector>
+
+namespace poly {
+
+// Alignment of the SoA buffers handed to vectorized kernels. 64 bytes is a cache line, and a full AVX-512 register.
+constexpr std::size_t kSimdAlignment = 64;
+
+// Allocator that aligns every allocation to Alignment bytes and rounds its size up to a multiple of Alignment, so a
+// kernel may always load a whole vector past the last element without leaving the allocation.
+template <typename T, std::size_t Alignment = kSimdAlignment>
+struct AlignedAllocator {
+    using value_type = T;
+
+    template <typename U>
+    struct rebind {
+        using other = AlignedAllocator<U, Alignment>;
+    };
+
+    AlignedAllocator() noexcept = default;
+    template <typename U>
+    AlignedAllocator(const AlignedAllocator<U, Alignment>&) noexcept {}
+
+    T* allocate(std::size_t n) {
+        std::size_t bytes = (n * sizeof(T) + Alignment - 1) / Alignment * Alignment;
+        return static_cast<T*>(::operator new(bytes, std::align_val_t(Alignment)));
+    }
+
+    void deallocate(T* p, std::size_t) noexcept {
+        ::operator delete(p, std::align_val_t(Alignment));
+    }
+
+    template <typename U>
+    bool operator==(const AlignedAllocator<U, Alignment>&) const noexcept {
+        return true;
+    }
+    template <typename U>
+    bool operator!=(const AlignedAllocator<U, Alignment>&) const noexcept {
+        return false;
+    }
+};
+
+template <typename T>
+using AlignedVector = std::vector<T, AlignedAllocator<T>>;
+
+}  // namespace poly
+
+#endif
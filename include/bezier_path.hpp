@@ -0,0 +1,102 @@
+#ifndef BEZIER_PATH_HPP_
+#define BEZIER_PATH_HPP_
+
+#include <cstdint>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include <point_batch.hpp>
+#include <poly_io.hpp>
+
+namespace poly {
+
+// BezierPath is an outline made of straight, quadratic and cubic Bezier segments, like a font glyph or an SVG path.
+// MoveTo() starts a new contour; the segments that follow each start where the previous one ended. Like the rings of a
+// MultiPolygon, holes are expected to wind the opposite way to the contour around them.
+struct BezierPath {
+    enum class Segment : uint8_t {
+        kMove,       // one point, the start of a contour
+        kLine,       // one point, the end
+        kQuadratic,  // two points, the control point and the end
+        kCubic,      // three points, two control points and the end
+    };
+
+    void MoveTo(float x, float y);
+
+    // Draw from the end of the last segment, starting a contour at (0, 0) if there is none yet.
+    void LineTo(float x, float y);
+    void QuadraticTo(float control_x, float control_y, float x, float y);
+    void CubicTo(float control1_x, float control1_y, float control2_x, float control2_y, float x, float y);
+
+    // Ensures every contour ends where it starts, adding a line where one does not.
+    void ClosePolygon();
+
+    // Detects whether every contour ends where it starts, up to some tolerance. An empty path is not closed.
+    bool IsClosed(float tolerance = 0.f) const;
+
+    // Number of points, control points included.
+    size_t size() const;
+
+    // The path with each curved segment replaced by `pieces` straight lines of equal parameter steps, one ring per
+    // contour.
+    MultiPolygon Flatten(size_t pieces) const;
+
+    // data members: one entry per segment, and the points they consume, in order
+    std::vector<Segment> segments_;
+    std::vector<float> x_vec_;
+    std::vector<float> y_vec_;
+};
+
+}  // namespace poly
+
+namespace winding_number {
+
+// PreparedBezierPath answers winding number queries on a BezierPath without flattening it. Each curved segment is cut,
+// once, at the parameters where x or y turns around, into pieces that are monotone in both. The bounding box of such
+// a piece is given by its end points, and a horizontal line meets it at most once, so a query counts crossings as for
+// straight edges: most pieces are settled by comparing end points, and the rest by solving the piece's cubic for the
+// one parameter where it reaches the query's y.
+//
+// The cost is proportional to the number of segments rather than to a flattened vertex count, and there is no
+// flattening error. Straight segments follow edge_crossing.hpp exactly, so a path of lines gives the same results as
+// the "scalar" algorithm. Points on a curved segment are found to be on the boundary only when the solved point on the
+// curve is exactly the query point in double precision.
+class PreparedBezierPath {
+public:
+    // A path that is not closed up to tolerance is kept, but every query on it returns std::nullopt.
+    explicit PreparedBezierPath(const poly::BezierPath& path, float tolerance = 0.f);
+
+    // Returns the total winding number of (x, y) over all contours, or std::nullopt if the path is not closed.
+    std::optional<int> CalculateWindingNumber2D(float x, float y) const;
+
+    // Returns the winding numbers of every point in the batch, in the order of the batch.
+    std::vector<std::optional<int>> CalculateWindingNumbers2D(const poly::PointBatch& points) const;
+
+    // Number of pieces the curved segments were cut into.
+    size_t piece_count() const noexcept;
+
+private:
+    // A piece of a curved segment, monotone in x and in y, as a cubic in power form: x(t) = ((x[0] t + x[1]) t +
+    // x[2]) t + x[3] for t in [0, 1], and the same for y. The end points are the exact ones from subdividing the
+    // segment, which neighbouring pieces share.
+    struct Piece {
+        double x[4];
+        double y[4];
+        double x_start, y_start, x_end, y_end;
+    };
+
+    struct Line {
+        float x0, y0, x1, y1;
+    };
+
+    bool closed_;
+    std::vector<Line> lines_;
+    // Sorted by their lowest y, with the lowest and highest y of each kept apart, where the scan reads them.
+    std::vector<Piece> pieces_;
+    std::vector<std::pair<double, double>> y_ranges_;
+};
+
+}  // namespace winding_number
+
+#endif
@@ -0,0 +1,86 @@
+#ifndef CONTAINMENT_HIERARCHY_HPP_
+#define CONTAINMENT_HIERARCHY_HPP_
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <edge_bvh.hpp>
+#include <point_batch.hpp>
+#include <poly_io.hpp>
+
+namespace winding_number {
+
+// ContainmentHierarchy answers which of a set of nested polygons contain a point -- geofences such as country, region,
+// site and zone -- by testing a polygon only once its parent is known to contain the point. A point in one country is
+// never tested against the regions of another, so a query costs a few tests per level instead of one per polygon.
+//
+// The nesting is either given, as a parent for each polygon, or detected: a polygon is placed under the innermost
+// polygon of at least its area that has all of its vertices inside or on the boundary. Detection only looks at
+// vertices, so a child whose edges leave a non-convex parent between vertices is still taken to nest in it; pass the
+// parents explicitly where that matters. Given parents are trusted: a point in a child but outside its parent is not
+// found.
+//
+// A polygon contains a point when its winding number there is not zero, with boundary points inside. Siblings may
+// overlap, and a point in several of them is reported in each. A polygon that is not closed up to tolerance, or given
+// parents that are out of range or form a cycle, leave valid() false, and every query then returns an empty path.
+class ContainmentHierarchy {
+public:
+    // Detects the nesting.
+    explicit ContainmentHierarchy(const std::vector<poly::Polygon>& polygons, float tolerance = 0.f);
+
+    // Takes the nesting as given: parents[i] is the index of the polygon that polygon i nests in, or std::nullopt for
+    // one at the top level.
+    ContainmentHierarchy(const std::vector<poly::Polygon>& polygons, const std::vector<std::optional<size_t>>& parents,
+                         float tolerance = 0.f);
+
+    // Returns the indices of the polygons containing (x, y), each after its parent: outermost first, the innermost
+    // last. Overlapping siblings put their subtrees one after the other.
+    std::vector<size_t> FindPath(float x, float y) const;
+
+    // Returns FindPath() for every point in the batch, in the order of the batch, split across up to thread_count
+    // threads (0 means DefaultThreadCount()).
+    std::vector<std::vector<size_t>> FindPaths(const poly::PointBatch& points, size_t thread_count = 0) const;
+
+    // The polygon that a polygon nests in, or std::nullopt at the top level.
+    std::optional<size_t> parent(size_t polygon) const;
+
+    // Whether the hierarchy could be built, and what is wrong with the input if it couldn't.
+    bool valid() const noexcept;
+    const std::string& error_message() const noexcept;
+
+    // Number of polygons at the top level and of levels, mostly useful for tests and tuning.
+    size_t root_count() const noexcept;
+    size_t depth() const noexcept;
+
+private:
+    static constexpr uint32_t kNone = UINT32_MAX;
+
+    // A polygon's place in the tree. Its children are nodes first_child ... first_child + child_count - 1, so the
+    // boxes of siblings are scanned in one pass.
+    struct Node {
+        float min_x, min_y, max_x, max_y;
+        uint32_t polygon;
+        uint32_t first_child;
+        uint32_t child_count;
+    };
+
+    bool Prepare(const std::vector<poly::Polygon>& polygons, float tolerance);
+    bool Contains(uint32_t polygon, float x, float y) const;
+    bool Nests(const poly::Polygon& child, uint32_t parent) const;
+    void Build(const std::vector<poly::Polygon>& polygons, std::vector<std::vector<uint32_t>> children);
+    void FindPath(uint32_t node, float x, float y, std::vector<size_t>& path) const;
+    void Fail(std::string error_message);
+
+    bool valid_ = true;
+    std::string error_message_;
+    std::vector<EdgeBvh> engines_;   // by polygon
+    std::vector<uint32_t> parents_;  // by polygon
+    std::vector<Node> nodes_;        // node 0 is the plane, with the top level as its children
+    size_t depth_ = 0;
+};
+
+}  // namespace winding_number
+
+#endif
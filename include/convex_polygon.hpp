@@ -0,0 +1,53 @@
+#ifndef CONVEX_POLYGON_HPP_
+#define CONVEX_POLYGON_HPP_
+
+#include <optional>
+#include <vector>
+
+#include <point_batch.hpp>
+#include <poly_io.hpp>
+
+namespace winding_number {
+
+// ConvexPolygon checks once whether a closed polygon is convex, and if it is, answers each query in O(log n) by binary
+// searching the fan of triangles around its first corner for the wedge that holds the point.
+//
+// The boundary of a convex polygon passes through each of its points exactly once, so a query is 1 on the boundary,
+// the polygon's orientation (+1 counter-clockwise, -1 clockwise) inside and 0 outside -- the same results as the
+// edge_crossing.hpp engines. Repeated vertices and vertices in the middle of a straight side are allowed, since they
+// don't change the shape. Polygons that are not convex, including ones that wind around more than once, are answered
+// by walking every edge instead.
+class ConvexPolygon {
+public:
+    // Checks convexity and keeps the corners. A polygon that is not closed up to tolerance is kept, but every query on
+    // it returns std::nullopt -- like CalculateWindingNumber2D() does.
+    explicit ConvexPolygon(const poly::Polygon& polygon, float tolerance = 0.f);
+
+    // Returns the winding number of (x, y) with respect to the polygon, or std::nullopt if the polygon is not closed.
+    std::optional<int> CalculateWindingNumber2D(float x, float y) const;
+
+    // Returns the winding numbers of every point in the batch, in the order of the batch.
+    std::vector<std::optional<int>> CalculateWindingNumbers2D(const poly::PointBatch& points) const;
+
+    // Whether queries take the O(log n) path.
+    bool convex() const noexcept;
+
+    // +1 for counter-clockwise and -1 for clockwise convex polygons, 0 for polygons that are not convex.
+    int orientation() const noexcept;
+
+private:
+    int ConvexWindingNumber(float x, float y) const;
+    int GeneralWindingNumber(float x, float y) const;
+
+    bool closed_;
+    int orientation_ = 0;
+
+    // For convex polygons, the corners in counter-clockwise order, without the closing point. Otherwise the polygon
+    // as given.
+    std::vector<float> x_vec_;
+    std::vector<float> y_vec_;
+};
+
+}  // namespace winding_number
+
+#endif
@@ -0,0 +1,66 @@
+#ifndef EDGE_BVH_HPP_
+#define EDGE_BVH_HPP_
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include <point_batch.hpp>
+#include <poly_io.hpp>
+
+namespace winding_number {
+
+// EdgeBvh is a bounding volume hierarchy over the y-monotone edge chains of a closed polygon, built once and then
+// queried many times.
+//
+// Every node covers a contiguous run of chains, i.e. a connected piece of the polygon's boundary. When the whole piece
+// lies to the right of the query point, its net contribution to the ray is fixed by the y of its first and last
+// vertex alone, so the node is answered in O(1) without visiting its edges. Only nodes whose bounding box straddles
+// the query point are descended into, and inside a leaf each monotone chain is binary searched for the edges at the
+// query's y. That keeps queries logarithmic for spirals and other polygons that wind around a point many times.
+//
+// Results match IWindingNumberAlgorithm::Create() for points off the boundary. Points on the boundary report the
+// number of times the boundary passes through them (see edge_crossing.hpp).
+class EdgeBvh {
+public:
+    // Builds the hierarchy. A polygon that is not closed up to tolerance is kept, but every query on it returns
+    // std::nullopt -- like CalculateWindingNumber2D() does.
+    explicit EdgeBvh(const poly::Polygon& polygon, float tolerance = 0.f);
+
+    // Returns the winding number of (x, y) with respect to the polygon, or std::nullopt if the polygon is not closed.
+    std::optional<int> CalculateWindingNumber2D(float x, float y) const;
+
+    // Returns the winding numbers of every point in the batch, in the order of the batch.
+    std::vector<std::optional<int>> CalculateWindingNumbers2D(const poly::PointBatch& points) const;
+
+    // Number of y-monotone chains and hierarchy nodes, mostly useful for tests and tuning.
+    size_t chain_count() const noexcept;
+    size_t node_count() const noexcept;
+
+private:
+    struct Chain {
+        uint32_t first_vertex;  // the chain's edges are first_vertex -> first_vertex + 1 ... last_vertex - 1 -> last_vertex
+        uint32_t last_vertex;
+        bool ascending;  // whether y is non-decreasing along the chain
+    };
+
+    struct Node {
+        float min_x, min_y, max_x, max_y;
+        float first_y, last_y;  // y of the first and last vertex of the boundary piece
+        uint32_t left;          // index of the first child, or of the first chain for a leaf
+        uint32_t count;         // 0 for an inner node (children are left and left + 1), else the chain count of a leaf
+    };
+
+    void Build(uint32_t index, uint32_t first_chain, uint32_t chain_count);
+    void QueryChain(const Chain& chain, float x, float y, int& winding_number, int& contacts) const;
+
+    bool closed_;
+    std::vector<float> x_vec_;
+    std::vector<float> y_vec_;
+    std::vector<Chain> chains_;
+    std::vector<Node> nodes_;
+};
+
+}  // namespace winding_number
+
+#endif
@@ -0,0 +1,47 @@
+#ifndef EDGE_CROSSING_HPP_
+#define EDGE_CROSSING_HPP_
+
+namespace winding_number {
+
+// Shared per-edge predicates for the crossing-based winding number engines.
+//
+// All of them cast a ray from the query point (x, y) in the +x direction. An edge going upwards through the ray adds
+// one to the winding number and an edge going downwards subtracts one. Edges are treated as half-open in y (the lower
+// endpoint is included, the upper one is not), so a ray through a vertex is counted exactly once.
+//
+// Points lying on the boundary are handled separately: an edge "contains" a point when the point lies on it, counting
+// the start vertex but not the end vertex. Summed over a closed polygon, that is the number of times the boundary
+// passes through the point, which is what the engines report for boundary points.
+
+// Returns > 0 when (x, y) is left of the directed edge (x0, y0) -> (x1, y1), < 0 when it is right of it and 0 when the
+// three points are collinear. Evaluated in double, where the differences of the float inputs are (almost always) exact.
+inline double EdgeSide(float x0, float y0, float x1, float y1, float x, float y) {
+    return (double(x1) - double(x0)) * (double(y) - double(y0)) - (double(x) - double(x0)) * (double(y1) - double(y0));
+}
+
+// Returns +1 or -1 when the edge crosses the ray cast from (x, y) going up or down respectively, otherwise 0.
+inline int EdgeCrossing(float x0, float y0, float x1, float y1, float x, float y) {
+    if (y0 <= y) {
+        if (y1 > y && EdgeSide(x0, y0, x1, y1, x, y) > 0) {
+            return 1;
+        }
+    } else if (y1 <= y && EdgeSide(x0, y0, x1, y1, x, y) < 0) {
+        return -1;
+    }
+    return 0;
+}
+
+// Returns true when (x, y) lies on the edge, including its start vertex but excluding its end vertex.
+inline bool EdgeContainsPoint(float x0, float y0, float x1, float y1, float x, float y) {
+    if (x == x1 && y == y1) {
+        return false;
+    }
+    if ((x < x0 && x < x1) || (x > x0 && x > x1) || (y < y0 && y < y1) || (y > y0 && y > y1)) {
+        return false;
+    }
+    return EdgeSide(x0, y0, x1, y1, x, y) == 0;
+}
+
+}  // namespace winding_number
+
+#endif
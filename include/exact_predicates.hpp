@@ -0,0 +1,28 @@
+#ifndef EXACT_PREDICATES_HPP_
+#define EXACT_PREDICATES_HPP_
+
+#include <optional>
+
+#include <poly_io.hpp>
+
+namespace winding_number {
+
+// Exact versions of the predicates in edge_crossing.hpp.
+//
+// Every float is a rational number with a power of two denominator, so the orientation of three float points can be
+// decided exactly with floating-point expansion arithmetic (sums of non-overlapping doubles, as in Shewchuk's
+// "Adaptive Precision Floating-Point Arithmetic"). A double precision estimate with an error bound settles all but
+// nearly collinear points, but the rest are far slower than the double precision predicates. They are meant as the
+// reference the fast engines are checked against, and for preparing polygons, where a wrong sign can't be afforded.
+
+// Returns +1 when (x, y) is left of the directed edge (x0, y0) -> (x1, y1), -1 when it is right of it and 0 when the
+// three points are exactly collinear.
+int ExactEdgeSide(float x0, float y0, float x1, float y1, float x, float y);
+
+// Returns the winding number of (x, y) with respect to the polygon, using the crossing and boundary rules of
+// edge_crossing.hpp with exact arithmetic, or std::nullopt if the polygon is not closed up to tolerance.
+std::optional<int> ExactWindingNumber2D(float x, float y, const poly::Polygon& polygon, float tolerance = 0.f);
+
+}  // namespace winding_number
+
+#endif
@@ -0,0 +1,129 @@
+#ifndef INSTRUMENTATION_HPP_
+#define INSTRUMENTATION_HPP_
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+// Counters and latency histograms for winding_lib, compiled in only when WINDING_INSTRUMENTATION is defined to 1 (the
+// WINDING_NUMBER_INSTRUMENTATION CMake option). Without it the WINDING_COUNT and WINDING_TIME_CALL hooks expand to
+// nothing, and snapshots are all zeros.
+//
+// Every thread counts into its own block, written only by that thread with relaxed stores, so the hot path has no
+// locked instructions and shares no cache lines. TakeSnapshot() sums all the blocks with relaxed loads; a snapshot
+// taken while other threads are counting is exact for each counter, but not across counters.
+
+#ifndef WINDING_INSTRUMENTATION
+#define WINDING_INSTRUMENTATION 0
+#endif
+
+namespace winding_number::instrumentation {
+
+enum class Counter {
+    kCalls,              // winding numbers computed, one per point
+    kVertices,           // vertices or edges visited by those computations
+    kOnEdge,             // points found on the boundary, which take the boundary counting path
+    kEarlyRejects,       // points answered by a bounding box test without visiting any edge
+    kUnclosedPolygons,   // std::nullopt returned because a polygon or ring was not closed
+};
+
+constexpr size_t kCounterCount = 5;
+
+// Latencies are bucketed by powers of two: bucket i holds calls that took [2^i, 2^(i+1)) nanoseconds, bucket 0 also
+// holds calls under a nanosecond, and the last bucket holds everything longer.
+constexpr size_t kLatencyBucketCount = 40;
+
+constexpr bool Enabled() noexcept {
+    return WINDING_INSTRUMENTATION != 0;
+}
+
+struct Snapshot {
+    std::array<uint64_t, kCounterCount> counters{};
+    std::array<uint64_t, kLatencyBucketCount> latency_buckets{};
+
+    uint64_t count(Counter counter) const noexcept;
+
+    // Number of calls whose latency was recorded.
+    uint64_t latency_count() const noexcept;
+
+    // Upper bound, in nanoseconds, of the bucket holding the given quantile (0 to 1) of the recorded latencies, or 0
+    // when nothing was recorded.
+    uint64_t LatencyQuantileNs(double quantile) const noexcept;
+};
+
+// The counts between two snapshots, `later - earlier`.
+Snapshot operator-(const Snapshot& later, const Snapshot& earlier) noexcept;
+
+// Sums the counts of every thread that has ever counted, including threads that have exited.
+Snapshot TakeSnapshot();
+
+// One thread's counts. Blocks are kept for the lifetime of the process and reused by later threads, so counts are
+// never lost when a thread exits.
+struct alignas(64) ThreadCounters {
+    std::array<std::atomic<uint64_t>, kCounterCount> counters{};
+    std::array<std::atomic<uint64_t>, kLatencyBucketCount> latency_buckets{};
+    std::atomic<bool> in_use{false};
+    ThreadCounters* next = nullptr;
+};
+
+// Returns a block for the calling thread, registering a new one if no exited thread left one behind.
+ThreadCounters* AcquireThreadCounters();
+void ReleaseThreadCounters(ThreadCounters* counters) noexcept;
+
+inline ThreadCounters& LocalCounters() {
+    struct Holder {
+        ThreadCounters* counters = AcquireThreadCounters();
+        ~Holder() {
+            ReleaseThreadCounters(counters);
+        }
+    };
+    thread_local Holder holder;
+    return *holder.counters;
+}
+
+// Only the owning thread writes a block, so a plain load and store is enough.
+inline void Increment(std::atomic<uint64_t>& value, uint64_t n) noexcept {
+    value.store(value.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+}
+
+inline void Add(Counter counter, uint64_t n = 1) {
+    Increment(LocalCounters().counters[static_cast<size_t>(counter)], n);
+}
+
+inline void RecordLatency(std::chrono::nanoseconds latency) {
+    size_t bucket = 0;
+    for (auto ns = static_cast<uint64_t>(latency.count()); ns > 1 && bucket + 1 < kLatencyBucketCount; ns >>= 1) {
+        ++bucket;
+    }
+    Increment(LocalCounters().latency_buckets[bucket], 1);
+}
+
+// Records the time from construction to destruction.
+class ScopedLatency {
+public:
+    ScopedLatency() : start_(std::chrono::steady_clock::now()) {}
+    ~ScopedLatency() {
+        RecordLatency(std::chrono::steady_clock::now() - start_);
+    }
+
+    ScopedLatency(const ScopedLatency&) = delete;
+    ScopedLatency& operator=(const ScopedLatency&) = delete;
+
+private:
+    std::chrono::steady_clock::time_point start_;
+};
+
+}  // namespace winding_number::instrumentation
+
+#if WINDING_INSTRUMENTATION
+#define WINDING_COUNT(counter, n) \
+    ::winding_number::instrumentation::Add(::winding_number::instrumentation::Counter::counter, (n))
+#define WINDING_TIME_CALL() ::winding_number::instrumentation::ScopedLatency winding_scoped_latency_
+#else
+#define WINDING_COUNT(counter, n) ((void)0)
+#define WINDING_TIME_CALL() ((void)0)
+#endif
+
+#endif
@@ -0,0 +1,92 @@
+#ifndef MESH_BVH_HPP_
+#define MESH_BVH_HPP_
+
+#include <cstdint>
+#include <vector>
+
+#include <point_batch.hpp>
+#include <poly_io.hpp>
+
+namespace winding_number {
+
+// An approximate generalized winding number, and a bound on its distance from the exact one.
+struct ApproximateWindingNumber {
+    double winding_number = 0.0;
+    double error_bound = 0.0;
+};
+
+// MeshBvh answers generalized winding number queries on a TriangleMesh: the solid angle the mesh subtends at the query
+// point, over 4 pi. For a closed mesh facing outwards that is 1 inside and 0 outside, as the 2D winding number would
+// be; for a mesh with holes or gaps it varies smoothly between the two, so thresholding it at 1/2 still classifies
+// points robustly (Jacobson et al. 2013). Points on the mesh itself have no winding number, and get some value between
+// those on either side.
+//
+// The exact calls sum the solid angle of every triangle, so they cost time proportional to the triangle count. The
+// approximate calls go through a bounding volume hierarchy (Barill et al. 2018), where each node keeps the moments of
+// its triangles about its center. A node far enough from the query point contributes a second order Taylor expansion
+// of its triangles' solid angles, built from those moments; a node that is too close is opened, and the triangles of
+// near leaves are summed exactly. For points away from the mesh the cost grows with the logarithm of the triangle
+// count.
+//
+// "Far enough" is decided by the remainder of the expansion, which is at most 4 A r^3 / (4 pi (d - r)^5) for a node of
+// total triangle area A within radius r of its center, at distance d from the query point. A node is expanded only
+// when that bound is within the tolerance times the node's share of the mesh's area, so the bounds of all the
+// expanded nodes add up to at most the tolerance. The sum is returned with the result; it is rigorous up to rounding,
+// and typically orders of magnitude above the actual error.
+class MeshBvh {
+public:
+    static constexpr double kDefaultTolerance = 1e-3;
+
+    explicit MeshBvh(const poly::TriangleMesh& mesh);
+
+    // Returns the exact generalized winding number of (x, y, z), up to rounding.
+    double CalculateWindingNumber3D(float x, float y, float z) const;
+
+    // Returns the generalized winding number of (x, y, z) to within the tolerance, using the hierarchy.
+    ApproximateWindingNumber CalculateApproximateWindingNumber3D(float x, float y, float z,
+                                                                 double tolerance = kDefaultTolerance) const;
+
+    // Batch versions of the calls above, split over up to thread_count threads (0 means DefaultThreadCount()), with
+    // the results in the order of the points.
+    std::vector<double> CalculateWindingNumbers3D(const std::vector<poly::Point3D>& points,
+                                                  size_t thread_count = 0) const;
+    std::vector<ApproximateWindingNumber> CalculateApproximateWindingNumbers3D(
+            const std::vector<poly::Point3D>& points, double tolerance = kDefaultTolerance,
+            size_t thread_count = 0) const;
+
+    size_t triangle_count() const noexcept;
+    size_t node_count() const noexcept;
+
+private:
+    struct Triangle {
+        double a[3], b[3], c[3];
+    };
+
+    // A node holds the triangles [first, first + count) of triangles_. An inner node's children are the next node and
+    // the one at `second_child`; a leaf has second_child 0.
+    struct Node {
+        double center[3];
+        double radius;
+        double area;
+        // Sums over the triangles of the area vector (normal times area) n A, and of the integrals of n (x - c) and
+        // n (x - c) (x - c) over the triangle, where c is the center: n[i] (x - c)[j] at moment[3 i + j], and
+        // n[i] (x - c)[j] (x - c)[k] at second_moment[9 i + 3 j + k].
+        double area_vector[3];
+        double moment[9];
+        double second_moment[27];
+        uint32_t first;
+        uint32_t count;
+        uint32_t second_child;
+    };
+
+    uint32_t Build(std::vector<uint32_t>& order, const std::vector<Triangle>& triangles, uint32_t first,
+                   uint32_t count);
+    double SumTriangles(const double p[3], uint32_t first, uint32_t count) const;
+
+    std::vector<Triangle> triangles_;
+    std::vector<Node> nodes_;
+};
+
+}  // namespace winding_number
+
+#endif
@@ -0,0 +1,67 @@
+#ifndef PARALLEL_HPP_
+#define PARALLEL_HPP_
+
+#include <algorithm>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace winding_number {
+
+// Number of threads used when a caller asks for 0: one per hardware thread, and at least one.
+inline size_t DefaultThreadCount() {
+    return std::max<size_t>(std::thread::hardware_concurrency(), 1);
+}
+
+// Calls fn(i) for every i in [0, count), split into contiguous chunks that run on up to thread_count threads (0 means
+// DefaultThreadCount()). The calling thread runs the first chunk itself. If any call throws, the first exception is
+// rethrown once every thread has finished.
+template <typename Fn>
+void ParallelFor(size_t count, Fn&& fn, size_t thread_count = 0) {
+    if (thread_count == 0) {
+        thread_count = DefaultThreadCount();
+    }
+    thread_count = std::min(thread_count, count);
+    if (thread_count <= 1) {
+        for (size_t i = 0; i < count; ++i) {
+            fn(i);
+        }
+        return;
+    }
+
+    std::exception_ptr error;
+    std::mutex error_mutex;
+    auto run_chunk = [&](size_t chunk) {
+        const size_t begin = count * chunk / thread_count;
+        const size_t end = count * (chunk + 1) / thread_count;
+        try {
+            for (size_t i = begin; i < end; ++i) {
+                fn(i);
+            }
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(error_mutex);
+            if (!error) {
+                error = std::current_exception();
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(thread_count - 1);
+    for (size_t chunk = 1; chunk < thread_count; ++chunk) {
+        threads.emplace_back(run_chunk, chunk);
+    }
+    run_chunk(0);
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+}  // namespace winding_number
+
+#endif
@@ -0,0 +1,101 @@
+#ifndef PLANAR_SUBDIVISION_HPP_
+#define PLANAR_SUBDIVISION_HPP_
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <point_batch.hpp>
+#include <poly_io.hpp>
+
+namespace winding_number {
+
+// PlanarSubdivision answers which of a set of polygons contains a point, when the polygons partition (part of) the
+// plane the way administrative boundaries do: they don't overlap, and neighbours share their common edges, vertex
+// for vertex. Shared edges are stored once, so a query costs one point location instead of a winding number per
+// candidate polygon.
+//
+// The edges are merged into a trapezoidal map -- horizontal walls from every vertex, left and right to the nearest
+// edges -- built by inserting the edges in random order, with a search DAG of vertex and edge comparisons over it.
+// Each trapezoid is labelled with the polygon it lies in. That takes O(n) memory for n distinct edges, and a query
+// visits O(log n) nodes in expectation. Vertices are compared by y, then x, as if the plane were sheared ever so
+// slightly, so shared y coordinates and horizontal edges need no special cases.
+//
+// The polygons are checked as the map is built: each must be closed up to tolerance and have an area, and edges may
+// only meet at their ends, with neighbours on opposite sides. A set that fails is kept, but valid() is false and
+// every query returns std::nullopt.
+class PlanarSubdivision {
+public:
+    explicit PlanarSubdivision(const std::vector<poly::Polygon>& polygons, float tolerance = 0.f);
+
+    // Returns the index of the polygon containing (x, y), or std::nullopt if it is in none. Points on the boundary are
+    // placed as if moved right by an infinitesimal amount, then up by a much smaller one: they belong to the polygon
+    // right of an edge, or above a horizontal edge.
+    std::optional<size_t> FindPolygon(float x, float y) const;
+
+    // Returns FindPolygon() for every point in the batch, in the order of the batch, split across up to thread_count
+    // threads (0 means DefaultThreadCount()).
+    std::vector<std::optional<size_t>> FindPolygons(const poly::PointBatch& points, size_t thread_count = 0) const;
+
+    // Whether the polygons form a subdivision, and what is wrong with them if they don't.
+    bool valid() const noexcept;
+    const std::string& error_message() const noexcept;
+
+    // Number of distinct edges, of trapezoids and of search nodes, mostly useful for tests and tuning.
+    size_t edge_count() const noexcept;
+    size_t trapezoid_count() const noexcept;
+    size_t node_count() const noexcept;
+
+private:
+    static constexpr uint32_t kNone = UINT32_MAX;
+
+    // An edge between two distinct vertices, p before q in (y, x) order, with the polygons on either side of it.
+    struct Segment {
+        uint32_t p, q;
+        uint32_t left_polygon = kNone;
+        uint32_t right_polygon = kNone;
+    };
+
+    // A trapezoid of the map while it is being built: the edges left and right of it, and the vertices whose walls
+    // bound it below and above. kNone stands for the unbounded side.
+    struct Trapezoid {
+        uint32_t left_edge, right_edge;
+        uint32_t bottom_vertex, top_vertex;
+        uint32_t node;  // its leaf in the search DAG
+    };
+
+    // A search DAG node: a vertex, whose wall splits the plane into the points before it in (y, x) order and the rest;
+    // an edge, with the points left of it and the rest; or a leaf, holding a trapezoid while the map is built and then
+    // a polygon.
+    struct Node {
+        enum Kind : uint8_t { kVertex, kEdge, kLeaf } kind;
+        uint32_t index;
+        uint32_t low = kNone, high = kNone;  // before or left, and the rest
+    };
+
+    int Side(const Segment& segment, uint32_t vertex) const;
+    bool Interfere(const Segment& a, const Segment& b) const;
+    bool RightOf(uint32_t s, uint32_t t);
+    uint32_t LocateSegment(uint32_t s, uint32_t vertex);
+    uint32_t AddTrapezoid(uint32_t left_edge, uint32_t right_edge, uint32_t bottom_vertex, uint32_t top_vertex);
+    uint32_t AddNode(Node node);
+    void Insert(uint32_t s);
+    void LabelTrapezoids();
+    void Fail(std::string error_message);
+
+    bool valid_ = true;
+    std::string error_message_;
+    // Distinct vertices in (y, x) order, so that vertices compare by index.
+    std::vector<float> x_vec_;
+    std::vector<float> y_vec_;
+    std::vector<Segment> segments_;
+    std::vector<Trapezoid> trapezoids_;
+    std::vector<Node> nodes_;
+    std::vector<uint32_t> crossed_;  // scratch for Insert()
+    size_t trapezoid_count_ = 0;
+};
+
+}  // namespace winding_number
+
+#endif
@@ -0,0 +1,60 @@
+#ifndef POINT_BATCH_HPP_
+#define POINT_BATCH_HPP_
+
+#include <tuple>
+#include <vector>
+
+#include <aligned_allocator.hpp>
+#include <poly_io.hpp>
+
+namespace poly {
+
+// A point in the interleaved (array of structures) layout that upstream producers hand us.
+struct Point2D {
+    float x;
+    float y;
+};
+
+static_assert(sizeof(Point2D) == 2 * sizeof(float), "Point2D must be layout compatible with interleaved x, y floats");
+
+// A query point for the 3D algorithms, see mesh_bvh.hpp.
+struct Point3D {
+    float x;
+    float y;
+    float z;
+};
+
+// PointBatch is a batch of query points in structure of arrays layout -- the same layout as Polygon -- with both
+// arrays aligned to kSimdAlignment, so batch kernels can use aligned full-width loads.
+//
+// The adapters convert from interleaved buffers with a vectorized deinterleave, and from the reader's output.
+struct PointBatch {
+    PointBatch(size_t capacity = 0);
+
+    // Creates a batch from `count` interleaved points, i.e. x0 y0 x1 y1 ... x(count-1) y(count-1).
+    [[nodiscard]] static PointBatch FromInterleaved(const float* xy, size_t count);
+    [[nodiscard]] static PointBatch FromPoints(const std::vector<Point2D>& points);
+
+    // Creates a batch from the points of records produced by IPolygonReader.
+    [[nodiscard]] static PointBatch FromRecords(const std::vector<std::tuple<float, float, Polygon>>& records);
+
+    void AppendPoint(float x, float y);
+
+    // Appends `count` interleaved points to the batch.
+    void AppendInterleaved(const float* xy, size_t count);
+
+    size_t size() const;
+    void reserve(size_t capacity);
+    void clear();
+
+    // Writes the batch back out as `size()` interleaved points.
+    void CopyToInterleaved(float* xy) const;
+
+    // data members
+    AlignedVector<float> x_vec_;
+    AlignedVector<float> y_vec_;
+};
+
+}  // namespace poly
+
+#endif
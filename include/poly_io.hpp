@@ -5,16 +5,25 @@
 #ifndef POLY_IO_HPP_
 #define POLY_IO_HPP_
 
+#include <chrono>
+#include <cstdint>
 #include <memory>
+#include <string>
 #include <string_view>  // A C++17 capable compiler is assumed here.
 #include <tuple>
 #include <vector>
 
+#include <small_vector.hpp>
+
 namespace poly {
 
+// Polygons of up to this many points, the closing point included, are stored inside the Polygon without allocating.
+constexpr size_t kPolygonInlinePoints = 16;
+
 // Polygon represents a polygon in 2 dimensions, and is specified as an ordered series of points.
 struct Polygon {
-    Polygon(size_t capacity = 100);
+    // Reserves room for `capacity` points. Only capacities over kPolygonInlinePoints allocate.
+    Polygon(size_t capacity = 0);
 
     void AppendPoint(float x, float y);
     size_t size() const;
@@ -25,9 +34,153 @@ struct Polygon {
     // Detects whether the last point in the polygon is the same of the first, up to some tolerance.
     bool IsClosed(float tolerance = 0.f) const;
 
+    // data members
+    SmallVector<float, kPolygonInlinePoints> x_vec_;
+    SmallVector<float, kPolygonInlinePoints> y_vec_;
+};
+
+// MultiPolygon is a set of closed rings -- for instance the outer boundaries and holes of a GIS multipolygon -- stored
+// back to back in one pair of coordinate vectors. Ring i is made of the points in [ring_offsets_[i],
+// ring_offsets_[i + 1]), so ring_offsets_ always has ring_count() + 1 entries, the last of which is size().
+//
+// Holes are expected to wind the opposite way to the ring around them, so that winding numbers summed over all rings
+// are 0 inside a hole.
+struct MultiPolygon {
+    MultiPolygon(size_t capacity = 100);
+
+    // Starts a new, empty ring. Points appended afterwards belong to it.
+    void StartRing();
+
+    // Appends a point to the last ring, starting the first ring if there is none yet.
+    void AppendPoint(float x, float y);
+
+    // Appends all the points of a polygon as a new ring.
+    void AppendRing(const Polygon& ring);
+
+    size_t size() const;
+    size_t ring_count() const;
+
+    // Ensures every ring's last point is the same as its first.
+    void ClosePolygon();
+
+    // Detects whether every ring is closed, up to some tolerance. Empty rings are not closed.
+    bool IsClosed(float tolerance = 0.f) const;
+
     // data members
     std::vector<float> x_vec_;
     std::vector<float> y_vec_;
+    std::vector<size_t> ring_offsets_;
+};
+
+// TriangleMesh is a surface in 3 dimensions made of triangles that share a vertex list, such as one read from an OBJ
+// file. Triangle i is made of the vertices triangles_[3 i], triangles_[3 i + 1] and triangles_[3 i + 2], and faces the
+// side from which they appear counter-clockwise. The mesh need not be closed.
+struct TriangleMesh {
+    // Returns the index of the new vertex.
+    uint32_t AppendVertex(float x, float y, float z);
+
+    // Appends the triangle a -> b -> c. The vertices must already be in the mesh.
+    void AppendTriangle(uint32_t a, uint32_t b, uint32_t c);
+
+    size_t vertex_count() const;
+    size_t triangle_count() const;
+
+    // data members
+    std::vector<float> x_vec_;
+    std::vector<float> y_vec_;
+    std::vector<float> z_vec_;
+    std::vector<uint32_t> triangles_;
+};
+
+// What reading a file found in it. Every line is either a record, a comment (its first non-blank character is '#'), a
+// blank line, or malformed. Line numbers start at 1.
+struct ReadStatistics {
+    size_t bytes_read = 0;
+    size_t lines = 0;
+    size_t records = 0;
+    size_t comment_lines = 0;
+    size_t blank_lines = 0;
+    std::vector<size_t> malformed_lines;
+
+    // Time spent parsing lines, and in the whole read including I/O.
+    std::chrono::nanoseconds parse_time{0};
+    std::chrono::nanoseconds read_time{0};
+
+    // Throughput over read_time, or 0 if nothing was timed.
+    double bytes_per_second() const;
+    double records_per_second() const;
+};
+
+// What a line of text held, as far as the reader is concerned.
+enum class ParseStatus {
+    kOk,         // a record
+    kComment,    // the first non-blank character is '#'
+    kBlank,      // nothing but delimiters
+    kMalformed,  // an attempted record that could not be parsed
+};
+
+// The outcome of parsing one record, as returned by the non-throwing IPolygonReader::Try...() calls.
+template <typename Shape>
+struct ParseResult {
+    ParseStatus status = ParseStatus::kBlank;
+    std::tuple<float, float, Shape> record;
+
+    // For kMalformed only: the offset in the string of the token that could not be parsed, or the length of the string
+    // when a value is missing at the end, and what was wrong.
+    size_t error_position = 0;
+    std::string error_message;
+
+    bool ok() const noexcept {
+        return status == ParseStatus::kOk;
+    }
+};
+
+enum class ReadStatus {
+    kOk,
+    kNotAFile,   // the path does not exist or is not a regular file
+    kReadError,  // the file could not be opened or read
+};
+
+// The outcome of reading a file of records. Malformed lines do not make a read fail; they are listed in statistics.
+template <typename Shape>
+struct ReadResult {
+    ReadStatus status = ReadStatus::kOk;
+    std::vector<std::tuple<float, float, Shape>> records;
+    ReadStatistics statistics;
+    std::string error_message;
+
+    bool ok() const noexcept {
+        return status == ReadStatus::kOk;
+    }
+};
+
+// The outcome of reading a triangle mesh from a file. As with ReadResult, malformed lines do not make a read fail.
+struct MeshReadResult {
+    ReadStatus status = ReadStatus::kOk;
+    TriangleMesh mesh;
+    ReadStatistics statistics;
+    std::string error_message;
+
+    bool ok() const noexcept {
+        return status == ReadStatus::kOk;
+    }
+};
+
+// Receives the values of a record as the reader parses them, for callers that use each polygon once and so have no need
+// to store it. See IPolygonReader::TryStreamPointAndPolygonFromString().
+class IRecordSink {
+public:
+    virtual ~IRecordSink() = default;
+
+    // Called with the point of a record, before any of its vertices.
+    virtual void StartRecord(float point_x, float point_y) = 0;
+
+    // Called with each vertex of the polygon, in order.
+    virtual void AppendPoint(float x, float y) = 0;
+
+    // Called after the last vertex of a record that parsed. A malformed record ends without it, possibly after some of
+    // its vertices were passed on.
+    virtual void EndRecord() = 0;
 };
 
 // TODO: Implement a slightly more resilient subclass of IPolygonReader and change IPolygonReader::Create() to return
@@ -53,8 +206,76 @@ public:
     // format that CreatePointAndPolygonFromString() accepts. This should throw a std::runtime_error if there were any issues
     // opening or parsing the file.
     virtual std::vector<std::tuple<float, float, Polygon>> ReadPointsAndPolygonsFromFile(std::string_view filepath) = 0;
+
+    // Like ReadPointsAndPolygonsFromFile(), and also fills in what the file held. Comments, blank lines and malformed
+    // lines are classified without throwing, so they cost about as much as a record.
+    //
+    // The default implementation calls the one-argument overload, which does not say what each line held, so it only
+    // fills in bytes_read, records and read_time.
+    virtual std::vector<std::tuple<float, float, Polygon>> ReadPointsAndPolygonsFromFile(
+            std::string_view filepath, ReadStatistics& statistics);
+
+    // Creates a point and a MultiPolygon from a string with format:
+    //
+    // "point_x point_y x0 y0 x1 y1 ... xN yN | x0 y0 x1 y1 ... xM yM | ..."
+    //
+    // That is the format CreatePointAndPolygonFromString() accepts, with a "|" token between consecutive rings. A line
+    // without any "|" is a multipolygon with one ring. This should throw a std::runtime_error if there were any errors
+    // parsing the string, including an empty ring.
+    //
+    // The default implementation splits the string at the "|" tokens and parses each ring with
+    // CreatePointAndPolygonFromString(), so it accepts the coordinates that call accepts.
+    virtual std::tuple<float, float, MultiPolygon> CreatePointAndMultiPolygonFromString(
+            std::string_view multi_polygon_string);
+
+    // Creates a vector of point/MultiPolygon pairs given a path to a file with one point and one multipolygon per
+    // line, in the format that CreatePointAndMultiPolygonFromString() accepts. Like ReadPointsAndPolygonsFromFile(),
+    // this throws a std::runtime_error if the file can't be opened, and skips lines that can't be parsed.
+    virtual std::vector<std::tuple<float, float, MultiPolygon>> ReadPointsAndMultiPolygonsFromFile(
+            std::string_view filepath);
+
+    // Like ReadPointsAndMultiPolygonsFromFile(), and also fills in what the file held. By default, each line that is
+    // not a comment or blank goes through CreatePointAndMultiPolygonFromString(), and is malformed if that throws.
+    virtual std::vector<std::tuple<float, float, MultiPolygon>> ReadPointsAndMultiPolygonsFromFile(
+            std::string_view filepath, ReadStatistics& statistics);
+
+    // Non-throwing versions of the calls above, for input where bad records are expected: a failure costs about as
+    // much as a success. In the reader that Create() returns, the throwing versions are wrappers around these.
+    //
+    // The default implementations go the other way, for readers that only implement the throwing calls, and cost an
+    // exception per failure: a string that the throwing call rejects is malformed, at error_position 0, and a file that
+    // exists but that the throwing call fails to read is a read error.
+    virtual ParseResult<Polygon> TryCreatePointAndPolygonFromString(std::string_view polygon_string);
+    virtual ReadResult<Polygon> TryReadPointsAndPolygonsFromFile(std::string_view filepath);
+    virtual ParseResult<MultiPolygon> TryCreatePointAndMultiPolygonFromString(std::string_view multi_polygon_string);
+    virtual ReadResult<MultiPolygon> TryReadPointsAndMultiPolygonsFromFile(std::string_view filepath);
+
+    // Streaming versions of TryCreatePointAndPolygonFromString() and TryReadPointsAndPolygonsFromFile(): the point and
+    // vertices of each record go to the sink as they are parsed, in one pass over the text, and no Polygon is built.
+    // The records of the results hold each point and its number of vertices.
+    //
+    // The default implementations parse with TryCreatePointAndPolygonFromString() or
+    // TryReadPointsAndPolygonsFromFile() first and then replay each record into the sink, so they build every Polygon
+    // and read the whole file before the sink hears of it, and a malformed record never reaches the sink.
+    virtual ParseResult<size_t> TryStreamPointAndPolygonFromString(std::string_view polygon_string, IRecordSink& sink);
+    virtual ReadResult<size_t> TryStreamPointsAndPolygonsFromFile(std::string_view filepath, IRecordSink& sink);
 };
 
+// Reads a triangle mesh from a file in the part of the Wavefront OBJ format that describes surfaces:
+//
+// "v x y z"          a vertex, optionally followed by a weight, which is ignored
+// "f v1 v2 v3 ..."   a face of three or more vertices, split into triangles around v1
+//
+// Vertex references count from 1, or back from the latest vertex when negative, and may carry texture and normal
+// references ("v1/vt1/vn1" or "v1//vn1"), which are ignored. The records of the statistics are the vertices and
+// faces. Statements that do not change the surface ("vt", "vn", "vp", "o", "g", "s", "l", "p", "mtllib" and
+// "usemtl") are counted as comments; any other statement, and a face that refers to a vertex not yet defined, is
+// malformed.
+MeshReadResult TryReadTriangleMeshFromFile(std::string_view filepath);
+
+// Like TryReadTriangleMeshFromFile(), but throws a std::runtime_error if the file can't be read.
+TriangleMesh ReadTriangleMeshFromFile(std::string_view filepath);
+
 }  // namespace poly
 
 #endif
@@ -0,0 +1,105 @@
+#ifndef POLYGON_ARRANGEMENT_HPP_
+#define POLYGON_ARRANGEMENT_HPP_
+
+#include <cstdint>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include <edge_bvh.hpp>
+#include <point_batch.hpp>
+#include <poly_io.hpp>
+
+namespace winding_number {
+
+// PolygonArrangement splits the plane along a closed polygon's edges, and labels every piece with its winding number,
+// so that a query is a point location and no longer depends on how many times the polygon winds. It is meant for a
+// fixed polygon whose edges cross many times -- stars, spirals and flight paths that loop over themselves -- queried
+// by many points.
+//
+// The winding number is constant between the edges, so horizontal lines through every vertex and every crossing of two
+// edges cut the plane into slabs in which the edges run side by side without crossing. Each slab keeps its edges left
+// to right, with the winding number of the trapezoid left of each one: a query binary searches the slabs by y, then
+// the slab's edges with exact side tests.
+//
+// Preparing is not cheap. Finding the crossings tests every pair of edges whose y ranges overlap, O(m^2) for m edges,
+// and the slabs take O(s w) memory for s slabs of at most w edges each -- O(m^3) for a polygon that crosses itself
+// everywhere. Both are bounded: past kMaxPairTests pair tests or kMaxSlabEdges slab entries, the slabs are dropped and
+// every query goes to the EdgeBvh, so such a polygon costs what EdgeBvh does. Up to a few thousand edges, or more if
+// few of them share a y range, stays within the bounds.
+//
+// Results are exact off the boundary, and so match IWindingNumberAlgorithm::Create() for points it places correctly.
+// On the boundary they follow Precision::kExactBoundary like ExactWindingNumber2D(), not the default "improved"
+// algorithm, which is only Precision::kFast there. Crossings are only placed in double precision, so points within
+// rounding of a crossing's y, like points on the boundary, are answered by an EdgeBvh -- on the boundary, that is the
+// number of times the boundary passes through them (see edge_crossing.hpp).
+class PolygonArrangement {
+public:
+    // Bounds on preparing, as above: pairs of edges tested for a crossing, and edges stored over all slabs.
+    static constexpr size_t kMaxPairTests = size_t(1) << 24;
+    static constexpr size_t kMaxSlabEdges = size_t(1) << 22;
+
+    // Finds the crossings and labels the slabs. A polygon that is not closed up to tolerance is kept, but every query
+    // on it returns std::nullopt -- like CalculateWindingNumber2D() does.
+    explicit PolygonArrangement(const poly::Polygon& polygon, float tolerance = 0.f);
+
+    // Returns the winding number of (x, y) with respect to the polygon, or std::nullopt if the polygon is not closed.
+    std::optional<int> CalculateWindingNumber2D(float x, float y) const;
+
+    // Returns the winding numbers of every point in the batch, in the order of the batch.
+    std::vector<std::optional<int>> CalculateWindingNumbers2D(const poly::PointBatch& points) const;
+
+    // Whether the slabs were built, rather than dropped for going over kMaxPairTests or kMaxSlabEdges.
+    bool has_slabs() const noexcept;
+
+    // Number of pairs of edges that cross, of slabs, and of labelled trapezoids, mostly useful for tests and tuning.
+    // All three are 0 once the slabs are dropped.
+    size_t crossing_count() const noexcept;
+    size_t slab_count() const noexcept;
+    size_t trapezoid_count() const noexcept;
+
+private:
+    // An edge that is not horizontal, from its lower to its upper end.
+    struct Edge {
+        float x0, y0, x1, y1;
+        int direction;  // +1 if the polygon goes up along it
+    };
+
+    // The y where two edges cross at a point inside both, and how far rounding may have moved it, or std::nullopt if
+    // they don't cross that way.
+    static std::optional<std::pair<double, double>> Crossing(const Edge& a, const Edge& b);
+
+    // Whether a is left of b just above y, where both span it. Collinear edges go by index.
+    static bool LeftOf(const Edge& a, uint32_t a_index, const Edge& b, uint32_t b_index, double y);
+
+    // Frees the slabs of a polygon that went over budget; queries go to the EdgeBvh from then on.
+    void DropSlabs();
+
+    bool OnVertexOrHorizontalEdge(float x, float y) const;
+    bool NearCrossing(float y) const;
+
+    bool closed_;
+    bool over_budget_ = false;
+    EdgeBvh fallback_;
+    std::vector<Edge> edges_;
+    size_t crossing_count_ = 0;
+
+    // Slab i spans [slab_y_[i], slab_y_[i + 1]) and holds the edges slab_edges_[slab_offsets_[i]] onwards, up to
+    // slab_offsets_[i + 1], left to right. slab_labels_ holds the winding number left of each of those edges; right of
+    // the last one it is 0.
+    std::vector<double> slab_y_;
+    std::vector<uint32_t> slab_offsets_ = {0};
+    std::vector<uint32_t> slab_edges_;
+    std::vector<int32_t> slab_labels_;
+
+    // Ranges of y, merged and sorted, within rounding of a crossing.
+    std::vector<std::pair<double, double>> near_crossings_;
+
+    // Sorted vertices, and horizontal edges by y then lowest x, for the boundary test that the slabs can't do.
+    std::vector<std::pair<float, float>> vertices_;
+    std::vector<std::pair<float, std::pair<float, float>>> horizontal_edges_;
+};
+
+}  // namespace winding_number
+
+#endif
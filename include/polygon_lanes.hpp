@@ -0,0 +1,78 @@
+#ifndef POLYGON_LANES_HPP_
+#define POLYGON_LANES_HPP_
+
+#include <optional>
+#include <tuple>
+#include <vector>
+
+#include <aligned_allocator.hpp>
+#include <point_batch.hpp>
+#include <poly_io.hpp>
+
+namespace poly {
+
+// PolygonLanes is a read-only copy of many polygons, laid out so that one vector instruction works on the same edge of
+// kLaneCount different polygons. That suits many small polygons -- parcels, tiles -- which have too few edges each to
+// fill a vector on their own.
+//
+// The polygons are grouped by edge count, and each group is cut into blocks of kLaneCount polygons. A block stores
+// vertex v of all its polygons next to each other ("lane-major"), so walking the edges of the block walks all its
+// polygons at once. The last block of a group is padded with copies of its first polygon, whose results are dropped.
+class PolygonLanes {
+public:
+    // Polygons per block. Two SSE2 vectors, or one AVX vector.
+    static constexpr size_t kLaneCount = 8;
+
+    // Polygons that are not closed up to tolerance are recorded as such, and every query on them gives std::nullopt.
+    explicit PolygonLanes(const std::vector<Polygon>& polygons, float tolerance = 0.f);
+
+    // Takes the polygons of records produced by IPolygonReader, in the order of the records.
+    [[nodiscard]] static PolygonLanes FromRecords(const std::vector<std::tuple<float, float, Polygon>>& records,
+                                                  float tolerance = 0.f);
+
+    // Number of polygons, closed or not.
+    size_t size() const noexcept;
+
+    // Polygons with the same number of edges.
+    struct Group {
+        size_t edge_count;
+        // The polygon in each lane of each block, as an index into the polygons given to the constructor.
+        std::vector<size_t> polygons;
+        // Block b holds edge_count + 1 vertices of kLaneCount floats each, starting at b * block_stride().
+        AlignedVector<float> x_vec_;
+        AlignedVector<float> y_vec_;
+
+        size_t block_count() const noexcept;
+        size_t block_stride() const noexcept;
+    };
+
+    const std::vector<Group>& groups() const noexcept;
+
+    // Indices of the polygons that are not closed.
+    const std::vector<size_t>& unclosed() const noexcept;
+
+private:
+    size_t size_;
+    std::vector<Group> groups_;
+    std::vector<size_t> unclosed_;
+};
+
+}  // namespace poly
+
+namespace winding_number {
+
+// Returns the winding number of (x, y) with respect to every polygon, in the order the polygons were given, or
+// std::nullopt for those that are not closed.
+//
+// The kernel evaluates the crossing and boundary rules of edge_crossing.hpp in single precision, like SimdPolygon's.
+// Results therefore match IWindingNumberAlgorithm::Create() except for points within float rounding of an edge.
+std::vector<std::optional<int>> CalculateWindingNumbers2D(float x, float y, const poly::PolygonLanes& polygons);
+
+// Returns the winding number of every point in the batch with respect to every polygon: the result for point i and
+// polygon j is at i * polygons.size() + j. The blocks are walked once, each run against all the points in turn.
+std::vector<std::optional<int>> CalculateWindingNumbers2D(const poly::PointBatch& points,
+                                                          const poly::PolygonLanes& polygons);
+
+}  // namespace winding_number
+
+#endif
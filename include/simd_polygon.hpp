@@ -0,0 +1,61 @@
+#ifndef SIMD_POLYGON_HPP_
+#define SIMD_POLYGON_HPP_
+
+#include <optional>
+#include <vector>
+
+#include <aligned_allocator.hpp>
+#include <point_batch.hpp>
+#include <poly_io.hpp>
+
+namespace poly {
+
+// SimdPolygon is a read-only copy of a closed Polygon laid out for vectorized kernels.
+//
+// The vertices are stored once each, without Polygon's duplicated closing point, in kSimdAlignment-aligned arrays.
+// The arrays are then padded with copies of the first vertex up to padded_edge_count() + 1 entries. Edge i always
+// runs from vertex i to vertex i + 1: the closing edge is the one into the first padding entry, and every later edge
+// has zero length and contributes nothing. So a kernel can walk all padded_edge_count() edges in full-width steps
+// with no scalar prologue or epilogue.
+struct SimdPolygon {
+    // Floats per padded block: one cache line, and the widest vector the kernels may use.
+    static constexpr size_t kLaneCount = kSimdAlignment / sizeof(float);
+
+    // Copies the polygon. A polygon that is not closed up to tolerance is recorded as such (see closed()).
+    explicit SimdPolygon(const Polygon& polygon, float tolerance = 0.f);
+
+    // Number of real edges, i.e. distinct vertices including the implicit closing edge.
+    size_t edge_count() const noexcept;
+
+    // edge_count() rounded up to a multiple of kLaneCount.
+    size_t padded_edge_count() const noexcept;
+
+    bool closed() const noexcept;
+
+    // data members
+    AlignedVector<float> x_vec_;
+    AlignedVector<float> y_vec_;
+
+private:
+    size_t edge_count_ = 0;
+    bool closed_ = false;
+};
+
+}  // namespace poly
+
+namespace winding_number {
+
+// Returns the winding number of (x, y) with respect to the polygon, or std::nullopt if it is not closed.
+//
+// The kernel evaluates the same crossing and boundary rules as edge_crossing.hpp, four edges at a time, but in single
+// precision. Results therefore match IWindingNumberAlgorithm::Create() except for points within float rounding of an
+// edge.
+std::optional<int> CalculateWindingNumber2D(float x, float y, const poly::SimdPolygon& polygon);
+
+// Returns the winding numbers of every point in the batch, in the order of the batch.
+std::vector<std::optional<int>> CalculateWindingNumbers2D(const poly::PointBatch& points,
+                                                          const poly::SimdPolygon& polygon);
+
+}  // namespace winding_number
+
+#endif
@@ -0,0 +1,53 @@
+#ifndef SIMPLE_POLYGON_HPP_
+#define SIMPLE_POLYGON_HPP_
+
+#include <optional>
+#include <vector>
+
+#include <point_batch.hpp>
+#include <poly_io.hpp>
+
+namespace winding_number {
+
+// SimplePolygon checks once, with a Shamos-Hoey sweep, whether a closed polygon is simple -- whether its edges only
+// meet where consecutive edges share a vertex. If it is, the winding number is the polygon's orientation (+1
+// counter-clockwise, -1 clockwise) inside and 0 outside, so each query only needs the parity of the ray crossings,
+// not their directions, and can stop at the first edge the point lies on.
+//
+// Results are the same as the edge_crossing.hpp engines, 1 on the boundary included. Polygons that are not simple,
+// such as the self-intersecting stars of polygons.txt, are answered by summing the crossings of every edge instead.
+// So are polygons whose last point is only within tolerance of the first, since the gap between them leaves the
+// boundary open.
+class SimplePolygon {
+public:
+    // Checks simplicity and caches the orientation. A polygon that is not closed up to tolerance is kept, but every
+    // query on it returns std::nullopt -- like CalculateWindingNumber2D() does.
+    explicit SimplePolygon(const poly::Polygon& polygon, float tolerance = 0.f);
+
+    // Returns the winding number of (x, y) with respect to the polygon, or std::nullopt if the polygon is not closed.
+    std::optional<int> CalculateWindingNumber2D(float x, float y) const;
+
+    // Returns the winding numbers of every point in the batch, in the order of the batch.
+    std::vector<std::optional<int>> CalculateWindingNumbers2D(const poly::PointBatch& points) const;
+
+    // Whether queries take the parity path.
+    bool simple() const noexcept;
+
+    // +1 for counter-clockwise and -1 for clockwise simple polygons, 0 for polygons that are not simple.
+    int orientation() const noexcept;
+
+private:
+    int ParityWindingNumber(float x, float y) const;
+    int GeneralWindingNumber(float x, float y) const;
+
+    bool closed_;
+    int orientation_ = 0;
+
+    // The polygon as given, except that simple polygons drop repeated vertices.
+    std::vector<float> x_vec_;
+    std::vector<float> y_vec_;
+};
+
+}  // namespace winding_number
+
+#endif
@@ -0,0 +1,83 @@
+#ifndef SMALL_POLYGON_HPP_
+#define SMALL_POLYGON_HPP_
+
+#include <array>
+#include <optional>
+#include <vector>
+
+#include <point_batch.hpp>
+#include <poly_io.hpp>
+
+namespace winding_number {
+
+// SmallPolygon answers queries on polygons of a handful of edges -- triangles, quads, tiles -- without the loop
+// overhead of the general engines. The number of edges is looked at once, when the polygon is prepared:
+//
+//   - an axis-aligned rectangle, traced either way round and closed exactly, takes a test against its bounds that
+//     settles most points with four compares;
+//   - 3 to kMaxEdges edges take a kernel unrolled at compile time for exactly that many edges;
+//   - anything else takes the loop over edge_crossing.hpp.
+//
+// All three give the same results as the edge_crossing.hpp engines, boundary points included.
+class SmallPolygon {
+public:
+    // The largest number of edges with an unrolled kernel.
+    static constexpr size_t kMaxEdges = 8;
+
+    enum class Shape {
+        kRectangle,
+        kUnrolled,
+        kGeneral,
+    };
+
+    // Picks the kernel. A polygon that is not closed up to tolerance is kept, but every query on it returns
+    // std::nullopt -- like CalculateWindingNumber2D() does.
+    explicit SmallPolygon(const poly::Polygon& polygon, float tolerance = 0.f);
+
+    // Returns the winding number of (x, y) with respect to the polygon, or std::nullopt if the polygon is not closed.
+    std::optional<int> CalculateWindingNumber2D(float x, float y) const;
+
+    // Returns the winding numbers of every point in the batch, in the order of the batch.
+    std::vector<std::optional<int>> CalculateWindingNumbers2D(const poly::PointBatch& points) const;
+
+    Shape shape() const noexcept;
+
+    // One less than the number of points, since the last point closes the polygon.
+    size_t edge_count() const noexcept;
+
+private:
+    using Kernel = int (*)(const SmallPolygon& polygon, float x, float y);
+    using BatchKernel = void (*)(const SmallPolygon& polygon, const poly::PointBatch& points,
+                                 std::vector<std::optional<int>>& winding_numbers);
+
+    template <size_t N>
+    static int UnrolledWindingNumber(const SmallPolygon& polygon, float x, float y);
+    static int RectangleWindingNumber(const SmallPolygon& polygon, float x, float y);
+    static int GeneralWindingNumber(const SmallPolygon& polygon, float x, float y);
+
+    template <Kernel kernel>
+    static void BatchWindingNumbers(const SmallPolygon& polygon, const poly::PointBatch& points,
+                                    std::vector<std::optional<int>>& winding_numbers);
+
+    bool closed_;
+    size_t edge_count_;
+    Shape shape_ = Shape::kGeneral;
+    Kernel kernel_ = &GeneralWindingNumber;
+    BatchKernel batch_kernel_ = &BatchWindingNumbers<&GeneralWindingNumber>;
+
+    // kRectangle: the bounds, and +1 for counter-clockwise or -1 for clockwise.
+    float min_x_ = 0.f, max_x_ = 0.f, min_y_ = 0.f, max_y_ = 0.f;
+    int orientation_ = 0;
+
+    // kUnrolled: the points, the closing one included, inline so the kernel needs no indirection.
+    std::array<float, kMaxEdges + 1> xs_{};
+    std::array<float, kMaxEdges + 1> ys_{};
+
+    // kGeneral: the polygon as given.
+    std::vector<float> x_vec_;
+    std::vector<float> y_vec_;
+};
+
+}  // namespace winding_number
+
+#endif
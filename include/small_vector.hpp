@@ -0,0 +1,284 @@
+#ifndef SMALL_VECTOR_HPP_
+#define SMALL_VECTOR_HPP_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <initializer_list>
+#include <iterator>
+#include <type_traits>
+
+namespace poly {
+
+// SmallVector keeps up to N elements inside the object itself, and moves them to the heap only once it outgrows that.
+// It has the parts of std::vector's interface that the polygon code uses, with plain pointers as iterators.
+//
+// Elements must be trivially copyable, so growing and copying are memcpy, and only the heap buffer needs freeing.
+template <typename T, std::size_t N>
+class SmallVector {
+    static_assert(std::is_trivially_copyable_v<T>, "SmallVector only holds trivially copyable elements");
+    static_assert(N > 0, "SmallVector needs room for at least one element inline");
+
+public:
+    using value_type = T;
+    using size_type = std::size_t;
+    using reference = T&;
+    using const_reference = const T&;
+    using iterator = T*;
+    using const_iterator = const T*;
+
+    static constexpr size_type kInlineCapacity = N;
+
+    SmallVector() noexcept = default;
+
+    SmallVector(size_type count, const T& value) {
+        assign(count, value);
+    }
+
+    template <typename InputIt, typename = typename std::iterator_traits<InputIt>::iterator_category>
+    SmallVector(InputIt first, InputIt last) {
+        assign(first, last);
+    }
+
+    SmallVector(std::initializer_list<T> values) {
+        assign(values.begin(), values.end());
+    }
+
+    SmallVector(const SmallVector& other) {
+        assign(other.begin(), other.end());
+    }
+
+    SmallVector(SmallVector&& other) noexcept {
+        TakeFrom(other);
+    }
+
+    SmallVector& operator=(const SmallVector& other) {
+        if (this != &other) {
+            assign(other.begin(), other.end());
+        }
+        return *this;
+    }
+
+    SmallVector& operator=(SmallVector&& other) noexcept {
+        if (this != &other) {
+            Release();
+            TakeFrom(other);
+        }
+        return *this;
+    }
+
+    SmallVector& operator=(std::initializer_list<T> values) {
+        assign(values.begin(), values.end());
+        return *this;
+    }
+
+    ~SmallVector() {
+        Release();
+    }
+
+    void assign(size_type count, const T& value) {
+        clear();
+        resize(count, value);
+    }
+
+    template <typename InputIt, typename = typename std::iterator_traits<InputIt>::iterator_category>
+    void assign(InputIt first, InputIt last) {
+        clear();
+        insert(end(), first, last);
+    }
+
+    T* data() noexcept {
+        return data_;
+    }
+    const T* data() const noexcept {
+        return data_;
+    }
+
+    size_type size() const noexcept {
+        return size_;
+    }
+    bool empty() const noexcept {
+        return size_ == 0;
+    }
+    size_type capacity() const noexcept {
+        return capacity_;
+    }
+
+    // Whether the elements are still stored inside the object.
+    bool is_inline() const noexcept {
+        return data_ == inline_;
+    }
+
+    iterator begin() noexcept {
+        return data_;
+    }
+    const_iterator begin() const noexcept {
+        return data_;
+    }
+    iterator end() noexcept {
+        return data_ + size_;
+    }
+    const_iterator end() const noexcept {
+        return data_ + size_;
+    }
+
+    T& operator[](size_type i) noexcept {
+        return data_[i];
+    }
+    const T& operator[](size_type i) const noexcept {
+        return data_[i];
+    }
+    T& front() noexcept {
+        return data_[0];
+    }
+    const T& front() const noexcept {
+        return data_[0];
+    }
+    T& back() noexcept {
+        return data_[size_ - 1];
+    }
+    const T& back() const noexcept {
+        return data_[size_ - 1];
+    }
+
+    void reserve(size_type capacity) {
+        if (capacity <= capacity_) {
+            return;
+        }
+        T* grown = new T[capacity];
+        std::memcpy(grown, data_, size_ * sizeof(T));
+        Release();
+        data_ = grown;
+        capacity_ = capacity;
+    }
+
+    // Frees a heap buffer the elements would fit inline, like std::vector::shrink_to_fit().
+    void shrink_to_fit() {
+        if (is_inline() || size_ > N) {
+            return;
+        }
+        T* heap = data_;
+        std::memcpy(inline_, heap, size_ * sizeof(T));
+        data_ = inline_;
+        capacity_ = N;
+        delete[] heap;
+    }
+
+    void clear() noexcept {
+        size_ = 0;
+    }
+
+    void resize(size_type count) {
+        resize(count, T());
+    }
+
+    void resize(size_type count, const T& value) {
+        if (count > size_) {
+            Grow(count);
+            std::fill(data_ + size_, data_ + count, value);
+        }
+        size_ = count;
+    }
+
+    void push_back(const T& value) {
+        if (size_ == capacity_) {
+            // The value may be one of the elements about to be moved.
+            const T copy = value;
+            Grow(size_ + 1);
+            data_[size_++] = copy;
+            return;
+        }
+        data_[size_++] = value;
+    }
+
+    void pop_back() noexcept {
+        --size_;
+    }
+
+    iterator insert(const_iterator position, const T& value) {
+        const size_type offset = position - data_;
+        const T copy = value;
+        Grow(size_ + 1);
+        std::memmove(data_ + offset + 1, data_ + offset, (size_ - offset) * sizeof(T));
+        data_[offset] = copy;
+        ++size_;
+        return data_ + offset;
+    }
+
+    template <typename InputIt, typename = typename std::iterator_traits<InputIt>::iterator_category>
+    iterator insert(const_iterator position, InputIt first, InputIt last) {
+        const size_type offset = position - data_;
+        if constexpr (std::is_base_of_v<std::forward_iterator_tag,
+                                        typename std::iterator_traits<InputIt>::iterator_category>) {
+            const auto count = static_cast<size_type>(std::distance(first, last));
+            // Like std::vector, the range must not be part of this vector.
+            Grow(size_ + count);
+            std::memmove(data_ + offset + count, data_ + offset, (size_ - offset) * sizeof(T));
+            std::copy(first, last, data_ + offset);
+            size_ += count;
+        } else {
+            for (size_type i = offset; first != last; ++first, ++i) {
+                insert(data_ + i, *first);
+            }
+        }
+        return data_ + offset;
+    }
+
+    iterator erase(const_iterator first, const_iterator last) noexcept {
+        const size_type offset = first - data_;
+        const size_type count = last - first;
+        std::memmove(data_ + offset, data_ + offset + count, (size_ - offset - count) * sizeof(T));
+        size_ -= count;
+        return data_ + offset;
+    }
+
+    iterator erase(const_iterator position) noexcept {
+        return erase(position, position + 1);
+    }
+
+    friend bool operator==(const SmallVector& a, const SmallVector& b) {
+        return a.size_ == b.size_ && std::equal(a.begin(), a.end(), b.begin());
+    }
+    friend bool operator!=(const SmallVector& a, const SmallVector& b) {
+        return !(a == b);
+    }
+
+private:
+    // Makes room for at least `count` elements, at least doubling the capacity when it has to grow.
+    void Grow(size_type count) {
+        if (count > capacity_) {
+            reserve(std::max(count, 2 * capacity_));
+        }
+    }
+
+    // Steals a heap buffer, or copies inline elements, and leaves the other vector empty.
+    void TakeFrom(SmallVector& other) noexcept {
+        if (other.is_inline()) {
+            std::memcpy(inline_, other.inline_, other.size_ * sizeof(T));
+        } else {
+            data_ = other.data_;
+            capacity_ = other.capacity_;
+            other.data_ = other.inline_;
+            other.capacity_ = N;
+        }
+        size_ = other.size_;
+        other.size_ = 0;
+    }
+
+    void Release() noexcept {
+        if (!is_inline()) {
+            delete[] data_;
+            data_ = inline_;
+            capacity_ = N;
+        }
+    }
+
+    T inline_[N];
+    T* data_ = inline_;
+    size_type size_ = 0;
+    size_type capacity_ = N;
+};
+
+}  // namespace poly
+
+#endif
@@ -0,0 +1,104 @@
+#ifndef SPHERICAL_POLYGON_HPP_
+#define SPHERICAL_POLYGON_HPP_
+
+#include <optional>
+#include <vector>
+
+#include <aligned_allocator.hpp>
+#include <point_batch.hpp>
+#include <poly_io.hpp>
+
+namespace poly {
+
+// SphericalPolygon is a polygon on the unit sphere, such as a geofence, specified as an ordered series of points joined
+// by great circle arcs -- the shorter arc between consecutive points, so consecutive points must not be antipodal.
+// Points are stored as unit vectors, with longitude 0 at +x, longitude 90 at +y and the north pole at +z; nothing
+// special happens at the antimeridian or the poles.
+//
+// As with Polygon, the polygon is closed when its last point is its first, and it winds positively when its points
+// run counter-clockwise seen from outside the sphere -- that is, on a map with east to the right and north up.
+struct SphericalPolygon {
+    SphericalPolygon(size_t capacity = 0);
+
+    // Creates a polygon from a planar one holding longitudes as x and latitudes as y, in degrees, as read by
+    // IPolygonReader.
+    [[nodiscard]] static SphericalPolygon FromLonLat(const Polygon& lon_lat);
+
+    // Appends the point at the given longitude and latitude, in degrees. Longitudes that differ by a multiple of 360,
+    // and any longitude at the poles, give exactly the same point.
+    void AppendLonLat(double lon, double lat);
+
+    // Appends the point in the direction of (x, y, z), which must not be 0.
+    void AppendPoint(double x, double y, double z);
+
+    size_t size() const;
+
+    // Ensures the last point in the polygon is the same as the first.
+    void ClosePolygon();
+
+    // Detects whether the last point in the polygon is the same as the first, up to some tolerance on the straight line
+    // distance between them (so about the angle between them, in radians).
+    bool IsClosed(double tolerance = 0.) const;
+
+    // data members
+    std::vector<double> x_vec_;
+    std::vector<double> y_vec_;
+    std::vector<double> z_vec_;
+};
+
+}  // namespace poly
+
+namespace winding_number {
+
+// PreparedSphericalPolygon answers winding number queries on a SphericalPolygon without projecting it to a plane.
+//
+// The winding number of a point p is taken around the axis through p: looking down on p from outside the sphere, each
+// edge turns about p in the same direction as the straight segment between its end points, so the count of signed
+// crossings of a half plane bounded by that axis is the planar winding number of the polygon seen from above p. An
+// edge a -> b crosses that half plane when a and b are on opposite sides of it and p is to the left of the edge, that
+// is when p . (a x b) > 0 -- so with the edge normals a x b computed once, a query costs two dot products per edge.
+//
+// That count is the number of times the polygon winds around p less the number of times it winds around p's antipode.
+// The polygon's points are checked to lie within a spherical cap smaller than a hemisphere, which then holds the
+// whole polygon. Points outside the cap are rejected without visiting any edge; for points inside it, the antipode is
+// outside the polygon, so the count is the winding number. For polygons that fit in no hemisphere, queries return the
+// count as it is.
+//
+// The count follows the half-open crossing rule of the planar engines, so points near an edge are counted on one side
+// or the other consistently, but there is no exact boundary test: points on an edge, or whose antipode is on one, may
+// be found on either side.
+class PreparedSphericalPolygon {
+public:
+    // A polygon that is not closed up to tolerance is kept, but every query on it returns std::nullopt.
+    explicit PreparedSphericalPolygon(const poly::SphericalPolygon& polygon, double tolerance = 0.);
+
+    // Returns the winding number of the point at the given longitude and latitude, in degrees, or std::nullopt if the
+    // polygon is not closed.
+    std::optional<int> CalculateWindingNumberLonLat(double lon, double lat) const;
+
+    // The same for the point in the direction of (x, y, z), which must not be 0.
+    std::optional<int> CalculateWindingNumberOnSphere(double x, double y, double z) const;
+
+    // Returns the winding numbers of every point in a batch holding longitudes as x and latitudes as y, in degrees, in
+    // the order of the batch.
+    std::vector<std::optional<int>> CalculateWindingNumbersLonLat(const poly::PointBatch& lon_lat) const;
+
+    // Whether the polygon was found to lie within a hemisphere, where its winding numbers are exact.
+    bool fits_in_hemisphere() const noexcept;
+
+private:
+    int CountCrossings(const double p[3]) const;
+
+    bool closed_;
+    bool fits_in_hemisphere_ = false;
+    // The cap holding every point: its center, and the cosine of its angular radius.
+    double cap_center_[3] = {0, 0, 0};
+    double cap_cos_radius_ = 0;
+    // The points, the closing one included, and the normal of each edge, not normalized.
+    poly::AlignedVector<double> x_vec_, y_vec_, z_vec_;
+    poly::AlignedVector<double> normal_x_vec_, normal_y_vec_, normal_z_vec_;
+};
+
+}  // namespace winding_number
+
+#endif
@@ -0,0 +1,32 @@
+#ifndef SWEEP_LINE_HPP_
+#define SWEEP_LINE_HPP_
+
+#include <optional>
+#include <vector>
+
+#include <point_batch.hpp>
+#include <poly_io.hpp>
+
+namespace winding_number {
+
+// Returns the winding numbers of every point in the batch with respect to one polygon, in the order of the batch, by
+// sweeping a horizontal line upwards once over both. It is meant for offline jobs with many points and a large polygon,
+// where even a logarithmic query per point after preparing the polygon is outdone by sorting: the cost is
+// O((n + m) log(n + m)) for n points and m edges, and the memory O(n + m).
+//
+// The sweep keeps the edges that cross the line in left to right order, with their directions in a Fenwick tree
+// indexed by that order, so the winding number of a point on the line is the sum of the directions to its right. The
+// points are cut into horizontal bands of about equal size, swept in parallel on up to thread_count threads (0 means
+// DefaultThreadCount()).
+//
+// Edges are ordered with exact predicates, so results off the boundary match ExactWindingNumber2D(). The order only
+// exists when no two edges cross, which is checked first: for a polygon whose edges cross or that has more edges than
+// fit in 32 bits, and for points on the boundary, the results come from an EdgeBvh instead. Every result is
+// std::nullopt if the polygon is not closed up to tolerance.
+std::vector<std::optional<int>> CalculateWindingNumbersBySweep(const poly::PointBatch& points,
+                                                               const poly::Polygon& polygon, float tolerance = 0.f,
+                                                               size_t thread_count = 0);
+
+}  // namespace winding_number
+
+#endif
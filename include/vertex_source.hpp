@@ -0,0 +1,111 @@
+#ifndef VERTEX_SOURCE_HPP_
+#define VERTEX_SOURCE_HPP_
+
+#include <cstddef>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include <point_batch.hpp>
+#include <winding_accumulator.hpp>
+
+namespace winding_number {
+
+// A vertex source describes a closed curve by handing its vertices, in order, to a callback:
+//
+//     source([&](float x, float y) { ... });
+//
+// so that the curve never has to be stored. Any callable of that shape will do -- a lambda that walks some other
+// container or generates the points on the fly, or one of the adapters below. As with Polygon, the curve is closed
+// when its last vertex is the first one again.
+//
+// Sources are templates rather than std::function, so the per-vertex callback inlines into the source's loop.
+
+// A source over an iterator range whose elements destructure into two floats, such as std::pair<float, float> or
+// std::array<float, 2>.
+template <typename Iterator>
+class VertexRange {
+public:
+    VertexRange(Iterator first, Iterator last) : first_(first), last_(last) {}
+
+    template <typename Visit>
+    void operator()(Visit&& visit) const {
+        for (Iterator it = first_; it != last_; ++it) {
+            const auto& [x, y] = *it;
+            visit(float(x), float(y));
+        }
+    }
+
+private:
+    Iterator first_;
+    Iterator last_;
+};
+
+// A source that samples a parametric curve f(t) at `samples` evenly spaced parameters from t0 up to, but not
+// including, t1, then repeats the first sample to close the curve. f returns anything that destructures into two
+// numbers. For a closed curve with f(t0) == f(t1), the result is the inscribed polygon with `samples` edges.
+template <typename Curve>
+class SampledCurve {
+public:
+    SampledCurve(Curve curve, double t0, double t1, size_t samples) :
+            curve_(std::move(curve)), t0_(t0), t1_(t1), samples_(samples) {}
+
+    template <typename Visit>
+    void operator()(Visit&& visit) const {
+        if (samples_ == 0) {
+            return;
+        }
+        const auto [first_x, first_y] = curve_(t0_);
+        visit(float(first_x), float(first_y));
+        for (size_t i = 1; i < samples_; ++i) {
+            const auto [x, y] = curve_(t0_ + (t1_ - t0_) * double(i) / double(samples_));
+            visit(float(x), float(y));
+        }
+        visit(float(first_x), float(first_y));
+    }
+
+private:
+    Curve curve_;
+    double t0_;
+    double t1_;
+    size_t samples_;
+};
+
+// Returns the winding number of (x, y) with respect to the curve of a vertex source, or std::nullopt if it is not
+// closed up to tolerance. The source is walked once, through a WindingAccumulator: memory does not depend on the
+// number of vertices, and the result is the one the "scalar" algorithm gives for a Polygon of the same vertices.
+template <typename Source>
+std::optional<int> CalculateWindingNumberFromSource(float x, float y, const Source& source, float tolerance = 0.f) {
+    WindingAccumulator accumulator(tolerance);
+    accumulator.StartRecord(x, y);
+    source([&accumulator](float vertex_x, float vertex_y) { accumulator.AppendPoint(vertex_x, vertex_y); });
+    accumulator.EndRecord();
+    return accumulator.winding_number();
+}
+
+// Returns the winding numbers of every point in a batch with respect to the same curve, walking the source only once,
+// which matters for sources that are expensive to generate.
+template <typename Source>
+std::vector<std::optional<int>> CalculateWindingNumbersFromSource(const poly::PointBatch& points, const Source& source,
+                                                                  float tolerance = 0.f) {
+    std::vector<WindingAccumulator> accumulators(points.size(), WindingAccumulator(tolerance));
+    for (size_t i = 0; i < points.size(); ++i) {
+        accumulators[i].StartRecord(points.x_vec_[i], points.y_vec_[i]);
+    }
+    source([&accumulators](float vertex_x, float vertex_y) {
+        for (auto& accumulator : accumulators) {
+            accumulator.AppendPoint(vertex_x, vertex_y);
+        }
+    });
+    std::vector<std::optional<int>> winding_numbers;
+    winding_numbers.reserve(points.size());
+    for (auto& accumulator : accumulators) {
+        accumulator.EndRecord();
+        winding_numbers.push_back(accumulator.winding_number());
+    }
+    return winding_numbers;
+}
+
+}  // namespace winding_number
+
+#endif
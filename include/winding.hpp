@@ -10,12 +10,55 @@
 #include <memory>
 #include <optional>  // A C++17 capable compiler is assumed here.
 #include <string>
+#include <string_view>
 #include <vector>
 
+#include <point_batch.hpp>
 #include <poly_io.hpp>
 
 namespace winding_number {
 
+// How exactly an algorithm must treat points on the boundary.
+enum class Precision {
+    // Points off the boundary get the right winding number, but points on or within float rounding of the boundary
+    // may not be counted as on it.
+    kFast,
+    // Points exactly on the boundary report the number of times the boundary passes through them (see
+    // edge_crossing.hpp), and the side of an edge is computed in double.
+    kExactBoundary,
+};
+
+// What the caller expects to do with an algorithm, so that IWindingNumberAlgorithm::Create() can pick one.
+struct AlgorithmHints {
+    // Expected number of vertices per polygon, 0 when unknown.
+    size_t polygon_size = 0;
+    // Expected number of points queried against each polygon, either in one batch or in consecutive calls.
+    size_t batch_size = 1;
+    Precision precision = Precision::kFast;
+};
+
+// A registered algorithm, as listed by IWindingNumberAlgorithm::Algorithms().
+struct AlgorithmInfo {
+    std::string name;
+    std::string description;
+    Precision precision;
+};
+
+// A polygon prepared once by an algorithm, as returned by IWindingNumberAlgorithm::Prepare(). Queries go straight to
+// the prepared form, so they cost what the algorithm advertises for a query, with no check that the polygon is the
+// same as last time. Queries are const and may run on several threads at once.
+class IPreparedPolygon {
+public:
+    virtual ~IPreparedPolygon() = default;
+
+    // Returns the winding number of (x, y) with respect to the prepared polygon, or std::nullopt if it was not closed.
+    virtual std::optional<int> CalculateWindingNumber2D(float x, float y) const = 0;
+
+    // Returns the winding numbers of every point in the batch, in the order of the batch. The default implementation
+    // calls CalculateWindingNumber2D() once per point.
+    virtual std::vector<std::optional<int>> CalculateWindingNumbers2D(const poly::PointBatch& points) const;
+};
+
 // Interface for the Winding Number algorithm.
 //
 // The winding number is the number of times a polygon winds counter-clockwise around a point. If the polygon winds
@@ -26,19 +69,60 @@ namespace winding_number {
 //
 // If the point lies on the edge of the polygon, then it is considered inside the polygon -- so the winding number would
 // be the number of times the polygon goes counter-clockwise through the point.
-//
-// TODO: Implement a good subclass of IWindingNumberAlgorithm and change IWindingNumberAlgorithm::Create() to return it.
 class IWindingNumberAlgorithm {
 public:
     virtual ~IWindingNumberAlgorithm() = default;
 
-    // Returns the implementation of the IWindingNumberAlgorithm that will be used.
+    // Returns the default implementation of the IWindingNumberAlgorithm, "improved".
     [[nodiscard]] static std::unique_ptr<IWindingNumberAlgorithm> Create();
 
+    // Returns the registered algorithm with this name, or nullptr if there is none.
+    [[nodiscard]] static std::unique_ptr<IWindingNumberAlgorithm> Create(std::string_view name);
+
+    // Returns the algorithm expected to be fastest for the hinted workload, among those that meet its precision.
+    [[nodiscard]] static std::unique_ptr<IWindingNumberAlgorithm> Create(const AlgorithmHints& hints);
+
+    // Autotuning: runs every algorithm that meets the hinted precision on a sample of the workload, and returns the
+    // fastest one. The sample should be representative -- a typical polygon with a typical batch of points.
+    [[nodiscard]] static std::unique_ptr<IWindingNumberAlgorithm> Create(const AlgorithmHints& hints,
+                                                                         const poly::Polygon& sample_polygon,
+                                                                         const poly::PointBatch& sample_points);
+
+    // Returns every registered algorithm, in the order Create(name) looks them up.
+    static std::vector<AlgorithmInfo> Algorithms();
+
+    // The name this algorithm is registered under. Implementations from outside the registry may keep the default, an
+    // empty string.
+    virtual std::string name() const;
+
     // Returns the winding number of a 2D point with respect to a 2D polygon, when it is possible to do so, otherwise
     // returns std::nullopt.
     virtual std::optional<int> CalculateWindingNumber2D(float x, float y, poly::Polygon polygon) = 0;
 
+    // Returns the winding numbers of every point in a batch with respect to the same polygon, in the order of the
+    // batch. The default implementation calls CalculateWindingNumber2D() once per point.
+    //
+    // Algorithms that prepare a polygon keep the last one, but each call still copies the polygon and compares it
+    // with the kept one, which is O(n). Prepare() the polygon when single points arrive one call at a time.
+    virtual std::vector<std::optional<int>> CalculateWindingNumbers2D(const poly::PointBatch& points,
+                                                                      const poly::Polygon& polygon);
+
+    // Prepares the polygon with the algorithm's current tolerance, for queries that don't pass it again. The default
+    // implementation keeps a copy of the polygon and calls CalculateWindingNumber2D() on this algorithm, so that
+    // handle must not outlive it and is not safe to query from several threads; registered algorithms that prepare
+    // their polygons return handles that own everything they need.
+    virtual std::unique_ptr<IPreparedPolygon> Prepare(const poly::Polygon& polygon);
+
+    // Returns the total winding number of a 2D point over all the rings of a multipolygon, when every ring is closed,
+    // otherwise returns std::nullopt. All rings are walked in one pass over the contiguous storage. Points on the
+    // boundary of any ring report the number of times the boundary passes through them (see edge_crossing.hpp).
+    virtual std::optional<int> CalculateWindingNumber2D(float x, float y, const poly::MultiPolygon& multi_polygon);
+
+    // Returns the total winding numbers of every point in a batch with respect to the same multipolygon. The rings are
+    // checked and bounded once, so points outside the multipolygon's bounding box cost a single test.
+    virtual std::vector<std::optional<int>> CalculateWindingNumbers2D(const poly::PointBatch& points,
+                                                                      const poly::MultiPolygon& multi_polygon);
+
     // Getters and setters for an initial set of parameters and results.
     float tolerance() const noexcept;
     void tolerance(float tolerance) noexcept;
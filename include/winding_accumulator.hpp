@@ -0,0 +1,80 @@
+#ifndef WINDING_ACCUMULATOR_HPP_
+#define WINDING_ACCUMULATOR_HPP_
+
+#include <optional>
+#include <string_view>
+
+#include <edge_crossing.hpp>
+#include <poly_io.hpp>
+
+namespace winding_number {
+
+// WindingAccumulator computes the winding number of a point with respect to a polygon whose vertices arrive one at a
+// time, keeping nothing but the first and the latest vertex. Each edge is scored by the rules of edge_crossing.hpp as
+// soon as its end vertex arrives, so the result is the one the "scalar" algorithm gives for the same polygon.
+//
+// As an IRecordSink it can be handed to IPolygonReader::TryStreamPointAndPolygonFromString(), which evaluates a
+// record while it is parsed.
+class WindingAccumulator final : public poly::IRecordSink {
+public:
+    // Vertices closer than tolerance in both dimensions count as the same when checking that the polygon is closed.
+    explicit WindingAccumulator(float tolerance = 0.f);
+
+    // Starts over with a new point and no vertices.
+    void StartRecord(float point_x, float point_y) override {
+        point_x_ = point_x;
+        point_y_ = point_y;
+        size_ = 0;
+        crossings_ = 0;
+        contacts_ = 0;
+    }
+
+    // Defined here, so that loops calling it on a WindingAccumulator inline it.
+    void AppendPoint(float x, float y) override {
+        if (size_ == 0) {
+            first_x_ = x;
+            first_y_ = y;
+        } else {
+            contacts_ += EdgeContainsPoint(last_x_, last_y_, x, y, point_x_, point_y_);
+            crossings_ += EdgeCrossing(last_x_, last_y_, x, y, point_x_, point_y_);
+        }
+        last_x_ = x;
+        last_y_ = y;
+        ++size_;
+    }
+
+    void EndRecord() override;
+
+    // The winding number of the point with respect to the vertices so far, or std::nullopt if there are none or the
+    // last one is not the first one again, up to tolerance.
+    std::optional<int> winding_number() const noexcept;
+
+    size_t size() const noexcept;
+
+private:
+    float tolerance_;
+    float point_x_ = 0.f, point_y_ = 0.f;
+    float first_x_ = 0.f, first_y_ = 0.f;
+    float last_x_ = 0.f, last_y_ = 0.f;
+    size_t size_ = 0;
+    int crossings_ = 0;
+    int contacts_ = 0;
+};
+
+// Returns the winding number of the point of a record, in the format IPolygonReader::CreatePointAndPolygonFromString()
+// accepts, with respect to its polygon. The winding number is computed while the record is parsed, in one pass over
+// the string and without building a Polygon. The record of the result is the point and its winding number, which is
+// std::nullopt if the polygon is not closed up to tolerance.
+poly::ParseResult<std::optional<int>> CalculateWindingNumberFromString(std::string_view polygon_string,
+                                                                       poly::IPolygonReader& reader,
+                                                                       float tolerance = 0.f);
+
+// Does the same for every record of a file, like IPolygonReader::TryReadPointsAndPolygonsFromFile(). Memory use does
+// not depend on the size of the polygons.
+poly::ReadResult<std::optional<int>> CalculateWindingNumbersFromFile(std::string_view filepath,
+                                                                     poly::IPolygonReader& reader,
+                                                                     float tolerance = 0.f);
+
+}  // namespace winding_number
+
+#endif
@@ -0,0 +1,363 @@
+#include <bezier_path.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+#include <edge_crossing.hpp>
+#include <instrumentation.hpp>
+
+namespace poly {
+namespace {
+
+    // Number of points a segment consumes.
+    size_t PointCount(BezierPath::Segment segment) {
+        switch (segment) {
+        case BezierPath::Segment::kQuadratic:
+            return 2;
+        case BezierPath::Segment::kCubic:
+            return 3;
+        default:
+            return 1;
+        }
+    }
+
+    // Calls fn(first_segment, last_segment, first_point, last_point) with the ranges of segments and points of every
+    // contour.
+    template <typename Fn>
+    void ForEachContour(const BezierPath& path, Fn fn) {
+        size_t segment = 0, point = 0;
+        while (segment < path.segments_.size()) {
+            const size_t first_segment = segment, first_point = point;
+            do {
+                point += PointCount(path.segments_[segment++]);
+            } while (segment < path.segments_.size() && path.segments_[segment] != BezierPath::Segment::kMove);
+            fn(first_segment, segment, first_point, point);
+        }
+    }
+
+    // The point at parameter t of the Bezier curve with control points (xs[i], ys[i]), i <= degree, by de Casteljau.
+    std::pair<double, double> Evaluate(const double* xs, const double* ys, size_t degree, double t) {
+        double x[4], y[4];
+        std::copy(xs, xs + degree + 1, x);
+        std::copy(ys, ys + degree + 1, y);
+        for (size_t level = degree; level > 0; --level) {
+            for (size_t i = 0; i < level; ++i) {
+                x[i] += t * (x[i + 1] - x[i]);
+                y[i] += t * (y[i + 1] - y[i]);
+            }
+        }
+        return {x[0], y[0]};
+    }
+
+}  // namespace
+
+void BezierPath::MoveTo(float x, float y) {
+    segments_.push_back(Segment::kMove);
+    x_vec_.push_back(x);
+    y_vec_.push_back(y);
+}
+
+void BezierPath::LineTo(float x, float y) {
+    if (segments_.empty()) {
+        MoveTo(0.f, 0.f);
+    }
+    segments_.push_back(Segment::kLine);
+    x_vec_.push_back(x);
+    y_vec_.push_back(y);
+}
+
+void BezierPath::QuadraticTo(float control_x, float control_y, float x, float y) {
+    if (segments_.empty()) {
+        MoveTo(0.f, 0.f);
+    }
+    segments_.push_back(Segment::kQuadratic);
+    x_vec_.insert(x_vec_.end(), {control_x, x});
+    y_vec_.insert(y_vec_.end(), {control_y, y});
+}
+
+void BezierPath::CubicTo(float control1_x, float control1_y, float control2_x, float control2_y, float x, float y) {
+    if (segments_.empty()) {
+        MoveTo(0.f, 0.f);
+    }
+    segments_.push_back(Segment::kCubic);
+    x_vec_.insert(x_vec_.end(), {control1_x, control2_x, x});
+    y_vec_.insert(y_vec_.end(), {control1_y, control2_y, y});
+}
+
+void BezierPath::ClosePolygon() {
+    // Closing a contour adds a segment in the middle of the vectors, so the path is rebuilt.
+    BezierPath closed;
+    ForEachContour(*this, [&](size_t first_segment, size_t last_segment, size_t first_point, size_t last_point) {
+        closed.segments_.insert(closed.segments_.end(), segments_.begin() + first_segment,
+                                segments_.begin() + last_segment);
+        closed.x_vec_.insert(closed.x_vec_.end(), x_vec_.begin() + first_point, x_vec_.begin() + last_point);
+        closed.y_vec_.insert(closed.y_vec_.end(), y_vec_.begin() + first_point, y_vec_.begin() + last_point);
+        if (x_vec_[first_point] != x_vec_[last_point - 1] || y_vec_[first_point] != y_vec_[last_point - 1]) {
+            closed.LineTo(x_vec_[first_point], y_vec_[first_point]);
+        }
+    });
+    *this = std::move(closed);
+}
+
+bool BezierPath::IsClosed(float tolerance) const {
+    if (segments_.empty()) {
+        return false;
+    }
+    bool closed = true;
+    ForEachContour(*this, [&](size_t, size_t, size_t first_point, size_t last_point) {
+        closed = closed && std::abs(x_vec_[first_point] - x_vec_[last_point - 1]) <= tolerance &&
+                 std::abs(y_vec_[first_point] - y_vec_[last_point - 1]) <= tolerance;
+    });
+    return closed;
+}
+
+size_t BezierPath::size() const {
+    return x_vec_.size();
+}
+
+MultiPolygon BezierPath::Flatten(size_t pieces) const {
+    MultiPolygon flattened;
+    size_t point = 0;
+    for (Segment segment : segments_) {
+        if (segment == Segment::kMove) {
+            flattened.StartRing();
+        }
+        const size_t degree = segment == Segment::kMove ? 0 : PointCount(segment);
+        if (degree > 1) {
+            double xs[4], ys[4];
+            std::copy(x_vec_.begin() + point - 1, x_vec_.begin() + point + degree, xs);
+            std::copy(y_vec_.begin() + point - 1, y_vec_.begin() + point + degree, ys);
+            for (size_t i = 1; i < pieces; ++i) {
+                const auto [x, y] = Evaluate(xs, ys, degree, double(i) / double(pieces));
+                flattened.AppendPoint(float(x), float(y));
+            }
+        }
+        point += PointCount(segment);
+        flattened.AppendPoint(x_vec_[point - 1], y_vec_[point - 1]);
+    }
+    return flattened;
+}
+
+}  // namespace poly
+
+namespace winding_number {
+namespace {
+
+    // Parameters in (0, 1) where the derivative of the Bezier polynomial with coefficients p[0..degree] is 0.
+    void AppendTurningPoints(const double* p, size_t degree, std::vector<double>& ts) {
+        auto append = [&ts](double t) {
+            if (t > 0 && t < 1) {
+                ts.push_back(t);
+            }
+        };
+        if (degree == 2) {
+            const double denominator = p[0] - 2 * p[1] + p[2];
+            if (denominator != 0) {
+                append((p[0] - p[1]) / denominator);
+            }
+            return;
+        }
+        // The derivative of a cubic, divided by 3, is a t^2 + b t + c.
+        const double a = -p[0] + 3 * p[1] - 3 * p[2] + p[3];
+        const double b = 2 * (p[0] - 2 * p[1] + p[2]);
+        const double c = p[1] - p[0];
+        if (a == 0) {
+            if (b != 0) {
+                append(-c / b);
+            }
+            return;
+        }
+        const double discriminant = b * b - 4 * a * c;
+        if (discriminant < 0) {
+            return;
+        }
+        // The form that avoids cancelling b against the square root.
+        const double q = -0.5 * (b + std::copysign(std::sqrt(discriminant), b));
+        append(q / a);
+        if (q != 0) {
+            append(c / q);
+        }
+    }
+
+    // Power form coefficients, highest first, of the Bezier polynomial with coefficients p[0..degree].
+    void ToPowerForm(const double* p, size_t degree, double (&power)[4]) {
+        if (degree == 2) {
+            power[0] = 0;
+            power[1] = p[0] - 2 * p[1] + p[2];
+            power[2] = 2 * (p[1] - p[0]);
+        } else {
+            power[0] = -p[0] + 3 * p[1] - 3 * p[2] + p[3];
+            power[1] = 3 * (p[0] - 2 * p[1] + p[2]);
+            power[2] = 3 * (p[1] - p[0]);
+        }
+        power[3] = p[0];
+    }
+
+    double Horner(const double (&power)[4], double t) {
+        return ((power[0] * t + power[1]) * t + power[2]) * t + power[3];
+    }
+
+    double Derivative(const double (&power)[4], double t) {
+        return (3 * power[0] * t + 2 * power[1]) * t + power[2];
+    }
+
+    // The parameter in [0, 1] where a piece that is monotone in y reaches y = target, given that it does. Newton steps
+    // that leave the bracket fall back to bisection.
+    double SolveForY(const double (&y)[4], bool increasing, double target) {
+        double low = 0, high = 1;
+        const double y0 = y[3], y1 = Horner(y, 1);
+        double t = y1 != y0 ? std::clamp((target - y0) / (y1 - y0), 0.0, 1.0) : 0.5;
+        for (int iteration = 0; iteration < 100; ++iteration) {
+            const double f = Horner(y, t) - target;
+            if (f == 0) {
+                return t;
+            }
+            if ((f < 0) == increasing) {
+                low = t;
+            } else {
+                high = t;
+            }
+            double next = t - f / Derivative(y, t);
+            if (!(next > low && next < high)) {
+                next = 0.5 * (low + high);
+            }
+            if (next == t || next <= low || next >= high) {
+                break;
+            }
+            t = next;
+        }
+        return t;
+    }
+
+}  // namespace
+
+PreparedBezierPath::PreparedBezierPath(const poly::BezierPath& path, float tolerance) :
+        closed_(path.IsClosed(tolerance)) {
+    if (!closed_) {
+        return;
+    }
+    size_t point = 0;
+    for (auto segment : path.segments_) {
+        if (segment == poly::BezierPath::Segment::kMove) {
+            ++point;
+            continue;
+        }
+        if (segment == poly::BezierPath::Segment::kLine) {
+            lines_.push_back({path.x_vec_[point - 1], path.y_vec_[point - 1], path.x_vec_[point], path.y_vec_[point]});
+            ++point;
+            continue;
+        }
+        const size_t degree = segment == poly::BezierPath::Segment::kQuadratic ? 2 : 3;
+        double xs[4], ys[4];
+        std::copy(path.x_vec_.begin() + point - 1, path.x_vec_.begin() + point + degree, xs);
+        std::copy(path.y_vec_.begin() + point - 1, path.y_vec_.begin() + point + degree, ys);
+        point += degree;
+
+        std::vector<double> ts;
+        AppendTurningPoints(xs, degree, ts);
+        AppendTurningPoints(ys, degree, ts);
+        // x and y can turn at the same parameter, as at a cusp, and rounding then gives two nearly equal ones.
+        std::sort(ts.begin(), ts.end());
+        ts.erase(std::unique(ts.begin(), ts.end(), [](double a, double b) { return b - a < 1e-12; }), ts.end());
+
+        // Cuts off one piece at a time by de Casteljau, leaving the rest of the segment in xs and ys. The last piece is
+        // that rest, so it ends exactly where the next segment starts.
+        auto append_piece = [this, degree](const double* piece_xs, const double* piece_ys) {
+            Piece piece;
+            ToPowerForm(piece_xs, degree, piece.x);
+            ToPowerForm(piece_ys, degree, piece.y);
+            piece.x_start = piece_xs[0];
+            piece.y_start = piece_ys[0];
+            piece.x_end = piece_xs[degree];
+            piece.y_end = piece_ys[degree];
+            pieces_.push_back(piece);
+        };
+        double done = 0;
+        for (double t : ts) {
+            const double local = (t - done) / (1 - done);
+            double left_xs[4], left_ys[4];
+            for (size_t level = 0; level <= degree; ++level) {
+                left_xs[level] = xs[0];
+                left_ys[level] = ys[0];
+                for (size_t i = 0; i < degree - level; ++i) {
+                    xs[i] += local * (xs[i + 1] - xs[i]);
+                    ys[i] += local * (ys[i + 1] - ys[i]);
+                }
+            }
+            append_piece(left_xs, left_ys);
+            done = t;
+        }
+        append_piece(xs, ys);
+    }
+
+    // Sorted by lowest y, so that a query stops at the first piece that starts above it.
+    auto low_y = [](const Piece& piece) { return std::min(piece.y_start, piece.y_end); };
+    std::sort(pieces_.begin(), pieces_.end(),
+              [&low_y](const Piece& a, const Piece& b) { return low_y(a) < low_y(b); });
+    for (const auto& piece : pieces_) {
+        y_ranges_.push_back({low_y(piece), std::max(piece.y_start, piece.y_end)});
+    }
+}
+
+std::optional<int> PreparedBezierPath::CalculateWindingNumber2D(float x, float y) const {
+    if (!closed_) {
+        WINDING_COUNT(kUnclosedPolygons, 1);
+        return std::nullopt;
+    }
+    int winding_number = 0;
+    int contacts = 0;
+    for (const auto& line : lines_) {
+        contacts += EdgeContainsPoint(line.x0, line.y0, line.x1, line.y1, x, y);
+        winding_number += EdgeCrossing(line.x0, line.y0, line.x1, line.y1, x, y);
+    }
+    // The same rules for each piece: it covers [lower end, upper end) in y, and crosses the ray when it passes right
+    // of the point there. Only pieces whose y range holds y can contain or cross it.
+    for (size_t i = 0; i < pieces_.size() && y_ranges_[i].first <= y; ++i) {
+        const double low_y = y_ranges_[i].first, high_y = y_ranges_[i].second;
+        if (y > high_y) {
+            continue;
+        }
+        const Piece& piece = pieces_[i];
+        if (x == piece.x_start && y == piece.y_start) {
+            ++contacts;
+        }
+        const double low_x = std::min(piece.x_start, piece.x_end), high_x = std::max(piece.x_start, piece.x_end);
+        if (low_y == high_y) {
+            contacts += x >= low_x && x <= high_x && x != piece.x_start && x != piece.x_end;
+            continue;
+        }
+        if (y == high_y || x > high_x) {
+            continue;
+        }
+        const int direction = piece.y_end > piece.y_start ? 1 : -1;
+        if (x < low_x) {
+            winding_number += direction;
+            continue;
+        }
+        const double curve_x = Horner(piece.x, SolveForY(piece.y, direction > 0, y));
+        if (curve_x > x) {
+            winding_number += direction;
+        } else if (curve_x == x && y != piece.y_start && y != piece.y_end) {
+            ++contacts;
+        }
+    }
+    WINDING_COUNT(kCalls, 1);
+    WINDING_COUNT(kVertices, lines_.size() + pieces_.size());
+    WINDING_COUNT(kOnEdge, contacts > 0);
+    return contacts > 0 ? contacts : winding_number;
+}
+
+std::vector<std::optional<int>> PreparedBezierPath::CalculateWindingNumbers2D(const poly::PointBatch& points) const {
+    std::vector<std::optional<int>> winding_numbers;
+    winding_numbers.reserve(points.size());
+    for (size_t i = 0; i < points.size(); ++i) {
+        winding_numbers.push_back(CalculateWindingNumber2D(points.x_vec_[i], points.y_vec_[i]));
+    }
+    return winding_numbers;
+}
+
+size_t PreparedBezierPath::piece_count() const noexcept {
+    return pieces_.size();
+}
+
+}  // namespace winding_number
@@ -0,0 +1,214 @@
+#include <containment_hierarchy.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <utility>
+
+#include <instrumentation.hpp>
+#include <parallel.hpp>
+
+namespace winding_number {
+namespace {
+
+    struct Box {
+        float min_x, min_y, max_x, max_y;
+
+        bool Contains(const Box& other) const {
+            return min_x <= other.min_x && min_y <= other.min_y && other.max_x <= max_x && other.max_y <= max_y;
+        }
+    };
+
+    Box Bounds(const poly::Polygon& polygon) {
+        const auto [min_x, max_x] = std::minmax_element(polygon.x_vec_.begin(), polygon.x_vec_.end());
+        const auto [min_y, max_y] = std::minmax_element(polygon.y_vec_.begin(), polygon.y_vec_.end());
+        return {*min_x, *min_y, *max_x, *max_y};
+    }
+
+    double Area(const poly::Polygon& polygon) {
+        double twice_area = 0;
+        for (size_t i = 0; i + 1 < polygon.size(); ++i) {
+            twice_area += double(polygon.x_vec_[i]) * polygon.y_vec_[i + 1] -
+                          double(polygon.x_vec_[i + 1]) * polygon.y_vec_[i];
+        }
+        return std::fabs(twice_area) / 2;
+    }
+
+}  // namespace
+
+ContainmentHierarchy::ContainmentHierarchy(const std::vector<poly::Polygon>& polygons, float tolerance) {
+    if (!Prepare(polygons, tolerance)) {
+        return;
+    }
+    // Larger polygons are placed first, so each one only has to find its parent among those already in the tree,
+    // going down from the top level while some child takes it in. Equal areas keep their input order.
+    std::vector<Box> boxes;
+    std::vector<double> areas;
+    for (const poly::Polygon& polygon : polygons) {
+        boxes.push_back(Bounds(polygon));
+        areas.push_back(Area(polygon));
+    }
+    std::vector<uint32_t> order(polygons.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) { return areas[a] > areas[b]; });
+
+    // children[0] is the top level and children[i + 1] those of polygon i.
+    std::vector<std::vector<uint32_t>> children(polygons.size() + 1);
+    for (uint32_t polygon : order) {
+        uint32_t slot = 0;
+        for (bool descended = true; descended;) {
+            descended = false;
+            for (uint32_t candidate : children[slot]) {
+                if (boxes[candidate].Contains(boxes[polygon]) && Nests(polygons[polygon], candidate)) {
+                    slot = candidate + 1;
+                    descended = true;
+                    break;
+                }
+            }
+        }
+        children[slot].push_back(polygon);
+        parents_[polygon] = slot == 0 ? kNone : slot - 1;
+    }
+    // Children are kept in input order, which is the order FindPath() reports overlapping siblings in.
+    for (auto& siblings : children) {
+        std::sort(siblings.begin(), siblings.end());
+    }
+    Build(polygons, std::move(children));
+}
+
+ContainmentHierarchy::ContainmentHierarchy(const std::vector<poly::Polygon>& polygons,
+                                           const std::vector<std::optional<size_t>>& parents, float tolerance) {
+    if (parents.size() != polygons.size()) {
+        Fail("got " + std::to_string(parents.size()) + " parents for " + std::to_string(polygons.size()) +
+             " polygons");
+        return;
+    }
+    if (!Prepare(polygons, tolerance)) {
+        return;
+    }
+    std::vector<std::vector<uint32_t>> children(polygons.size() + 1);
+    for (size_t i = 0; i < polygons.size(); ++i) {
+        if (parents[i] && (*parents[i] >= polygons.size() || *parents[i] == i)) {
+            Fail("polygon " + std::to_string(i) + " has no parent " + std::to_string(*parents[i]));
+            return;
+        }
+        parents_[i] = parents[i] ? static_cast<uint32_t>(*parents[i]) : kNone;
+        children[parents[i] ? *parents[i] + 1 : 0].push_back(static_cast<uint32_t>(i));
+    }
+    Build(polygons, std::move(children));
+}
+
+bool ContainmentHierarchy::Prepare(const std::vector<poly::Polygon>& polygons, float tolerance) {
+    for (size_t i = 0; i < polygons.size(); ++i) {
+        if (polygons[i].size() == 0 || !polygons[i].IsClosed(tolerance)) {
+            Fail("polygon " + std::to_string(i) + " is not closed");
+            return false;
+        }
+    }
+    engines_.reserve(polygons.size());
+    for (const poly::Polygon& polygon : polygons) {
+        engines_.emplace_back(polygon, tolerance);
+    }
+    parents_.assign(polygons.size(), kNone);
+    return true;
+}
+
+bool ContainmentHierarchy::Contains(uint32_t polygon, float x, float y) const {
+    return engines_[polygon].CalculateWindingNumber2D(x, y).value_or(0) != 0;
+}
+
+bool ContainmentHierarchy::Nests(const poly::Polygon& child, uint32_t parent) const {
+    for (size_t i = 0; i + 1 < child.size(); ++i) {
+        if (!Contains(parent, child.x_vec_[i], child.y_vec_[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void ContainmentHierarchy::Build(const std::vector<poly::Polygon>& polygons,
+                                 std::vector<std::vector<uint32_t>> children) {
+    // Nodes are laid out level by level, so every node's children sit next to each other.
+    constexpr float kInfinity = std::numeric_limits<float>::infinity();
+    nodes_ = {{-kInfinity, -kInfinity, kInfinity, kInfinity, kNone, 0, 0}};
+    std::vector<size_t> levels = {0};
+    for (size_t n = 0; n < nodes_.size(); ++n) {
+        const auto& siblings = children[nodes_[n].polygon == kNone ? 0 : nodes_[n].polygon + 1];
+        nodes_[n].first_child = static_cast<uint32_t>(nodes_.size());
+        nodes_[n].child_count = static_cast<uint32_t>(siblings.size());
+        for (uint32_t polygon : siblings) {
+            const Box box = Bounds(polygons[polygon]);
+            nodes_.push_back({box.min_x, box.min_y, box.max_x, box.max_y, polygon, 0, 0});
+            levels.push_back(levels[n] + 1);
+            depth_ = std::max(depth_, levels.back());
+        }
+    }
+    // Polygons whose parents form a cycle are never reached from the top level.
+    if (nodes_.size() != polygons.size() + 1) {
+        Fail("the parents of " + std::to_string(polygons.size() + 1 - nodes_.size()) + " polygons form a cycle");
+    }
+}
+
+void ContainmentHierarchy::Fail(std::string error_message) {
+    valid_ = false;
+    error_message_ = std::move(error_message);
+    nodes_.clear();
+    depth_ = 0;
+}
+
+std::vector<size_t> ContainmentHierarchy::FindPath(float x, float y) const {
+    std::vector<size_t> path;
+    if (valid_) {
+        FindPath(0, x, y, path);
+    }
+    return path;
+}
+
+void ContainmentHierarchy::FindPath(uint32_t node, float x, float y, std::vector<size_t>& path) const {
+    const Node& parent = nodes_[node];
+    for (uint32_t n = parent.first_child; n < parent.first_child + parent.child_count; ++n) {
+        const Node& child = nodes_[n];
+        if (x < child.min_x || x > child.max_x || y < child.min_y || y > child.max_y) {
+            WINDING_COUNT(kEarlyRejects, 1);
+            continue;
+        }
+        if (Contains(child.polygon, x, y)) {
+            path.push_back(child.polygon);
+            FindPath(n, x, y, path);
+        }
+    }
+}
+
+std::vector<std::vector<size_t>> ContainmentHierarchy::FindPaths(const poly::PointBatch& points,
+                                                                 size_t thread_count) const {
+    std::vector<std::vector<size_t>> paths(points.size());
+    ParallelFor(
+            points.size(), [&](size_t i) { paths[i] = FindPath(points.x_vec_[i], points.y_vec_[i]); }, thread_count);
+    return paths;
+}
+
+std::optional<size_t> ContainmentHierarchy::parent(size_t polygon) const {
+    if (polygon >= parents_.size() || parents_[polygon] == kNone) {
+        return std::nullopt;
+    }
+    return parents_[polygon];
+}
+
+bool ContainmentHierarchy::valid() const noexcept {
+    return valid_;
+}
+
+const std::string& ContainmentHierarchy::error_message() const noexcept {
+    return error_message_;
+}
+
+size_t ContainmentHierarchy::root_count() const noexcept {
+    return nodes_.empty() ? 0 : nodes_[0].child_count;
+}
+
+size_t ContainmentHierarchy::depth() const noexcept {
+    return depth_;
+}
+
+}  // namespace winding_number
@@ -0,0 +1,186 @@
+#include <convex_polygon.hpp>
+
+#include <algorithm>
+
+#include <edge_crossing.hpp>
+#include <instrumentation.hpp>
+
+namespace winding_number {
+namespace {
+
+    int Sign(double value) {
+        return (value > 0) - (value < 0);
+    }
+
+    // Whether (x, y) is on the segment (x0, y0) - (x1, y1), given that it is on the line through them.
+    bool WithinSegment(float x0, float y0, float x1, float y1, float x, float y) {
+        return std::min(x0, x1) <= x && x <= std::max(x0, x1) && std::min(y0, y1) <= y && y <= std::max(y0, y1);
+    }
+
+    // Number of times the sign of the non-zero values changes going once around the cycle.
+    size_t CyclicSignChanges(const std::vector<int>& signs) {
+        size_t changes = 0;
+        int previous = 0;
+        for (size_t i = 0; i < 2 * signs.size(); ++i) {
+            const int sign = signs[i % signs.size()];
+            if (sign == 0) {
+                continue;
+            }
+            if (previous != 0 && sign != previous && i >= signs.size()) {
+                ++changes;
+            }
+            previous = sign;
+        }
+        return changes;
+    }
+
+}  // namespace
+
+ConvexPolygon::ConvexPolygon(const poly::Polygon& polygon, float tolerance) :
+        closed_(polygon.size() > 0 && polygon.IsClosed(tolerance)) {
+    if (!closed_) {
+        return;
+    }
+
+    // The corners: the vertices without the closing point, repeats, and vertices in the middle of a straight side.
+    std::vector<float> xs, ys;
+    for (size_t i = 0; i + 1 < polygon.size(); ++i) {
+        if (xs.empty() || polygon.x_vec_[i] != xs.back() || polygon.y_vec_[i] != ys.back()) {
+            xs.push_back(polygon.x_vec_[i]);
+            ys.push_back(polygon.y_vec_[i]);
+        }
+    }
+    while (xs.size() > 1 && xs.back() == xs.front() && ys.back() == ys.front()) {
+        xs.pop_back();
+        ys.pop_back();
+    }
+
+    bool convex = xs.size() >= 3;
+    const size_t n = xs.size();
+    std::vector<bool> corner(n, true);
+    int turn = 0;
+    for (size_t i = 0; i < n && convex; ++i) {
+        const size_t prev = (i + n - 1) % n, next = (i + 1) % n;
+        const int side = Sign(EdgeSide(xs[prev], ys[prev], xs[i], ys[i], xs[next], ys[next]));
+        if (side == 0) {
+            // Going straight on is fine, doubling back is a spike.
+            const double dot = (double(xs[i]) - xs[prev]) * (double(xs[next]) - xs[i]) +
+                               (double(ys[i]) - ys[prev]) * (double(ys[next]) - ys[i]);
+            convex = dot > 0;
+            corner[i] = false;
+        } else if (turn == 0 || side == turn) {
+            turn = side;
+        } else {
+            convex = false;
+        }
+    }
+
+    std::vector<float> corner_xs, corner_ys;
+    std::vector<int> dx_signs, dy_signs;
+    for (size_t i = 0; i < n && convex; ++i) {
+        if (corner[i]) {
+            corner_xs.push_back(xs[i]);
+            corner_ys.push_back(ys[i]);
+        }
+    }
+    for (size_t i = 0; i < corner_xs.size(); ++i) {
+        const size_t next = (i + 1) % corner_xs.size();
+        dx_signs.push_back(Sign(double(corner_xs[next]) - corner_xs[i]));
+        dy_signs.push_back(Sign(double(corner_ys[next]) - corner_ys[i]));
+    }
+    // Turning the same way at every corner is not enough: a pentagram does too, but turns around twice. Going around
+    // once, x and y each change direction exactly twice.
+    convex = convex && turn != 0 && corner_xs.size() >= 3 && CyclicSignChanges(dx_signs) <= 2 &&
+             CyclicSignChanges(dy_signs) <= 2;
+
+    if (convex) {
+        orientation_ = turn;
+        if (turn < 0) {
+            std::reverse(corner_xs.begin(), corner_xs.end());
+            std::reverse(corner_ys.begin(), corner_ys.end());
+        }
+        x_vec_ = std::move(corner_xs);
+        y_vec_ = std::move(corner_ys);
+    } else {
+        x_vec_.assign(polygon.x_vec_.begin(), polygon.x_vec_.end());
+        y_vec_.assign(polygon.y_vec_.begin(), polygon.y_vec_.end());
+    }
+}
+
+std::optional<int> ConvexPolygon::CalculateWindingNumber2D(float x, float y) const {
+    if (!closed_) {
+        WINDING_COUNT(kUnclosedPolygons, 1);
+        return std::nullopt;
+    }
+    WINDING_COUNT(kCalls, 1);
+    return orientation_ != 0 ? ConvexWindingNumber(x, y) : GeneralWindingNumber(x, y);
+}
+
+int ConvexPolygon::ConvexWindingNumber(float x, float y) const {
+    const float* xs = x_vec_.data();
+    const float* ys = y_vec_.data();
+    const size_t last = x_vec_.size() - 1;
+
+    // The point must be inside the angle at corner 0, between its two sides. Being on the line through a side means
+    // being on that side or outside, since the whole polygon is on one side of it.
+    const double first_side = EdgeSide(xs[0], ys[0], xs[1], ys[1], x, y);
+    const double last_side = EdgeSide(xs[last], ys[last], xs[0], ys[0], x, y);
+    if (first_side < 0 || last_side < 0) {
+        WINDING_COUNT(kEarlyRejects, 1);
+        return 0;
+    }
+    if (first_side == 0 || last_side == 0) {
+        const size_t other = first_side == 0 ? 1 : last;
+        const bool on_side = WithinSegment(xs[0], ys[0], xs[other], ys[other], x, y);
+        WINDING_COUNT(kOnEdge, on_side);
+        return on_side ? 1 : 0;
+    }
+
+    // Then find the triangle (0, low, low + 1) of the fan around corner 0 whose angle holds it.
+    size_t low = 1, high = last;
+    while (high - low > 1) {
+        const size_t middle = low + (high - low) / 2;
+        if (EdgeSide(xs[0], ys[0], xs[middle], ys[middle], x, y) >= 0) {
+            low = middle;
+        } else {
+            high = middle;
+        }
+        WINDING_COUNT(kVertices, 1);
+    }
+    const double side = EdgeSide(xs[low], ys[low], xs[high], ys[high], x, y);
+    WINDING_COUNT(kOnEdge, side == 0);
+    return side > 0 ? orientation_ : (side == 0 ? 1 : 0);
+}
+
+int ConvexPolygon::GeneralWindingNumber(float x, float y) const {
+    int winding_number = 0;
+    int contacts = 0;
+    const float* xs = x_vec_.data();
+    const float* ys = y_vec_.data();
+    for (size_t i = 0; i + 1 < x_vec_.size(); ++i) {
+        contacts += EdgeContainsPoint(xs[i], ys[i], xs[i + 1], ys[i + 1], x, y);
+        winding_number += EdgeCrossing(xs[i], ys[i], xs[i + 1], ys[i + 1], x, y);
+    }
+    WINDING_COUNT(kVertices, x_vec_.size());
+    WINDING_COUNT(kOnEdge, contacts > 0);
+    return contacts > 0 ? contacts : winding_number;
+}
+
+std::vector<std::optional<int>> ConvexPolygon::CalculateWindingNumbers2D(const poly::PointBatch& points) const {
+    std::vector<std::optional<int>> winding_numbers;
+    winding_numbers.reserve(points.size());
+    for (size_t i = 0; i < points.size(); ++i) {
+        winding_numbers.push_back(CalculateWindingNumber2D(points.x_vec_[i], points.y_vec_[i]));
+    }
+    return winding_numbers;
+}
+
+bool ConvexPolygon::convex() const noexcept {
+    return orientation_ != 0;
+}
+
+int ConvexPolygon::orientation() const noexcept {
+    return orientation_;
+}
+
+}  // namespace winding_number
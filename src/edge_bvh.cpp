@@ -0,0 +1,175 @@
+#include <edge_bvh.hpp>
+
+#include <algorithm>
+#include <functional>
+#include <edge_crossing.hpp>
+#include <instrumentation.hpp>
+
+namespace winding_number {
+namespace {
+
+    // Chains per leaf. Each chain in a leaf costs a binary search, so leaves are kept small.
+    constexpr uint32_t kLeafChains = 2;
+
+    // Deep enough for any polygon that fits in 32-bit indices, since the tree is balanced.
+    constexpr size_t kMaxDepth = 64;
+
+    // 1 if y is above the ray, else 0. The net number of crossings of a connected piece of boundary that lies entirely
+    // to the right of the query point is Above(last_y) - Above(first_y).
+    inline int Above(float y, float ray_y) {
+        return y > ray_y ? 1 : 0;
+    }
+
+}  // namespace
+
+EdgeBvh::EdgeBvh(const poly::Polygon& polygon, float tolerance) :
+        closed_(polygon.size() > 0 && polygon.IsClosed(tolerance)),
+        x_vec_(polygon.x_vec_.begin(), polygon.x_vec_.end()),
+        y_vec_(polygon.y_vec_.begin(), polygon.y_vec_.end()) {
+    if (!closed_ || x_vec_.size() < 2) {
+        return;
+    }
+
+    // Split the boundary into maximal y-monotone chains. Horizontal edges join whichever chain they follow.
+    const auto last = static_cast<uint32_t>(x_vec_.size() - 1);
+    uint32_t first = 0;
+    int direction = 0;
+    for (uint32_t i = 0; i < last; ++i) {
+        int edge_direction = y_vec_[i + 1] > y_vec_[i] ? 1 : (y_vec_[i + 1] < y_vec_[i] ? -1 : 0);
+        if (edge_direction != 0 && direction != 0 && edge_direction != direction) {
+            chains_.push_back({first, i, direction > 0});
+            first = i;
+        }
+        if (edge_direction != 0) {
+            direction = edge_direction;
+        }
+    }
+    chains_.push_back({first, last, direction >= 0});
+
+    nodes_.reserve(2 * chains_.size());
+    nodes_.resize(1);
+    Build(0, 0, static_cast<uint32_t>(chains_.size()));
+}
+
+void EdgeBvh::Build(uint32_t index, uint32_t first_chain, uint32_t chain_count) {
+    Node node;
+    if (chain_count <= kLeafChains) {
+        node.min_x = node.max_x = x_vec_[chains_[first_chain].first_vertex];
+        node.min_y = node.max_y = y_vec_[chains_[first_chain].first_vertex];
+        for (uint32_t c = first_chain; c < first_chain + chain_count; ++c) {
+            for (uint32_t v = chains_[c].first_vertex; v <= chains_[c].last_vertex; ++v) {
+                node.min_x = std::min(node.min_x, x_vec_[v]);
+                node.max_x = std::max(node.max_x, x_vec_[v]);
+                node.min_y = std::min(node.min_y, y_vec_[v]);
+                node.max_y = std::max(node.max_y, y_vec_[v]);
+            }
+        }
+        node.left = first_chain;
+        node.count = chain_count;
+    } else {
+        // Children are allocated next to each other so that an inner node only needs to store the first index.
+        const auto left = static_cast<uint32_t>(nodes_.size());
+        nodes_.resize(nodes_.size() + 2);
+        const uint32_t left_count = chain_count / 2;
+        Build(left, first_chain, left_count);
+        Build(left + 1, first_chain + left_count, chain_count - left_count);
+
+        const Node& l = nodes_[left];
+        const Node& r = nodes_[left + 1];
+        node.min_x = std::min(l.min_x, r.min_x);
+        node.min_y = std::min(l.min_y, r.min_y);
+        node.max_x = std::max(l.max_x, r.max_x);
+        node.max_y = std::max(l.max_y, r.max_y);
+        node.left = left;
+        node.count = 0;
+    }
+    node.first_y = y_vec_[chains_[first_chain].first_vertex];
+    node.last_y = y_vec_[chains_[first_chain + chain_count - 1].last_vertex];
+    nodes_[index] = node;
+}
+
+void EdgeBvh::QueryChain(const Chain& chain, float x, float y, int& winding_number, int& contacts) const {
+    // Only the edges whose closed y-range holds y can cross the ray or touch the point, and along a monotone chain
+    // those are contiguous.
+    auto begin = y_vec_.begin() + chain.first_vertex;
+    auto end = y_vec_.begin() + chain.last_vertex + 1;
+    uint32_t first_edge, last_edge;
+    if (chain.ascending) {
+        first_edge = static_cast<uint32_t>(std::lower_bound(begin + 1, end, y) - y_vec_.begin()) - 1;
+        last_edge = static_cast<uint32_t>(std::upper_bound(begin, end - 1, y) - y_vec_.begin());
+    } else {
+        first_edge = static_cast<uint32_t>(std::lower_bound(begin + 1, end, y, std::greater<float>()) -
+                                           y_vec_.begin()) - 1;
+        last_edge = static_cast<uint32_t>(std::upper_bound(begin, end - 1, y, std::greater<float>()) -
+                                          y_vec_.begin());
+    }
+    WINDING_COUNT(kVertices, last_edge - first_edge);
+    for (uint32_t i = first_edge; i < last_edge; ++i) {
+        const float x0 = x_vec_[i], y0 = y_vec_[i], x1 = x_vec_[i + 1], y1 = y_vec_[i + 1];
+        if (EdgeContainsPoint(x0, y0, x1, y1, x, y)) {
+            ++contacts;
+        }
+        winding_number += EdgeCrossing(x0, y0, x1, y1, x, y);
+    }
+}
+
+std::optional<int> EdgeBvh::CalculateWindingNumber2D(float x, float y) const {
+    if (!closed_) {
+        WINDING_COUNT(kUnclosedPolygons, 1);
+        return std::nullopt;
+    }
+    WINDING_COUNT(kCalls, 1);
+    if (nodes_.empty()) {
+        return 0;
+    }
+    const Node& root = nodes_[0];
+    if (root.max_x < x || root.max_y < y || root.min_y > y) {
+        WINDING_COUNT(kEarlyRejects, 1);
+        return 0;
+    }
+
+    int winding_number = 0;
+    int contacts = 0;
+    uint32_t stack[kMaxDepth];
+    size_t depth = 0;
+    stack[depth++] = 0;
+    while (depth > 0) {
+        const Node& node = nodes_[stack[--depth]];
+        if (node.max_x < x || node.max_y < y || node.min_y > y) {
+            continue;
+        }
+        if (node.min_x > x) {
+            winding_number += Above(node.last_y, y) - Above(node.first_y, y);
+            continue;
+        }
+        if (node.count == 0) {
+            stack[depth++] = node.left;
+            stack[depth++] = node.left + 1;
+            continue;
+        }
+        for (uint32_t c = node.left; c < node.left + node.count; ++c) {
+            QueryChain(chains_[c], x, y, winding_number, contacts);
+        }
+    }
+    WINDING_COUNT(kOnEdge, contacts > 0);
+    return contacts > 0 ? contacts : winding_number;
+}
+
+std::vector<std::optional<int>> EdgeBvh::CalculateWindingNumbers2D(const poly::PointBatch& points) const {
+    std::vector<std::optional<int>> winding_numbers;
+    winding_numbers.reserve(points.size());
+    for (size_t i = 0; i < points.size(); ++i) {
+        winding_numbers.push_back(CalculateWindingNumber2D(points.x_vec_[i], points.y_vec_[i]));
+    }
+    return winding_numbers;
+}
+
+size_t EdgeBvh::chain_count() const noexcept {
+    return chains_.size();
+}
+
+size_t EdgeBvh::node_count() const noexcept {
+    return nodes_.size();
+}
+
+}  // namespace winding_number
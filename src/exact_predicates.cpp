@@ -0,0 +1,119 @@
+#include <exact_predicates.hpp>
+
+#include <cmath>
+#include <cstddef>
+
+namespace winding_number {
+namespace {
+
+    // a + b = sum + error exactly, for any two doubles.
+    inline void TwoSum(double a, double b, double& sum, double& error) {
+        sum = a + b;
+        double b_virtual = sum - a;
+        double a_virtual = sum - b_virtual;
+        error = (a - a_virtual) + (b - b_virtual);
+    }
+
+    // a * b = product + error exactly, as long as nothing underflows.
+    inline void TwoProduct(double a, double b, double& product, double& error) {
+        product = a * b;
+        error = std::fma(a, b, -product);
+    }
+
+    // A sum of doubles with non-overlapping mantissas, ordered by increasing magnitude.
+    class Expansion {
+    public:
+        // Adds b to the expansion exactly (Shewchuk's GROW-EXPANSION, dropping zero components).
+        void Add(double b) {
+            double q = b;
+            size_t kept = 0;
+            for (size_t i = 0; i < size_; ++i) {
+                double sum, error;
+                TwoSum(q, components_[i], sum, error);
+                q = sum;
+                if (error != 0) {
+                    components_[kept++] = error;
+                }
+            }
+            if (q != 0) {
+                components_[kept++] = q;
+            }
+            size_ = kept;
+        }
+
+        // The sign of an expansion is the sign of its largest component.
+        int Sign() const {
+            if (size_ == 0) {
+                return 0;
+            }
+            return components_[size_ - 1] > 0 ? 1 : -1;
+        }
+
+    private:
+        // Each Add() grows the expansion by at most one component, and a side test adds 16 terms.
+        double components_[32];
+        size_t size_ = 0;
+    };
+
+    // Adds sign * (a_hi + a_lo) * (b_hi + b_lo) to the expansion.
+    void AddProduct(Expansion& expansion, double a_hi, double a_lo, double b_hi, double b_lo, double sign) {
+        const double as[2] = {a_hi, a_lo};
+        const double bs[2] = {b_hi, b_lo};
+        for (double a : as) {
+            for (double b : bs) {
+                double product, error;
+                TwoProduct(a, b, product, error);
+                expansion.Add(sign * product);
+                expansion.Add(sign * error);
+            }
+        }
+    }
+
+}  // namespace
+
+int ExactEdgeSide(float x0, float y0, float x1, float y1, float x, float y) {
+    // Most of the time the double precision estimate is further from zero than its rounding error can reach
+    // (Shewchuk's ccwerrboundA, which covers rounding the differences too).
+    const double left = (double(x1) - double(x0)) * (double(y) - double(y0));
+    const double right = (double(x) - double(x0)) * (double(y1) - double(y0));
+    const double estimate = left - right;
+    const double error_bound = 3.3306690738754716e-16 * (std::fabs(left) + std::fabs(right));
+    if (estimate > error_bound || -estimate > error_bound) {
+        return estimate > 0 ? 1 : -1;
+    }
+
+    // Otherwise (x1 - x0) * (y - y0) - (x - x0) * (y1 - y0), where every difference is first split into an exact pair.
+    double dx1, dx1_error, dy, dy_error, dx, dx_error, dy1, dy1_error;
+    TwoSum(x1, -double(x0), dx1, dx1_error);
+    TwoSum(y, -double(y0), dy, dy_error);
+    TwoSum(x, -double(x0), dx, dx_error);
+    TwoSum(y1, -double(y0), dy1, dy1_error);
+
+    Expansion side;
+    AddProduct(side, dx1, dx1_error, dy, dy_error, 1.0);
+    AddProduct(side, dx, dx_error, dy1, dy1_error, -1.0);
+    return side.Sign();
+}
+
+std::optional<int> ExactWindingNumber2D(float x, float y, const poly::Polygon& polygon, float tolerance) {
+    if (polygon.size() == 0 || !polygon.IsClosed(tolerance)) {
+        return std::nullopt;
+    }
+    int winding_number = 0;
+    int contacts = 0;
+    for (size_t i = 0; i + 1 < polygon.size(); ++i) {
+        const float x0 = polygon.x_vec_[i], y0 = polygon.y_vec_[i];
+        const float x1 = polygon.x_vec_[i + 1], y1 = polygon.y_vec_[i + 1];
+        if ((y0 <= y) != (y1 <= y)) {
+            int side = ExactEdgeSide(x0, y0, x1, y1, x, y);
+            winding_number += y0 <= y ? (side > 0) : -(side < 0);
+        }
+        if (!(x == x1 && y == y1) && !((x < x0 && x < x1) || (x > x0 && x > x1) || (y < y0 && y < y1) ||
+                                       (y > y0 && y > y1))) {
+            contacts += ExactEdgeSide(x0, y0, x1, y1, x, y) == 0;
+        }
+    }
+    return contacts > 0 ? contacts : winding_number;
+}
+
+}  // namespace winding_number
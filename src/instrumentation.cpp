@@ -0,0 +1,83 @@
+#include <instrumentation.hpp>
+
+namespace winding_number::instrumentation {
+namespace {
+
+    // Blocks are only ever pushed onto the front of the list and never removed, so readers can walk it without locks.
+    std::atomic<ThreadCounters*> thread_counters{nullptr};
+
+}  // namespace
+
+uint64_t Snapshot::count(Counter counter) const noexcept {
+    return counters[static_cast<size_t>(counter)];
+}
+
+uint64_t Snapshot::latency_count() const noexcept {
+    uint64_t total = 0;
+    for (uint64_t bucket : latency_buckets) {
+        total += bucket;
+    }
+    return total;
+}
+
+uint64_t Snapshot::LatencyQuantileNs(double quantile) const noexcept {
+    const uint64_t total = latency_count();
+    if (total == 0) {
+        return 0;
+    }
+    const auto rank = static_cast<uint64_t>(quantile * static_cast<double>(total - 1));
+    uint64_t seen = 0;
+    for (size_t bucket = 0; bucket < kLatencyBucketCount; ++bucket) {
+        seen += latency_buckets[bucket];
+        if (seen > rank) {
+            return uint64_t{2} << bucket;
+        }
+    }
+    return uint64_t{2} << (kLatencyBucketCount - 1);
+}
+
+Snapshot operator-(const Snapshot& later, const Snapshot& earlier) noexcept {
+    Snapshot difference;
+    for (size_t i = 0; i < kCounterCount; ++i) {
+        difference.counters[i] = later.counters[i] - earlier.counters[i];
+    }
+    for (size_t i = 0; i < kLatencyBucketCount; ++i) {
+        difference.latency_buckets[i] = later.latency_buckets[i] - earlier.latency_buckets[i];
+    }
+    return difference;
+}
+
+Snapshot TakeSnapshot() {
+    Snapshot snapshot;
+    for (ThreadCounters* block = thread_counters.load(std::memory_order_acquire); block; block = block->next) {
+        for (size_t i = 0; i < kCounterCount; ++i) {
+            snapshot.counters[i] += block->counters[i].load(std::memory_order_relaxed);
+        }
+        for (size_t i = 0; i < kLatencyBucketCount; ++i) {
+            snapshot.latency_buckets[i] += block->latency_buckets[i].load(std::memory_order_relaxed);
+        }
+    }
+    return snapshot;
+}
+
+ThreadCounters* AcquireThreadCounters() {
+    for (ThreadCounters* block = thread_counters.load(std::memory_order_acquire); block; block = block->next) {
+        bool in_use = false;
+        if (block->in_use.compare_exchange_strong(in_use, true, std::memory_order_acquire)) {
+            return block;
+        }
+    }
+    auto* block = new ThreadCounters;
+    block->in_use.store(true, std::memory_order_relaxed);
+    block->next = thread_counters.load(std::memory_order_relaxed);
+    while (!thread_counters.compare_exchange_weak(block->next, block, std::memory_order_release,
+                                                  std::memory_order_relaxed)) {
+    }
+    return block;
+}
+
+void ReleaseThreadCounters(ThreadCounters* counters) noexcept {
+    counters->in_use.store(false, std::memory_order_release);
+}
+
+}  // namespace winding_number::instrumentation
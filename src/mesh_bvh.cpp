@@ -0,0 +1,293 @@
+#include <mesh_bvh.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+#include <instrumentation.hpp>
+#include <parallel.hpp>
+
+namespace winding_number {
+namespace {
+
+    // Triangles per leaf: below this, summing them exactly costs less than descending further.
+    constexpr uint32_t kLeafSize = 8;
+
+    constexpr double kPi = 3.14159265358979323846;
+    constexpr double kFourPi = 4.0 * kPi;
+
+    double Dot(const double u[3], const double v[3]) {
+        return u[0] * v[0] + u[1] * v[1] + u[2] * v[2];
+    }
+
+    void Cross(const double u[3], const double v[3], double out[3]) {
+        out[0] = u[1] * v[2] - u[2] * v[1];
+        out[1] = u[2] * v[0] - u[0] * v[2];
+        out[2] = u[0] * v[1] - u[1] * v[0];
+    }
+
+    // The signed solid angle of the triangle (a, b, c) seen from the origin (Van Oosterom and Strackee 1983). It is
+    // positive when the origin is behind the triangle, as the inside of a closed mesh is behind all of them.
+    double SolidAngle(const double a[3], const double b[3], const double c[3]) {
+        double b_cross_c[3];
+        Cross(b, c, b_cross_c);
+        const double la = std::sqrt(Dot(a, a)), lb = std::sqrt(Dot(b, b)), lc = std::sqrt(Dot(c, c));
+        const double denominator = la * lb * lc + Dot(a, b) * lc + Dot(a, c) * lb + Dot(b, c) * la;
+        return 2.0 * std::atan2(Dot(a, b_cross_c), denominator);
+    }
+
+}  // namespace
+
+MeshBvh::MeshBvh(const poly::TriangleMesh& mesh) {
+    std::vector<Triangle> triangles(mesh.triangle_count());
+    for (size_t t = 0; t < triangles.size(); ++t) {
+        double* corners[3] = {triangles[t].a, triangles[t].b, triangles[t].c};
+        for (size_t k = 0; k < 3; ++k) {
+            const uint32_t vertex = mesh.triangles_[3 * t + k];
+            corners[k][0] = mesh.x_vec_[vertex];
+            corners[k][1] = mesh.y_vec_[vertex];
+            corners[k][2] = mesh.z_vec_[vertex];
+        }
+    }
+    if (triangles.empty()) {
+        return;
+    }
+    std::vector<uint32_t> order(triangles.size());
+    for (uint32_t t = 0; t < order.size(); ++t) {
+        order[t] = t;
+    }
+    Build(order, triangles, 0, uint32_t(triangles.size()));
+    triangles_.reserve(triangles.size());
+    for (uint32_t t : order) {
+        triangles_.push_back(triangles[t]);
+    }
+}
+
+uint32_t MeshBvh::Build(std::vector<uint32_t>& order, const std::vector<Triangle>& triangles, uint32_t first,
+                        uint32_t count) {
+    const auto index = uint32_t(nodes_.size());
+    nodes_.emplace_back();
+    Node node{};
+    node.first = first;
+    node.count = count;
+
+    // The center is the area weighted centroid, where the expansion is most accurate.
+    double weighted_centroid[3] = {0, 0, 0};
+    double mean_centroid[3] = {0, 0, 0};
+    double low[3] = {HUGE_VAL, HUGE_VAL, HUGE_VAL};
+    double high[3] = {-HUGE_VAL, -HUGE_VAL, -HUGE_VAL};
+    std::vector<double> centroids(3 * size_t(count));
+    std::vector<double> area_vectors(3 * size_t(count));
+    for (uint32_t k = 0; k < count; ++k) {
+        const Triangle& triangle = triangles[order[first + k]];
+        double ab[3], ac[3];
+        for (size_t i = 0; i < 3; ++i) {
+            ab[i] = triangle.b[i] - triangle.a[i];
+            ac[i] = triangle.c[i] - triangle.a[i];
+        }
+        double* area_vector = &area_vectors[3 * k];
+        Cross(ab, ac, area_vector);
+        for (size_t i = 0; i < 3; ++i) {
+            area_vector[i] *= 0.5;
+        }
+        const double area = std::sqrt(Dot(area_vector, area_vector));
+        node.area += area;
+        for (size_t i = 0; i < 3; ++i) {
+            const double centroid = (triangle.a[i] + triangle.b[i] + triangle.c[i]) / 3.0;
+            centroids[3 * k + i] = centroid;
+            weighted_centroid[i] += area * centroid;
+            mean_centroid[i] += centroid / count;
+            node.area_vector[i] += area_vector[i];
+            low[i] = std::min(low[i], centroid);
+            high[i] = std::max(high[i], centroid);
+        }
+    }
+    for (size_t i = 0; i < 3; ++i) {
+        node.center[i] = node.area > 0 ? weighted_centroid[i] / node.area : mean_centroid[i];
+    }
+    for (uint32_t k = 0; k < count; ++k) {
+        const Triangle& triangle = triangles[order[first + k]];
+        for (const double* corner : {triangle.a, triangle.b, triangle.c}) {
+            double offset[3];
+            for (size_t i = 0; i < 3; ++i) {
+                offset[i] = corner[i] - node.center[i];
+            }
+            node.radius = std::max(node.radius, std::sqrt(Dot(offset, offset)));
+        }
+        // Over a triangle with corners q1, q2, q3 about the center and centroid m, the integral of q q^T is
+        // A (q1 q1^T + q2 q2^T + q3 q3^T + 9 m m^T) / 12.
+        double corners[3][3], m[3];
+        for (size_t i = 0; i < 3; ++i) {
+            corners[0][i] = triangle.a[i] - node.center[i];
+            corners[1][i] = triangle.b[i] - node.center[i];
+            corners[2][i] = triangle.c[i] - node.center[i];
+            m[i] = centroids[3 * k + i] - node.center[i];
+        }
+        double square[9];
+        for (size_t j = 0; j < 3; ++j) {
+            for (size_t l = 0; l < 3; ++l) {
+                square[3 * j + l] = (corners[0][j] * corners[0][l] + corners[1][j] * corners[1][l] +
+                                     corners[2][j] * corners[2][l] + 9.0 * m[j] * m[l]) /
+                                    12.0;
+            }
+        }
+        for (size_t i = 0; i < 3; ++i) {
+            const double n = area_vectors[3 * k + i];
+            for (size_t j = 0; j < 3; ++j) {
+                node.moment[3 * i + j] += n * m[j];
+                for (size_t l = 0; l < 3; ++l) {
+                    node.second_moment[9 * i + 3 * j + l] += n * square[3 * j + l];
+                }
+            }
+        }
+    }
+
+    if (count > kLeafSize) {
+        // Split at the median centroid along the axis where the centroids spread the most.
+        size_t axis = 0;
+        for (size_t i = 1; i < 3; ++i) {
+            if (high[i] - low[i] > high[axis] - low[axis]) {
+                axis = i;
+            }
+        }
+        auto centroid = [&triangles, axis](uint32_t t) {
+            return triangles[t].a[axis] + triangles[t].b[axis] + triangles[t].c[axis];
+        };
+        const uint32_t half = count / 2;
+        std::nth_element(order.begin() + first, order.begin() + first + half, order.begin() + first + count,
+                         [&centroid](uint32_t s, uint32_t t) { return centroid(s) < centroid(t); });
+        Build(order, triangles, first, half);
+        node.second_child = Build(order, triangles, first + half, count - half);
+    }
+    nodes_[index] = node;
+    return index;
+}
+
+double MeshBvh::SumTriangles(const double p[3], uint32_t first, uint32_t count) const {
+    double sum = 0.0;
+    for (uint32_t t = first; t < first + count; ++t) {
+        const Triangle& triangle = triangles_[t];
+        double a[3], b[3], c[3];
+        for (size_t i = 0; i < 3; ++i) {
+            a[i] = triangle.a[i] - p[i];
+            b[i] = triangle.b[i] - p[i];
+            c[i] = triangle.c[i] - p[i];
+        }
+        sum += SolidAngle(a, b, c);
+    }
+    return sum;
+}
+
+double MeshBvh::CalculateWindingNumber3D(float x, float y, float z) const {
+    WINDING_TIME_CALL();
+    WINDING_COUNT(kCalls, 1);
+    WINDING_COUNT(kVertices, triangles_.size());
+    const double p[3] = {x, y, z};
+    return SumTriangles(p, 0, uint32_t(triangles_.size())) / kFourPi;
+}
+
+ApproximateWindingNumber MeshBvh::CalculateApproximateWindingNumber3D(float x, float y, float z,
+                                                                      double tolerance) const {
+    WINDING_TIME_CALL();
+    WINDING_COUNT(kCalls, 1);
+    ApproximateWindingNumber result;
+    if (nodes_.empty()) {
+        return result;
+    }
+    const double p[3] = {x, y, z};
+    // In units of solid angle, per unit of triangle area.
+    const double total_area = nodes_[0].area;
+    const double budget = tolerance * kFourPi;
+    double sum = 0.0;
+    double bound = 0.0;
+    size_t visited = 0;
+    // Median splits keep the depth within 32 for any triangle count a uint32_t can index, and the stack never holds
+    // more than one node per level.
+    uint32_t stack[64];
+    size_t depth = 0;
+    stack[depth++] = 0;
+    while (depth > 0) {
+        const uint32_t index = stack[--depth];
+        const Node& node = nodes_[index];
+        double offset[3];
+        for (size_t i = 0; i < 3; ++i) {
+            offset[i] = node.center[i] - p[i];
+        }
+        const double distance = std::sqrt(Dot(offset, offset));
+        const double gap = distance - node.radius;
+        const double remainder = gap > 0 ? 4.0 * node.area * node.radius * node.radius * node.radius /
+                                                   (gap * gap * gap * gap * gap)
+                                         : HUGE_VAL;
+        if (remainder * total_area <= budget * node.area) {
+            // With F(y) = y / |y|^3, the solid angle of the node's triangles is about
+            //     F . area_vector + dF_ij moment_ij + 1/2 ddF_ijk second_moment_ijk
+            // at y = offset, where dF_ij = delta_ij / |y|^3 - 3 y_i y_j / |y|^5 and
+            // ddF_ijk = -3 (delta_ij y_k + delta_ik y_j + delta_jk y_i) / |y|^5 + 15 y_i y_j y_k / |y|^7.
+            double moment_yy = 0.0;
+            double second_yyy = 0.0;
+            double second_traces = 0.0;
+            for (size_t i = 0; i < 3; ++i) {
+                for (size_t j = 0; j < 3; ++j) {
+                    moment_yy += offset[i] * node.moment[3 * i + j] * offset[j];
+                    // second_moment is symmetric in its last two indices, so the first two delta terms are equal.
+                    second_traces += (2.0 * node.second_moment[9 * i + 3 * i + j] +
+                                      node.second_moment[9 * j + 3 * i + i]) *
+                                     offset[j];
+                    for (size_t k = 0; k < 3; ++k) {
+                        second_yyy += node.second_moment[9 * i + 3 * j + k] * offset[i] * offset[j] * offset[k];
+                    }
+                }
+            }
+            const double moment_trace = node.moment[0] + node.moment[4] + node.moment[8];
+            const double inverse_square = 1.0 / (distance * distance);
+            const double inverse_cube = inverse_square / distance;
+            const double inverse_fifth = inverse_cube * inverse_square;
+            sum += (Dot(offset, node.area_vector) + moment_trace) * inverse_cube - 3.0 * moment_yy * inverse_fifth -
+                   1.5 * second_traces * inverse_fifth + 7.5 * second_yyy * inverse_fifth * inverse_square;
+            bound += remainder;
+            ++visited;
+        } else if (node.second_child == 0) {
+            sum += SumTriangles(p, node.first, node.count);
+            visited += node.count;
+        } else {
+            stack[depth++] = node.second_child;
+            stack[depth++] = index + 1;
+        }
+    }
+    WINDING_COUNT(kVertices, visited);
+    result.winding_number = sum / kFourPi;
+    result.error_bound = bound / kFourPi;
+    return result;
+}
+
+std::vector<double> MeshBvh::CalculateWindingNumbers3D(const std::vector<poly::Point3D>& points,
+                                                       size_t thread_count) const {
+    std::vector<double> winding_numbers(points.size());
+    ParallelFor(
+            points.size(),
+            [&](size_t i) { winding_numbers[i] = CalculateWindingNumber3D(points[i].x, points[i].y, points[i].z); },
+            thread_count);
+    return winding_numbers;
+}
+
+std::vector<ApproximateWindingNumber> MeshBvh::CalculateApproximateWindingNumbers3D(
+        const std::vector<poly::Point3D>& points, double tolerance, size_t thread_count) const {
+    std::vector<ApproximateWindingNumber> winding_numbers(points.size());
+    ParallelFor(
+            points.size(),
+            [&](size_t i) {
+                winding_numbers[i] =
+                        CalculateApproximateWindingNumber3D(points[i].x, points[i].y, points[i].z, tolerance);
+            },
+            thread_count);
+    return winding_numbers;
+}
+
+size_t MeshBvh::triangle_count() const noexcept {
+    return triangles_.size();
+}
+
+size_t MeshBvh::node_count() const noexcept {
+    return nodes_.size();
+}
+
+}  // namespace winding_number
@@ -0,0 +1,323 @@
+#include <planar_subdivision.hpp>
+
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <tuple>
+#include <utility>
+
+#include <exact_predicates.hpp>
+#include <instrumentation.hpp>
+#include <parallel.hpp>
+
+namespace winding_number {
+namespace {
+
+    // Seeds the order edges are inserted in. Any order gives the same answers; a random one keeps the DAG shallow.
+    constexpr uint32_t kInsertionSeed = 49;
+
+    // A side of an edge that a polygon lies on.
+    struct Claim {
+        uint32_t p, q;
+        uint32_t polygon;
+        bool left;
+    };
+
+}  // namespace
+
+PlanarSubdivision::PlanarSubdivision(const std::vector<poly::Polygon>& polygons, float tolerance) {
+    // The last point of each polygon is taken to be its first, so that a polygon closed up to tolerance shares its
+    // closing vertex with its neighbours.
+    std::vector<std::pair<float, float>> vertices;  // y, x
+    for (size_t k = 0; k < polygons.size(); ++k) {
+        const poly::Polygon& polygon = polygons[k];
+        if (polygon.size() == 0 || !polygon.IsClosed(tolerance)) {
+            Fail("polygon " + std::to_string(k) + " is not closed");
+            return;
+        }
+        for (size_t i = 0; i + 1 < polygon.size(); ++i) {
+            vertices.emplace_back(polygon.y_vec_[i], polygon.x_vec_[i]);
+        }
+    }
+    std::sort(vertices.begin(), vertices.end());
+    vertices.erase(std::unique(vertices.begin(), vertices.end()), vertices.end());
+    for (const auto& [y, x] : vertices) {
+        x_vec_.push_back(x);
+        y_vec_.push_back(y);
+    }
+
+    // Each polygon lies left of its edges if it runs counter-clockwise, and right of them otherwise.
+    std::vector<Claim> claims;
+    for (size_t k = 0; k < polygons.size(); ++k) {
+        const poly::Polygon& polygon = polygons[k];
+        const size_t edge_count = polygon.size() - 1;
+        auto vertex = [&](size_t i) {
+            i = i == edge_count ? 0 : i;
+            const auto key = std::make_pair(polygon.y_vec_[i], polygon.x_vec_[i]);
+            return static_cast<uint32_t>(std::lower_bound(vertices.begin(), vertices.end(), key) - vertices.begin());
+        };
+        double twice_area = 0;
+        for (size_t i = 0; i < edge_count; ++i) {
+            const size_t j = i + 1 == edge_count ? 0 : i + 1;
+            twice_area += double(polygon.x_vec_[i]) * polygon.y_vec_[j] - double(polygon.x_vec_[j]) * polygon.y_vec_[i];
+        }
+        if (twice_area == 0) {
+            Fail("polygon " + std::to_string(k) + " has no area");
+            return;
+        }
+        for (size_t i = 0; i < edge_count; ++i) {
+            const uint32_t u = vertex(i), v = vertex(i + 1);
+            if (u != v) {
+                const bool left = (u < v) == (twice_area > 0);
+                claims.push_back({std::min(u, v), std::max(u, v), static_cast<uint32_t>(k), left});
+            }
+        }
+    }
+
+    // Shared edges become one segment, with a polygon on each side.
+    std::sort(claims.begin(), claims.end(),
+              [](const Claim& a, const Claim& b) { return std::tie(a.p, a.q) < std::tie(b.p, b.q); });
+    for (const Claim& claim : claims) {
+        if (segments_.empty() || segments_.back().p != claim.p || segments_.back().q != claim.q) {
+            segments_.push_back({claim.p, claim.q});
+        }
+        uint32_t& side = claim.left ? segments_.back().left_polygon : segments_.back().right_polygon;
+        if (side != kNone && side != claim.polygon) {
+            Fail("polygons " + std::to_string(side) + " and " + std::to_string(claim.polygon) +
+                 " are on the same side of an edge");
+            return;
+        }
+        side = claim.polygon;
+    }
+
+    std::vector<uint32_t> order(segments_.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::shuffle(order.begin(), order.end(), std::mt19937(kInsertionSeed));
+    AddTrapezoid(kNone, kNone, kNone, kNone);
+    for (uint32_t s : order) {
+        Insert(s);
+        if (!valid_) {
+            return;
+        }
+    }
+    LabelTrapezoids();
+}
+
+int PlanarSubdivision::Side(const Segment& segment, uint32_t vertex) const {
+    return ExactEdgeSide(x_vec_[segment.p], y_vec_[segment.p], x_vec_[segment.q], y_vec_[segment.q], x_vec_[vertex],
+                         y_vec_[vertex]);
+}
+
+bool PlanarSubdivision::Interfere(const Segment& a, const Segment& b) const {
+    const int a_p = Side(b, a.p), a_q = Side(b, a.q), b_p = Side(a, b.p), b_q = Side(a, b.q);
+    if (a_p * a_q < 0 && b_p * b_q < 0) {
+        return true;
+    }
+    // A vertex of one on the other, other than at its ends. That includes collinear edges that overlap.
+    auto inside = [](int side, uint32_t vertex, const Segment& segment) {
+        return side == 0 && segment.p < vertex && vertex < segment.q;
+    };
+    return inside(a_p, a.p, b) || inside(a_q, a.q, b) || inside(b_p, b.p, a) || inside(b_q, b.q, a);
+}
+
+bool PlanarSubdivision::RightOf(uint32_t s, uint32_t t) {
+    // Both cross the line just above some vertex. Whichever starts later starts within the other's range, so its side
+    // of the other settles the order; if they start together, the side of the end of s does.
+    const Segment& a = segments_[s];
+    const Segment& b = segments_[t];
+    if (a.p >= b.p) {
+        int side = Side(b, a.p);
+        if (side == 0 && a.p == b.p) {
+            side = Side(b, a.q);
+        }
+        if (side == 0) {
+            Fail("edges overlap or meet away from their ends at (" + std::to_string(x_vec_[a.p]) + ", " +
+                 std::to_string(y_vec_[a.p]) + ")");
+        }
+        return side < 0;
+    }
+    const int side = Side(a, b.p);
+    if (side == 0) {
+        Fail("edges meet away from their ends at (" + std::to_string(x_vec_[b.p]) + ", " + std::to_string(y_vec_[b.p]) +
+             ")");
+    }
+    return side > 0;
+}
+
+uint32_t PlanarSubdivision::LocateSegment(uint32_t s, uint32_t vertex) {
+    uint32_t n = 0;
+    while (nodes_[n].kind != Node::kLeaf) {
+        const Node& node = nodes_[n];
+        const bool high = node.kind == Node::kVertex ? vertex >= node.index : RightOf(s, node.index);
+        n = high ? node.high : node.low;
+    }
+    return nodes_[n].index;
+}
+
+uint32_t PlanarSubdivision::AddTrapezoid(uint32_t left_edge, uint32_t right_edge, uint32_t bottom_vertex,
+                                         uint32_t top_vertex) {
+    const auto index = static_cast<uint32_t>(trapezoids_.size());
+    const uint32_t node = AddNode({Node::kLeaf, index});
+    trapezoids_.push_back({left_edge, right_edge, bottom_vertex, top_vertex, node});
+    return index;
+}
+
+uint32_t PlanarSubdivision::AddNode(Node node) {
+    nodes_.push_back(node);
+    return static_cast<uint32_t>(nodes_.size() - 1);
+}
+
+void PlanarSubdivision::Insert(uint32_t s) {
+    const Segment segment = segments_[s];
+
+    // The trapezoids the edge passes through, bottom to top: each one after the first is found just above the wall
+    // that ends the one before.
+    crossed_.clear();
+    crossed_.push_back(LocateSegment(s, segment.p));
+    while (valid_ && trapezoids_[crossed_.back()].top_vertex < segment.q) {
+        crossed_.push_back(LocateSegment(s, trapezoids_[crossed_.back()].top_vertex));
+    }
+    if (!valid_) {
+        return;
+    }
+    // An edge that crosses another first does so inside a trapezoid the other bounds.
+    for (uint32_t t : crossed_) {
+        for (uint32_t other : {trapezoids_[t].left_edge, trapezoids_[t].right_edge}) {
+            if (other != kNone && Interfere(segment, segments_[other])) {
+                Fail("edges cross or meet away from their ends near (" + std::to_string(x_vec_[segment.p]) + ", " +
+                     std::to_string(y_vec_[segment.p]) + ")");
+                return;
+            }
+        }
+    }
+
+    // The first and last trapezoids keep their parts below and above the edge's ends. In between, the edge splits
+    // the trapezoids into parts left and right of it, and the walls on one side of it go: parts on that side merge.
+    const Trapezoid first = trapezoids_[crossed_.front()], last = trapezoids_[crossed_.back()];
+    const uint32_t below =
+            first.bottom_vertex != segment.p ? AddTrapezoid(first.left_edge, first.right_edge, first.bottom_vertex,
+                                                            segment.p)
+                                             : kNone;
+    const uint32_t above = last.top_vertex != segment.q
+                                   ? AddTrapezoid(last.left_edge, last.right_edge, segment.q, last.top_vertex)
+                                   : kNone;
+    uint32_t left = AddTrapezoid(first.left_edge, s, segment.p, segment.q);
+    uint32_t right = AddTrapezoid(s, first.right_edge, segment.p, segment.q);
+    for (size_t j = 0; j < crossed_.size(); ++j) {
+        const Trapezoid old = trapezoids_[crossed_[j]];
+        Node replacement{Node::kEdge, s, trapezoids_[left].node, trapezoids_[right].node};
+        if (j + 1 == crossed_.size() && above != kNone) {
+            replacement = Node{Node::kVertex, segment.q, AddNode(replacement), trapezoids_[above].node};
+        }
+        if (j == 0 && below != kNone) {
+            replacement = Node{Node::kVertex, segment.p, trapezoids_[below].node, AddNode(replacement)};
+        }
+        nodes_[old.node] = replacement;
+
+        if (j + 1 < crossed_.size()) {
+            const uint32_t wall = old.top_vertex;
+            const Trapezoid next = trapezoids_[crossed_[j + 1]];
+            const int side = Side(segment, wall);
+            if (side == 0) {
+                Fail("a vertex lies on an edge at (" + std::to_string(x_vec_[wall]) + ", " +
+                     std::to_string(y_vec_[wall]) + ")");
+                return;
+            }
+            if (side < 0) {
+                trapezoids_[right].top_vertex = wall;
+                right = AddTrapezoid(s, next.right_edge, wall, segment.q);
+            } else {
+                trapezoids_[left].top_vertex = wall;
+                left = AddTrapezoid(next.left_edge, s, wall, segment.q);
+            }
+        }
+    }
+}
+
+void PlanarSubdivision::LabelTrapezoids() {
+    // A trapezoid lies in the polygon left of its right edge, which must also be right of its left edge.
+    for (Node& node : nodes_) {
+        if (node.kind != Node::kLeaf) {
+            continue;
+        }
+        const Trapezoid& trapezoid = trapezoids_[node.index];
+        const uint32_t polygon =
+                trapezoid.right_edge == kNone ? kNone : segments_[trapezoid.right_edge].left_polygon;
+        const uint32_t check = trapezoid.left_edge == kNone ? kNone : segments_[trapezoid.left_edge].right_polygon;
+        if (polygon != check) {
+            const Segment& edge = segments_[trapezoid.right_edge == kNone ? trapezoid.left_edge : trapezoid.right_edge];
+            Fail("polygons overlap, or leave a hole with no boundary of its own, near (" +
+                 std::to_string(x_vec_[edge.p]) + ", " + std::to_string(y_vec_[edge.p]) + ")");
+            return;
+        }
+        node.index = polygon;
+        ++trapezoid_count_;
+    }
+    trapezoids_ = {};
+    crossed_ = {};
+}
+
+void PlanarSubdivision::Fail(std::string error_message) {
+    if (valid_) {
+        valid_ = false;
+        error_message_ = std::move(error_message);
+    }
+}
+
+std::optional<size_t> PlanarSubdivision::FindPolygon(float x, float y) const {
+    if (!valid_) {
+        return std::nullopt;
+    }
+    WINDING_COUNT(kCalls, 1);
+    uint32_t n = 0;
+    while (nodes_[n].kind != Node::kLeaf) {
+        const Node& node = nodes_[n];
+        bool high;
+        if (node.kind == Node::kVertex) {
+            const float vertex_x = x_vec_[node.index], vertex_y = y_vec_[node.index];
+            high = y > vertex_y || (y == vertex_y && x >= vertex_x);
+        } else {
+            const Segment& edge = segments_[node.index];
+            const int side = ExactEdgeSide(x_vec_[edge.p], y_vec_[edge.p], x_vec_[edge.q], y_vec_[edge.q], x, y);
+            // On the edge, moving right puts the point right of it -- unless the edge is horizontal, and moving up
+            // puts the point left of it.
+            high = side < 0 || (side == 0 && y_vec_[edge.p] != y_vec_[edge.q]);
+        }
+        n = high ? node.high : node.low;
+    }
+    if (nodes_[n].index == kNone) {
+        return std::nullopt;
+    }
+    return nodes_[n].index;
+}
+
+std::vector<std::optional<size_t>> PlanarSubdivision::FindPolygons(const poly::PointBatch& points,
+                                                                   size_t thread_count) const {
+    std::vector<std::optional<size_t>> polygons(points.size());
+    ParallelFor(
+            points.size(), [&](size_t i) { polygons[i] = FindPolygon(points.x_vec_[i], points.y_vec_[i]); },
+            thread_count);
+    return polygons;
+}
+
+bool PlanarSubdivision::valid() const noexcept {
+    return valid_;
+}
+
+const std::string& PlanarSubdivision::error_message() const noexcept {
+    return error_message_;
+}
+
+size_t PlanarSubdivision::edge_count() const noexcept {
+    return segments_.size();
+}
+
+size_t PlanarSubdivision::trapezoid_count() const noexcept {
+    return trapezoid_count_;
+}
+
+size_t PlanarSubdivision::node_count() const noexcept {
+    return nodes_.size();
+}
+
+}  // namespace winding_number
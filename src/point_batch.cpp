@@ -0,0 +1,103 @@
+#include <point_batch.hpp>
+
+#include <cassert>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#    include <emmintrin.h>
+#    define POINT_BATCH_SSE2 1
+#endif
+
+namespace poly {
+namespace {
+
+    // Splits `count` interleaved points into the x and y arrays, four points per iteration.
+    void Deinterleave(const float* xy, size_t count, float* x, float* y) {
+        size_t i = 0;
+#if POINT_BATCH_SSE2
+        for (; i + 4 <= count; i += 4) {
+            __m128 lo = _mm_loadu_ps(xy + 2 * i);      // x0 y0 x1 y1
+            __m128 hi = _mm_loadu_ps(xy + 2 * i + 4);  // x2 y2 x3 y3
+            _mm_storeu_ps(x + i, _mm_shuffle_ps(lo, hi, _MM_SHUFFLE(2, 0, 2, 0)));
+            _mm_storeu_ps(y + i, _mm_shuffle_ps(lo, hi, _MM_SHUFFLE(3, 1, 3, 1)));
+        }
+#endif
+        for (; i < count; ++i) {
+            x[i] = xy[2 * i];
+            y[i] = xy[2 * i + 1];
+        }
+    }
+
+    // The inverse of Deinterleave().
+    void Interleave(const float* x, const float* y, size_t count, float* xy) {
+        size_t i = 0;
+#if POINT_BATCH_SSE2
+        for (; i + 4 <= count; i += 4) {
+            __m128 xs = _mm_loadu_ps(x + i);
+            __m128 ys = _mm_loadu_ps(y + i);
+            _mm_storeu_ps(xy + 2 * i, _mm_unpacklo_ps(xs, ys));
+            _mm_storeu_ps(xy + 2 * i + 4, _mm_unpackhi_ps(xs, ys));
+        }
+#endif
+        for (; i < count; ++i) {
+            xy[2 * i] = x[i];
+            xy[2 * i + 1] = y[i];
+        }
+    }
+
+}  // namespace
+
+PointBatch::PointBatch(size_t capacity) {
+    reserve(capacity);
+}
+
+PointBatch PointBatch::FromInterleaved(const float* xy, size_t count) {
+    PointBatch batch;
+    batch.AppendInterleaved(xy, count);
+    return batch;
+}
+
+PointBatch PointBatch::FromPoints(const std::vector<Point2D>& points) {
+    return FromInterleaved(reinterpret_cast<const float*>(points.data()), points.size());
+}
+
+PointBatch PointBatch::FromRecords(const std::vector<std::tuple<float, float, Polygon>>& records) {
+    PointBatch batch(records.size());
+    for (const auto& record : records) {
+        batch.AppendPoint(std::get<0>(record), std::get<1>(record));
+    }
+    return batch;
+}
+
+void PointBatch::AppendPoint(float x, float y) {
+    x_vec_.push_back(x);
+    y_vec_.push_back(y);
+}
+
+void PointBatch::AppendInterleaved(const float* xy, size_t count) {
+    size_t offset = size();
+    x_vec_.resize(offset + count);
+    y_vec_.resize(offset + count);
+    Deinterleave(xy, count, x_vec_.data() + offset, y_vec_.data() + offset);
+}
+
+size_t PointBatch::size() const {
+    size_t x_vec_size = x_vec_.size();
+    assert(x_vec_size == y_vec_.size());
+    return x_vec_size;
+}
+
+void PointBatch::reserve(size_t capacity) {
+    x_vec_.reserve(capacity);
+    y_vec_.reserve(capacity);
+}
+
+void PointBatch::clear() {
+    x_vec_.clear();
+    y_vec_.clear();
+}
+
+void PointBatch::CopyToInterleaved(float* xy) const {
+    Interleave(x_vec_.data(), y_vec_.data(), size(), xy);
+}
+
+}  // namespace poly
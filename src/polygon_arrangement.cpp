@@ -0,0 +1,269 @@
+#include <polygon_arrangement.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <limits>
+#include <tuple>
+
+#include <exact_predicates.hpp>
+#include <instrumentation.hpp>
+
+namespace winding_number {
+namespace {
+
+    // Bound on the relative rounding error of each step in placing a crossing: a few units in the last place of a
+    // double, with room to spare.
+    constexpr double kCrossingRoundoff = 1e-15;
+
+}  // namespace
+
+PolygonArrangement::PolygonArrangement(const poly::Polygon& polygon, float tolerance) :
+        closed_(polygon.size() > 0 && polygon.IsClosed(tolerance)), fallback_(polygon, tolerance) {
+    if (!closed_) {
+        return;
+    }
+    for (size_t i = 0; i + 1 < polygon.size(); ++i) {
+        const float x0 = polygon.x_vec_[i], y0 = polygon.y_vec_[i];
+        const float x1 = polygon.x_vec_[i + 1], y1 = polygon.y_vec_[i + 1];
+        vertices_.emplace_back(x0, y0);
+        if (y0 < y1) {
+            edges_.push_back({x0, y0, x1, y1, 1});
+        } else if (y1 < y0) {
+            edges_.push_back({x1, y1, x0, y0, -1});
+        } else {
+            horizontal_edges_.push_back({y0, {std::min(x0, x1), std::max(x0, x1)}});
+        }
+    }
+    std::sort(vertices_.begin(), vertices_.end());
+    std::sort(horizontal_edges_.begin(), horizontal_edges_.end());
+
+    std::vector<uint32_t> by_start(edges_.size());
+    for (uint32_t e = 0; e < edges_.size(); ++e) {
+        by_start[e] = e;
+        slab_y_.push_back(edges_[e].y0);
+        slab_y_.push_back(edges_[e].y1);
+    }
+    std::sort(by_start.begin(), by_start.end(), [this](uint32_t a, uint32_t b) { return edges_[a].y0 < edges_[b].y0; });
+
+    // Every pair of edges whose y ranges overlap, found by scanning forward from each edge in order of lower ends.
+    size_t pair_tests = 0;
+    for (size_t i = 0; i < by_start.size(); ++i) {
+        const Edge& a = edges_[by_start[i]];
+        for (size_t j = i + 1; j < by_start.size() && edges_[by_start[j]].y0 < a.y1; ++j) {
+            if (++pair_tests > kMaxPairTests) {
+                DropSlabs();
+                return;
+            }
+            const Edge& b = edges_[by_start[j]];
+            if (std::max(std::min(a.x0, a.x1), std::min(b.x0, b.x1)) >
+                std::min(std::max(a.x0, a.x1), std::max(b.x0, b.x1))) {
+                continue;
+            }
+            if (const auto crossing = Crossing(a, b)) {
+                ++crossing_count_;
+                slab_y_.push_back(crossing->first);
+                near_crossings_.emplace_back(crossing->first - crossing->second, crossing->first + crossing->second);
+            }
+        }
+    }
+    std::sort(slab_y_.begin(), slab_y_.end());
+    slab_y_.erase(std::unique(slab_y_.begin(), slab_y_.end()), slab_y_.end());
+    std::sort(near_crossings_.begin(), near_crossings_.end());
+    size_t merged = 0;
+    for (const auto& range : near_crossings_) {
+        if (merged > 0 && range.first <= near_crossings_[merged - 1].second) {
+            near_crossings_[merged - 1].second = std::max(near_crossings_[merged - 1].second, range.second);
+        } else {
+            near_crossings_[merged++] = range;
+        }
+    }
+    near_crossings_.resize(merged);
+
+    // An edge is in every slab from the one at its lower end up to the one at its upper end, both in slab_y_.
+    size_t slab_edge_count = 0;
+    for (const Edge& edge : edges_) {
+        slab_edge_count += std::lower_bound(slab_y_.begin(), slab_y_.end(), double(edge.y1)) -
+                           std::lower_bound(slab_y_.begin(), slab_y_.end(), double(edge.y0));
+    }
+    if (slab_edge_count > kMaxSlabEdges) {
+        DropSlabs();
+        return;
+    }
+    slab_edges_.reserve(slab_edge_count);
+    slab_labels_.reserve(slab_edge_count);
+
+    // Each slab starts from the order of the one below it, less the edges that ended and plus those that start, so an
+    // insertion sort only has to swap the edges that cross in between and place the new ones.
+    std::vector<uint32_t> order;
+    size_t next_start = 0;
+    for (size_t s = 0; s + 1 < slab_y_.size(); ++s) {
+        const double y = slab_y_[s];
+        order.erase(std::remove_if(order.begin(), order.end(), [&](uint32_t e) { return edges_[e].y1 <= y; }),
+                    order.end());
+        for (; next_start < by_start.size() && edges_[by_start[next_start]].y0 <= y; ++next_start) {
+            order.push_back(by_start[next_start]);
+        }
+        for (size_t i = 1; i < order.size(); ++i) {
+            for (size_t j = i; j > 0 && LeftOf(edges_[order[j]], order[j], edges_[order[j - 1]], order[j - 1], y);
+                 --j) {
+                std::swap(order[j], order[j - 1]);
+            }
+        }
+
+        int32_t label = 0;
+        slab_labels_.resize(slab_labels_.size() + order.size());
+        for (size_t i = order.size(); i-- > 0;) {
+            label += edges_[order[i]].direction;
+            slab_labels_[slab_edges_.size() + i] = label;
+        }
+        slab_edges_.insert(slab_edges_.end(), order.begin(), order.end());
+        slab_offsets_.push_back(static_cast<uint32_t>(slab_edges_.size()));
+    }
+}
+
+std::optional<std::pair<double, double>> PolygonArrangement::Crossing(const Edge& a, const Edge& b) {
+    // The y is computed the same way whichever order the edges come in, so that the slabs and LeftOf() agree on it.
+    if (std::tie(b.y0, b.x0, b.y1, b.x1) < std::tie(a.y0, a.x0, a.y1, a.x1)) {
+        return Crossing(b, a);
+    }
+    const int a0 = ExactEdgeSide(b.x0, b.y0, b.x1, b.y1, a.x0, a.y0);
+    const int a1 = ExactEdgeSide(b.x0, b.y0, b.x1, b.y1, a.x1, a.y1);
+    if (a0 * a1 >= 0) {
+        return std::nullopt;
+    }
+    const int b0 = ExactEdgeSide(a.x0, a.y0, a.x1, a.y1, b.x0, b.y0);
+    const int b1 = ExactEdgeSide(a.x0, a.y0, a.x1, a.y1, b.x1, b.y1);
+    if (b0 * b1 >= 0) {
+        return std::nullopt;
+    }
+
+    // a crosses b at a.y0 + t r.y, for t = (w x s) / (r x s) with r and s the edges' directions and w the offset of
+    // b's lower end from a's. The error bound grows as the edges get closer to parallel, when r x s cancels.
+    const double rx = double(a.x1) - a.x0, ry = double(a.y1) - a.y0;
+    const double sx = double(b.x1) - b.x0, sy = double(b.y1) - b.y0;
+    const double wx = double(b.x0) - a.x0, wy = double(b.y0) - a.y0;
+    const double numerator = wx * sy - wy * sx, denominator = rx * sy - ry * sx;
+    const double t = numerator / denominator;
+    const double y = a.y0 + t * ry;
+    const double numerator_size = std::fabs(wx * sy) + std::fabs(wy * sx);
+    const double denominator_size = std::fabs(rx * sy) + std::fabs(ry * sx);
+    const double t_error =
+            kCrossingRoundoff * (numerator_size + std::fabs(t) * denominator_size) / std::fabs(denominator);
+    const double y_error = ry * t_error + kCrossingRoundoff * (std::fabs(a.y0) + std::fabs(y));
+    return std::make_pair(y, y_error);
+}
+
+bool PolygonArrangement::LeftOf(const Edge& a, uint32_t a_index, const Edge& b, uint32_t b_index, double y) {
+    // Below any crossing, whichever edge starts higher has its lower end within the other's y range, so its side of
+    // the other settles the order; if it touches the other there, its upper end does.
+    auto side_of = [](const Edge& edge, const Edge& other) {
+        const int side = ExactEdgeSide(edge.x0, edge.y0, edge.x1, edge.y1, other.x0, other.y0);
+        return side != 0 ? side : ExactEdgeSide(edge.x0, edge.y0, edge.x1, edge.y1, other.x1, other.y1);
+    };
+    int order = a.y0 >= b.y0 ? -side_of(b, a) : side_of(a, b);  // -1 when a is left of b
+    if (order == 0) {
+        return a_index < b_index;
+    }
+    const auto crossing = Crossing(a, b);
+    if (crossing && y >= crossing->first) {
+        order = -order;
+    }
+    return order < 0;
+}
+
+void PolygonArrangement::DropSlabs() {
+    over_budget_ = true;
+    crossing_count_ = 0;
+    // Swapped with empty vectors, so that the memory is given back.
+    std::vector<double>().swap(slab_y_);
+    std::vector<uint32_t>{0}.swap(slab_offsets_);
+    std::vector<uint32_t>().swap(slab_edges_);
+    std::vector<int32_t>().swap(slab_labels_);
+    std::vector<std::pair<double, double>>().swap(near_crossings_);
+    std::vector<Edge>().swap(edges_);
+    std::vector<std::pair<float, float>>().swap(vertices_);
+    std::vector<std::pair<float, std::pair<float, float>>>().swap(horizontal_edges_);
+}
+
+bool PolygonArrangement::OnVertexOrHorizontalEdge(float x, float y) const {
+    if (std::binary_search(vertices_.begin(), vertices_.end(), std::make_pair(x, y))) {
+        return true;
+    }
+    auto it = std::lower_bound(horizontal_edges_.begin(), horizontal_edges_.end(),
+                               std::make_pair(y, std::make_pair(-std::numeric_limits<float>::infinity(), 0.f)));
+    for (; it != horizontal_edges_.end() && it->first == y && it->second.first <= x; ++it) {
+        if (x <= it->second.second) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool PolygonArrangement::NearCrossing(float y) const {
+    const auto after = std::upper_bound(near_crossings_.begin(), near_crossings_.end(), y,
+                                        [](double value, const auto& range) { return value < range.first; });
+    return after != near_crossings_.begin() && y <= std::prev(after)->second;
+}
+
+std::optional<int> PolygonArrangement::CalculateWindingNumber2D(float x, float y) const {
+    if (!closed_) {
+        WINDING_COUNT(kUnclosedPolygons, 1);
+        return std::nullopt;
+    }
+    if (over_budget_) {
+        return fallback_.CalculateWindingNumber2D(x, y);
+    }
+    // Slabs only see the edges that cross them, which misses vertices where the boundary turns back down and
+    // horizontal edges.
+    if (OnVertexOrHorizontalEdge(x, y) || NearCrossing(y)) {
+        return fallback_.CalculateWindingNumber2D(x, y);
+    }
+    const auto above = std::upper_bound(slab_y_.begin(), slab_y_.end(), double(y));
+    if (above == slab_y_.begin() || above == slab_y_.end()) {
+        WINDING_COUNT(kCalls, 1);
+        WINDING_COUNT(kEarlyRejects, 1);
+        return 0;
+    }
+    const size_t slab = above - slab_y_.begin() - 1;
+    const auto first = slab_edges_.begin() + slab_offsets_[slab], last = slab_edges_.begin() + slab_offsets_[slab + 1];
+    auto side = [&](uint32_t e) {
+        const Edge& edge = edges_[e];
+        return ExactEdgeSide(edge.x0, edge.y0, edge.x1, edge.y1, x, y);
+    };
+    // The edges the point is not strictly left of come first.
+    const auto right = std::partition_point(first, last, [&](uint32_t e) { return side(e) <= 0; });
+    if (right != first && side(*std::prev(right)) == 0) {
+        return fallback_.CalculateWindingNumber2D(x, y);
+    }
+    WINDING_COUNT(kCalls, 1);
+    return right == last ? 0 : slab_labels_[right - slab_edges_.begin()];
+}
+
+std::vector<std::optional<int>> PolygonArrangement::CalculateWindingNumbers2D(const poly::PointBatch& points) const {
+    std::vector<std::optional<int>> winding_numbers;
+    winding_numbers.reserve(points.size());
+    for (size_t i = 0; i < points.size(); ++i) {
+        winding_numbers.push_back(CalculateWindingNumber2D(points.x_vec_[i], points.y_vec_[i]));
+    }
+    return winding_numbers;
+}
+
+bool PolygonArrangement::has_slabs() const noexcept {
+    return closed_ && !over_budget_;
+}
+
+size_t PolygonArrangement::crossing_count() const noexcept {
+    return crossing_count_;
+}
+
+size_t PolygonArrangement::slab_count() const noexcept {
+    return slab_offsets_.size() - 1;
+}
+
+size_t PolygonArrangement::trapezoid_count() const noexcept {
+    // Every slab has one more trapezoid than edges, counting the unbounded ones at either end.
+    return slab_edges_.size() + slab_count();
+}
+
+}  // namespace winding_number
@@ -0,0 +1,441 @@
+// polygon_gen writes large, deterministic synthetic datasets of points and polygons in the format that
+// IPolygonReader::ReadPointsAndPolygonsFromFile() reads, for benchmarks and regression tests.
+//
+// Every record is generated on the fly and streamed out, so memory use does not depend on the dataset size. The same
+// seed and options always produce the same bytes.
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+
+namespace {
+
+constexpr double kPi = 3.14159265358979323846;
+
+const char* kUsage =
+        "usage: polygon_gen [options]\n"
+        "  --records N      number of point/polygon records (default 1000)\n"
+        "  --vertices N     vertices per polygon, before closing (default 64)\n"
+        "  --shape S        circle, star, spiral, coastline, boundary, degenerate or mixed (default mixed)\n"
+        "  --loops N        times stars and spirals wind around their center (default 3)\n"
+        "  --hit-ratio F    fraction of points placed where the winding number is non-zero (default 0.5)\n"
+        "  --seed N         random seed (default 1)\n"
+        "  --annotate       precede each record with a '# <shape> <expected winding number>' comment\n"
+        "  --output PATH    file to write to (default stdout)\n";
+
+enum class Shape { kCircle, kStar, kSpiral, kCoastline, kBoundary, kDegenerate, kMixed };
+
+const char* kShapeNames[] = {"circle", "star", "spiral", "coastline", "boundary", "degenerate", "mixed"};
+
+struct Options {
+    uint64_t records = 1000;
+    uint64_t vertices = 64;
+    Shape shape = Shape::kMixed;
+    int loops = 3;
+    double hit_ratio = 0.5;
+    uint64_t seed = 1;
+    bool annotate = false;
+    std::string output;
+};
+
+// A small, fully specified generator (splitmix64), so datasets don't depend on the standard library's distributions.
+class Random {
+public:
+    explicit Random(uint64_t seed) : state_(seed) {}
+
+    uint64_t Next() {
+        uint64_t z = (state_ += 0x9e3779b97f4a7c15ULL);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        return z ^ (z >> 31);
+    }
+
+    // Uniform in [0, 1).
+    double Uniform() {
+        return (Next() >> 11) * (1.0 / 9007199254740992.0);
+    }
+
+    double Uniform(double low, double high) {
+        return low + (high - low) * Uniform();
+    }
+
+    bool Chance(double probability) {
+        return Uniform() < probability;
+    }
+
+private:
+    uint64_t state_;
+};
+
+// Buffered writer that formats floats with std::to_chars, which is exact and much faster than iostreams.
+class Writer {
+public:
+    explicit Writer(std::FILE* file) : file_(file) {}
+    // Callers Flush() when done, to hear about write errors. This only saves what is left when unwinding, and can't
+    // throw from a destructor.
+    ~Writer() {
+        if (size_ > 0) {
+            std::fwrite(buffer_, 1, size_, file_);
+        }
+    }
+
+    void Float(float value) {
+        Reserve(32);
+        if (!line_start_) {
+            buffer_[size_++] = ' ';
+        }
+        size_ = std::to_chars(buffer_ + size_, buffer_ + kCapacity, value).ptr - buffer_;
+        line_start_ = false;
+    }
+
+    void Point(float x, float y) {
+        Float(x);
+        Float(y);
+    }
+
+    void Text(std::string_view text) {
+        Reserve(text.size());
+        std::memcpy(buffer_ + size_, text.data(), text.size());
+        size_ += text.size();
+        line_start_ = false;
+    }
+
+    void EndLine() {
+        Reserve(1);
+        buffer_[size_++] = '\n';
+        line_start_ = true;
+    }
+
+    void Flush() {
+        if (size_ > 0 && std::fwrite(buffer_, 1, size_, file_) != size_) {
+            throw std::runtime_error("Failed to write the dataset.");
+        }
+        size_ = 0;
+    }
+
+private:
+    static constexpr size_t kCapacity = 1 << 16;
+
+    void Reserve(size_t bytes) {
+        if (size_ + bytes > kCapacity) {
+            Flush();
+        }
+    }
+
+    std::FILE* file_;
+    char buffer_[kCapacity];
+    size_t size_ = 0;
+    bool line_start_ = true;
+};
+
+// Writes records one at a time. With --annotate, each record is preceded by the winding number its point is expected
+// to have -- for points on the boundary, the number of times the boundary passes through them.
+class RecordGenerator {
+public:
+    RecordGenerator(const Options& options, Writer& writer) :
+            options_(options), writer_(writer), random_(options.seed) {}
+
+    void Write() {
+        Shape shape = options_.shape;
+        if (shape == Shape::kMixed) {
+            shape = static_cast<Shape>(random_.Next() % static_cast<uint64_t>(Shape::kMixed));
+        }
+        cx_ = static_cast<float>(random_.Uniform(-1000.0, 1000.0));
+        cy_ = static_cast<float>(random_.Uniform(-1000.0, 1000.0));
+        radius_ = random_.Uniform(1.0, 100.0);
+        hit_ = random_.Chance(options_.hit_ratio);
+        reversed_ = random_.Chance(0.5);
+        n_ = std::max<uint64_t>(options_.vertices, 3);
+
+        switch (shape) {
+        case Shape::kCircle:
+            WriteCircle();
+            break;
+        case Shape::kStar:
+            WriteStar();
+            break;
+        case Shape::kSpiral:
+            WriteSpiral();
+            break;
+        case Shape::kCoastline:
+            WriteCoastline();
+            break;
+        case Shape::kBoundary:
+            WriteBoundary();
+            break;
+        case Shape::kDegenerate:
+            WriteDegenerate();
+            break;
+        case Shape::kMixed:
+            break;
+        }
+    }
+
+private:
+    void Annotate(Shape shape, int expected) {
+        if (!options_.annotate) {
+            return;
+        }
+        writer_.Text("# ");
+        writer_.Text(kShapeNames[static_cast<int>(shape)]);
+        writer_.Text(" ");
+        char digits[16];
+        writer_.Text(std::string_view(digits, std::to_chars(digits, digits + sizeof(digits), expected).ptr - digits));
+        writer_.EndLine();
+    }
+
+    // A point at a random angle and a distance from the center in [low, high) times the radius.
+    void WritePointAtDistance(double low, double high) {
+        double angle = random_.Uniform(0.0, 2.0 * kPi);
+        double r = radius_ * random_.Uniform(low, high);
+        writer_.Point(static_cast<float>(cx_ + r * std::cos(angle)), static_cast<float>(cy_ + r * std::sin(angle)));
+    }
+
+    void WriteVertex(double angle, double r) {
+        writer_.Point(static_cast<float>(cx_ + r * std::cos(angle)), static_cast<float>(cy_ + r * std::sin(angle)));
+    }
+
+    // Angle of vertex i of a polygon that goes once around the center, in the record's direction.
+    double Angle(uint64_t i, uint64_t count, double turns = 1.0) const {
+        double angle = 2.0 * kPi * turns * static_cast<double>(i) / static_cast<double>(count);
+        return reversed_ ? -angle : angle;
+    }
+
+    int Signed(int winding_number) const {
+        return reversed_ ? -winding_number : winding_number;
+    }
+
+    void WriteCircle() {
+        Annotate(Shape::kCircle, hit_ ? Signed(1) : 0);
+        // The edges of a circle with n vertices are at least cos(pi / n) of the radius away from its center.
+        if (hit_) {
+            WritePointAtDistance(0.0, 0.9 * std::cos(kPi / n_));
+        } else {
+            WritePointAtDistance(1.1, 2.0);
+        }
+        for (uint64_t i = 0; i < n_; ++i) {
+            WriteVertex(Angle(i, n_), radius_);
+        }
+        WriteVertex(0.0, radius_);
+        writer_.EndLine();
+    }
+
+    // A {n/q} star polygon: n vertices on a circle, joining every q-th one. Its core winds q times.
+    void WriteStar() {
+        uint64_t q = std::max(options_.loops, 1);
+        n_ = std::max(n_, 2 * q + 1);
+        while (std::gcd(n_, q) != 1) {
+            ++n_;
+        }
+        Annotate(Shape::kStar, hit_ ? Signed(static_cast<int>(q)) : 0);
+        if (hit_) {
+            WritePointAtDistance(0.0, 0.9 * std::cos(kPi * q / n_));
+        } else {
+            WritePointAtDistance(1.1, 2.0);
+        }
+        for (uint64_t i = 0; i < n_; ++i) {
+            WriteVertex(Angle(i * q % n_, n_), radius_);
+        }
+        WriteVertex(0.0, radius_);
+        writer_.EndLine();
+    }
+
+    // A spiral going `loops` times around the center and growing from half the radius to the full one, then straight
+    // back to its start. Points inside the innermost loop wind `loops` times.
+    void WriteSpiral() {
+        const int loops = std::max(options_.loops, 1);
+        // Consecutive vertices are less than half a turn apart, so the chords of the inner loop stay around the center.
+        n_ = std::max<uint64_t>(n_, 2 * loops + 2);
+        Annotate(Shape::kSpiral, hit_ ? Signed(loops) : 0);
+        if (hit_) {
+            WritePointAtDistance(0.0, 0.45 * std::cos(kPi * loops / (n_ - 1)));
+        } else {
+            WritePointAtDistance(1.1, 2.0);
+        }
+        for (uint64_t i = 0; i < n_; ++i) {
+            double t = static_cast<double>(i) / static_cast<double>(n_ - 1);
+            WriteVertex(Angle(i, n_ - 1, loops), radius_ * (0.5 + 0.5 * t));
+        }
+        WriteVertex(0.0, radius_ * 0.5);
+        writer_.EndLine();
+    }
+
+    // A random walk of the radius around the center, like a coastline around an island. The walk is pulled back
+    // towards the radius, and kept within [0.5, 1.5] times it, so the polygon stays star-shaped around the center.
+    void WriteCoastline() {
+        Annotate(Shape::kCoastline, hit_ ? Signed(1) : 0);
+        if (hit_) {
+            WritePointAtDistance(0.0, 0.45 * std::cos(kPi / n_));
+        } else {
+            WritePointAtDistance(1.6, 2.0);
+        }
+        double r = 1.0;
+        const double step = 4.0 / std::sqrt(static_cast<double>(n_));
+        const double first_r = r;
+        for (uint64_t i = 0; i < n_; ++i) {
+            WriteVertex(Angle(i, n_), radius_ * r);
+            r += random_.Uniform(-step, step) + 0.05 * (1.0 - r);
+            r = std::min(std::max(r, 0.5), 1.5);
+        }
+        WriteVertex(0.0, radius_ * first_r);
+        writer_.EndLine();
+    }
+
+    // An axis-aligned rectangle with its vertices spread over its four sides. Hits are exactly on a vertex or on an
+    // edge, where the boundary passes through the point once.
+    void WriteBoundary() {
+        const uint64_t per_side = std::max<uint64_t>(n_ / 4, 1);
+        const float left = cx_, bottom = cy_;
+        const float right = static_cast<float>(cx_ + radius_), top = static_cast<float>(cy_ + radius_);
+        auto vertex = [&](uint64_t i) -> std::pair<float, float> {
+            uint64_t side = i / per_side % 4, j = i % per_side;
+            float t = static_cast<float>(j) / per_side;
+            switch (side) {
+            case 0:
+                return {left + (right - left) * t, bottom};
+            case 1:
+                return {right, bottom + (top - bottom) * t};
+            case 2:
+                return {right - (right - left) * t, top};
+            default:
+                return {left, top - (top - bottom) * t};
+            }
+        };
+
+        Annotate(Shape::kBoundary, hit_ ? 1 : 0);
+        if (hit_) {
+            auto [x0, y0] = vertex(random_.Next() % (4 * per_side));
+            if (random_.Chance(0.5)) {
+                writer_.Point(x0, y0);
+            } else if (y0 == bottom || y0 == top) {
+                // A point on a horizontal side is exactly on an edge whatever its x.
+                writer_.Point(static_cast<float>(random_.Uniform(left, right)), y0);
+            } else {
+                writer_.Point(x0, static_cast<float>(random_.Uniform(bottom, top)));
+            }
+        } else {
+            writer_.Point(static_cast<float>(cx_ - random_.Uniform(0.1, 1.0) * radius_),
+                          static_cast<float>(cy_ + random_.Uniform(0.0, 1.0) * radius_));
+        }
+        for (uint64_t k = 0; k < 4 * per_side; ++k) {
+            uint64_t i = reversed_ ? (4 * per_side - k) % (4 * per_side) : k;
+            auto [x, y] = vertex(i);
+            writer_.Point(x, y);
+        }
+        writer_.Point(left, bottom);
+        writer_.EndLine();
+    }
+
+    // A circle where every vertex is followed by a near-duplicate one float step away, like the 1.0000001 records
+    // in test/polygons.txt.
+    void WriteDegenerate() {
+        const uint64_t count = std::max<uint64_t>(n_ / 2, 3);
+        Annotate(Shape::kDegenerate, hit_ ? Signed(1) : 0);
+        if (hit_) {
+            WritePointAtDistance(0.0, 0.9 * std::cos(kPi / count));
+        } else {
+            WritePointAtDistance(1.1, 2.0);
+        }
+        for (uint64_t i = 0; i < count; ++i) {
+            double angle = Angle(i, count);
+            float x = static_cast<float>(cx_ + radius_ * std::cos(angle));
+            float y = static_cast<float>(cy_ + radius_ * std::sin(angle));
+            writer_.Point(x, y);
+            writer_.Point(std::nextafter(x, HUGE_VALF), std::nextafter(y, HUGE_VALF));
+        }
+        WriteVertex(0.0, radius_);
+        writer_.EndLine();
+    }
+
+    const Options& options_;
+    Writer& writer_;
+    Random random_;
+    float cx_ = 0.f, cy_ = 0.f;
+    double radius_ = 1.0;
+    bool hit_ = false;
+    bool reversed_ = false;
+    uint64_t n_ = 0;
+};
+
+Options ParseOptions(int nargs, char* args[]) {
+    Options options;
+    for (int i = 1; i < nargs; ++i) {
+        std::string_view arg = args[i];
+        auto value = [&]() -> std::string {
+            if (i + 1 >= nargs) {
+                throw std::runtime_error("Missing value for " + std::string(arg));
+            }
+            return args[++i];
+        };
+        if (arg == "--records") {
+            options.records = std::stoull(value());
+        } else if (arg == "--vertices") {
+            options.vertices = std::stoull(value());
+        } else if (arg == "--loops") {
+            options.loops = std::stoi(value());
+        } else if (arg == "--hit-ratio") {
+            options.hit_ratio = std::stod(value());
+        } else if (arg == "--seed") {
+            options.seed = std::stoull(value());
+        } else if (arg == "--output") {
+            options.output = value();
+        } else if (arg == "--annotate") {
+            options.annotate = true;
+        } else if (arg == "--shape") {
+            std::string name = value();
+            auto shape = std::find(std::begin(kShapeNames), std::end(kShapeNames), name);
+            if (shape == std::end(kShapeNames)) {
+                throw std::runtime_error("Unknown shape: " + name);
+            }
+            options.shape = static_cast<Shape>(shape - std::begin(kShapeNames));
+        } else {
+            throw std::runtime_error("Unknown option: " + std::string(arg));
+        }
+    }
+    return options;
+}
+
+}  // namespace
+
+int main(int nargs, char* args[]) {
+    Options options;
+    try {
+        options = ParseOptions(nargs, args);
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "%s\n%s", e.what(), kUsage);
+        return 2;
+    }
+
+    std::FILE* file = options.output.empty() ? stdout : std::fopen(options.output.c_str(), "wb");
+    if (file == nullptr) {
+        std::fprintf(stderr, "Could not open %s for writing.\n", options.output.c_str());
+        return 1;
+    }
+    int status = 0;
+    try {
+        Writer writer(file);
+        RecordGenerator generator(options, writer);
+        for (uint64_t i = 0; i < options.records; ++i) {
+            generator.Write();
+        }
+        writer.Flush();
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "%s\n", e.what());
+        status = 1;
+    }
+    // Closed on failure too, so that whatever was written reaches the file.
+    if (file != stdout && std::fclose(file) != 0) {
+        std::fprintf(stderr, "Could not finish writing %s.\n", options.output.c_str());
+        status = 1;
+    }
+    return status;
+}
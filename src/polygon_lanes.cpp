@@ -0,0 +1,207 @@
+#include <polygon_lanes.hpp>
+
+#include <algorithm>
+#include <map>
+
+#include <instrumentation.hpp>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#    include <emmintrin.h>
+#    define POLYGON_LANES_SSE2 1
+#endif
+
+namespace poly {
+
+PolygonLanes::PolygonLanes(const std::vector<Polygon>& polygons, float tolerance) : size_(polygons.size()) {
+    std::map<size_t, std::vector<size_t>> by_edge_count;
+    for (size_t i = 0; i < polygons.size(); ++i) {
+        if (polygons[i].size() > 0 && polygons[i].IsClosed(tolerance)) {
+            by_edge_count[polygons[i].size() - 1].push_back(i);
+        } else {
+            unclosed_.push_back(i);
+        }
+    }
+
+    for (auto& [edge_count, indices] : by_edge_count) {
+        Group group;
+        group.edge_count = edge_count;
+        group.polygons = std::move(indices);
+        const size_t stride = group.block_stride();
+        group.x_vec_.resize(group.block_count() * stride);
+        group.y_vec_.resize(group.block_count() * stride);
+        for (size_t block = 0; block < group.block_count(); ++block) {
+            for (size_t lane = 0; lane < kLaneCount; ++lane) {
+                const size_t slot = block * kLaneCount + lane;
+                const Polygon& polygon =
+                        polygons[group.polygons[slot < group.polygons.size() ? slot : block * kLaneCount]];
+                for (size_t v = 0; v <= edge_count; ++v) {
+                    group.x_vec_[block * stride + v * kLaneCount + lane] = polygon.x_vec_[v];
+                    group.y_vec_[block * stride + v * kLaneCount + lane] = polygon.y_vec_[v];
+                }
+            }
+        }
+        groups_.push_back(std::move(group));
+    }
+}
+
+PolygonLanes PolygonLanes::FromRecords(const std::vector<std::tuple<float, float, Polygon>>& records,
+                                       float tolerance) {
+    std::vector<Polygon> polygons;
+    polygons.reserve(records.size());
+    for (const auto& [x, y, polygon] : records) {
+        polygons.push_back(polygon);
+    }
+    return PolygonLanes(polygons, tolerance);
+}
+
+size_t PolygonLanes::size() const noexcept {
+    return size_;
+}
+
+const std::vector<PolygonLanes::Group>& PolygonLanes::groups() const noexcept {
+    return groups_;
+}
+
+const std::vector<size_t>& PolygonLanes::unclosed() const noexcept {
+    return unclosed_;
+}
+
+size_t PolygonLanes::Group::block_count() const noexcept {
+    return (polygons.size() + kLaneCount - 1) / kLaneCount;
+}
+
+size_t PolygonLanes::Group::block_stride() const noexcept {
+    return (edge_count + 1) * kLaneCount;
+}
+
+}  // namespace poly
+
+namespace winding_number {
+namespace {
+
+    using poly::PolygonLanes;
+
+    // Winding numbers of (x, y) for the kLaneCount polygons of a block, with edge i of each lane running from vertex
+    // i to vertex i + 1.
+    void EvaluateBlock(const float* xs, const float* ys, size_t edge_count, float x, float y,
+                       int (&winding_numbers)[PolygonLanes::kLaneCount]) {
+        constexpr size_t kLanes = PolygonLanes::kLaneCount;
+#if POLYGON_LANES_SSE2
+        constexpr size_t kVectors = kLanes / 4;
+        const __m128 px = _mm_set1_ps(x);
+        const __m128 py = _mm_set1_ps(y);
+        const __m128 zero = _mm_setzero_ps();
+        __m128i winding[kVectors], contacts[kVectors];
+        for (size_t k = 0; k < kVectors; ++k) {
+            winding[k] = _mm_setzero_si128();
+            contacts[k] = _mm_setzero_si128();
+        }
+        for (size_t i = 0; i < edge_count; ++i) {
+            for (size_t k = 0; k < kVectors; ++k) {
+                // The same arithmetic as SimdPolygon's kernel, on one edge of four polygons instead of four edges of
+                // one polygon.
+                const __m128 x0 = _mm_load_ps(xs + i * kLanes + 4 * k);
+                const __m128 y0 = _mm_load_ps(ys + i * kLanes + 4 * k);
+                const __m128 x1 = _mm_load_ps(xs + (i + 1) * kLanes + 4 * k);
+                const __m128 y1 = _mm_load_ps(ys + (i + 1) * kLanes + 4 * k);
+                const __m128 side = _mm_sub_ps(_mm_mul_ps(_mm_sub_ps(x1, x0), _mm_sub_ps(py, y0)),
+                                               _mm_mul_ps(_mm_sub_ps(px, x0), _mm_sub_ps(y1, y0)));
+                const __m128 start_below = _mm_cmple_ps(y0, py);
+                const __m128 end_above = _mm_cmpgt_ps(y1, py);
+                const __m128 up = _mm_and_ps(_mm_and_ps(start_below, end_above), _mm_cmpgt_ps(side, zero));
+                const __m128 down = _mm_andnot_ps(start_below, _mm_andnot_ps(end_above, _mm_cmplt_ps(side, zero)));
+                winding[k] = _mm_add_epi32(_mm_sub_epi32(winding[k], _mm_castps_si128(up)), _mm_castps_si128(down));
+
+                const __m128 in_x =
+                        _mm_and_ps(_mm_cmpge_ps(px, _mm_min_ps(x0, x1)), _mm_cmple_ps(px, _mm_max_ps(x0, x1)));
+                const __m128 in_y =
+                        _mm_and_ps(_mm_cmpge_ps(py, _mm_min_ps(y0, y1)), _mm_cmple_ps(py, _mm_max_ps(y0, y1)));
+                const __m128 at_end = _mm_and_ps(_mm_cmpeq_ps(px, x1), _mm_cmpeq_ps(py, y1));
+                const __m128 contact =
+                        _mm_andnot_ps(at_end, _mm_and_ps(_mm_cmpeq_ps(side, zero), _mm_and_ps(in_x, in_y)));
+                contacts[k] = _mm_sub_epi32(contacts[k], _mm_castps_si128(contact));
+            }
+        }
+        for (size_t k = 0; k < kVectors; ++k) {
+            const __m128i on_boundary = _mm_cmpgt_epi32(contacts[k], _mm_setzero_si128());
+            const __m128i result =
+                    _mm_or_si128(_mm_and_si128(on_boundary, contacts[k]), _mm_andnot_si128(on_boundary, winding[k]));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(winding_numbers + 4 * k), result);
+        }
+#else
+        int contacts[kLanes] = {};
+        std::fill(winding_numbers, winding_numbers + kLanes, 0);
+        for (size_t i = 0; i < edge_count; ++i) {
+            for (size_t lane = 0; lane < kLanes; ++lane) {
+                const float x0 = xs[i * kLanes + lane], y0 = ys[i * kLanes + lane];
+                const float x1 = xs[(i + 1) * kLanes + lane], y1 = ys[(i + 1) * kLanes + lane];
+                const float side = (x1 - x0) * (y - y0) - (x - x0) * (y1 - y0);
+                const bool start_below = y0 <= y;
+                const bool end_above = y1 > y;
+                winding_numbers[lane] += start_below && end_above && side > 0;
+                winding_numbers[lane] -= !start_below && !end_above && side < 0;
+                contacts[lane] += side == 0 && x >= std::min(x0, x1) && x <= std::max(x0, x1) &&
+                                  y >= std::min(y0, y1) && y <= std::max(y0, y1) && !(x == x1 && y == y1);
+            }
+        }
+        for (size_t lane = 0; lane < kLanes; ++lane) {
+            winding_numbers[lane] = contacts[lane] > 0 ? contacts[lane] : winding_numbers[lane];
+        }
+#endif
+    }
+
+    // Runs every block against (x, y), and stores the result for polygon j at results[j].
+    void EvaluateAll(float x, float y, const PolygonLanes& polygons, std::optional<int>* results) {
+        for (const auto& group : polygons.groups()) {
+            for (size_t block = 0; block < group.block_count(); ++block) {
+                int winding_numbers[PolygonLanes::kLaneCount];
+                EvaluateBlock(group.x_vec_.data() + block * group.block_stride(),
+                              group.y_vec_.data() + block * group.block_stride(), group.edge_count, x, y,
+                              winding_numbers);
+                const size_t first = block * PolygonLanes::kLaneCount;
+                const size_t lanes = std::min(PolygonLanes::kLaneCount, group.polygons.size() - first);
+                for (size_t lane = 0; lane < lanes; ++lane) {
+                    results[group.polygons[first + lane]] = winding_numbers[lane];
+                }
+            }
+            WINDING_COUNT(kCalls, group.polygons.size());
+            WINDING_COUNT(kVertices, group.polygons.size() * (group.edge_count + 1));
+        }
+        WINDING_COUNT(kUnclosedPolygons, polygons.unclosed().size());
+    }
+
+}  // namespace
+
+std::vector<std::optional<int>> CalculateWindingNumbers2D(float x, float y, const poly::PolygonLanes& polygons) {
+    std::vector<std::optional<int>> winding_numbers(polygons.size());
+    EvaluateAll(x, y, polygons, winding_numbers.data());
+    return winding_numbers;
+}
+
+std::vector<std::optional<int>> CalculateWindingNumbers2D(const poly::PointBatch& points,
+                                                          const poly::PolygonLanes& polygons) {
+    std::vector<std::optional<int>> winding_numbers(points.size() * polygons.size());
+    // Blocks outside, points inside: a block is small enough to stay in cache while every point runs against it.
+    for (const auto& group : polygons.groups()) {
+        for (size_t block = 0; block < group.block_count(); ++block) {
+            const float* xs = group.x_vec_.data() + block * group.block_stride();
+            const float* ys = group.y_vec_.data() + block * group.block_stride();
+            const size_t first = block * PolygonLanes::kLaneCount;
+            const size_t lanes = std::min(PolygonLanes::kLaneCount, group.polygons.size() - first);
+            for (size_t i = 0; i < points.size(); ++i) {
+                int block_winding_numbers[PolygonLanes::kLaneCount];
+                EvaluateBlock(xs, ys, group.edge_count, points.x_vec_[i], points.y_vec_[i], block_winding_numbers);
+                std::optional<int>* results = winding_numbers.data() + i * polygons.size();
+                for (size_t lane = 0; lane < lanes; ++lane) {
+                    results[group.polygons[first + lane]] = block_winding_numbers[lane];
+                }
+            }
+        }
+        WINDING_COUNT(kCalls, points.size() * group.polygons.size());
+        WINDING_COUNT(kVertices, points.size() * group.polygons.size() * (group.edge_count + 1));
+    }
+    WINDING_COUNT(kUnclosedPolygons, points.size() * polygons.unclosed().size());
+    return winding_numbers;
+}
+
+}  // namespace winding_number
@@ -0,0 +1,142 @@
+#include <prepared_edges.hpp>
+
+#include <cmath>
+
+#include <instrumentation.hpp>
+
+namespace winding_number {
+namespace {
+
+    // x + y * z, fused when the target has a fast fused multiply-add.
+    inline float MultiplyAdd(float y, float z, float x) {
+#ifdef FP_FAST_FMAF
+        return std::fma(y, z, x);
+#else
+        return x + y * z;
+#endif
+    }
+
+}  // namespace
+
+PreparedEdges::PreparedEdges(const poly::Polygon& polygon, EdgeForm form, float tolerance) :
+        form_(form), closed_(polygon.size() > 0 && polygon.IsClosed(tolerance)) {
+    if (!closed_) {
+        return;
+    }
+    const size_t edge_count = polygon.size() - 1;
+    min_y_.reserve(edge_count);
+    max_y_.reserve(edge_count);
+    direction_.reserve(edge_count);
+    x_at_min_y_.reserve(edge_count);
+    if (form_ == EdgeForm::kSlope) {
+        inverse_slope_.reserve(edge_count);
+    } else {
+        dx_.reserve(edge_count);
+        dy_.reserve(edge_count);
+    }
+    for (size_t i = 0; i < edge_count; ++i) {
+        const float x0 = polygon.x_vec_[i], y0 = polygon.y_vec_[i];
+        const float x1 = polygon.x_vec_[i + 1], y1 = polygon.y_vec_[i + 1];
+        if (y0 == y1) {
+            horizontal_y_.push_back(y0);
+            horizontal_start_x_.push_back(x0);
+            horizontal_end_x_.push_back(x1);
+            continue;
+        }
+        // Orient every edge upwards, so that "left of the edge" always means "the edge crosses the ray".
+        const bool up = y1 > y0;
+        const float xb = up ? x0 : x1, yb = up ? y0 : y1;
+        const float xt = up ? x1 : x0, yt = up ? y1 : y0;
+        min_y_.push_back(yb);
+        max_y_.push_back(yt);
+        direction_.push_back(up ? 1 : -1);
+        x_at_min_y_.push_back(xb);
+        if (form_ == EdgeForm::kSlope) {
+            inverse_slope_.push_back((xt - xb) / (yt - yb));
+        } else {
+            dx_.push_back(double(xt) - double(xb));
+            dy_.push_back(double(yt) - double(yb));
+        }
+    }
+}
+
+std::optional<int> PreparedEdges::CalculateWindingNumber2D(float x, float y) const {
+    if (!closed_) {
+        WINDING_COUNT(kUnclosedPolygons, 1);
+        return std::nullopt;
+    }
+    WINDING_COUNT(kCalls, 1);
+    WINDING_COUNT(kVertices, min_y_.size() + horizontal_y_.size());
+    return form_ == EdgeForm::kSlope ? SlopeWindingNumber(x, y) : LineWindingNumber(x, y);
+}
+
+std::optional<int> PreparedEdges::SlopeWindingNumber(float x, float y) const {
+    int winding_number = 0;
+    int contacts = HorizontalContacts(x, y);
+    const size_t edge_count = min_y_.size();
+    for (size_t i = 0; i < edge_count; ++i) {
+        if (y < min_y_[i] || y > max_y_[i]) {
+            continue;
+        }
+        const float crossing_x = MultiplyAdd(y - min_y_[i], inverse_slope_[i], x_at_min_y_[i]);
+        if (y < max_y_[i] && crossing_x > x) {
+            winding_number += direction_[i];
+        } else if (crossing_x == x && y != (direction_[i] > 0 ? max_y_[i] : min_y_[i])) {
+            ++contacts;
+        }
+    }
+    WINDING_COUNT(kOnEdge, contacts > 0);
+    return contacts > 0 ? contacts : winding_number;
+}
+
+std::optional<int> PreparedEdges::LineWindingNumber(float x, float y) const {
+    int winding_number = 0;
+    int contacts = HorizontalContacts(x, y);
+    const size_t edge_count = min_y_.size();
+    for (size_t i = 0; i < edge_count; ++i) {
+        if (y < min_y_[i] || y > max_y_[i]) {
+            continue;
+        }
+        // The same expression as EdgeSide(), so that points on the edge give exactly 0.
+        const double side = dx_[i] * (double(y) - min_y_[i]) - (double(x) - x_at_min_y_[i]) * dy_[i];
+        if (y < max_y_[i] && side > 0) {
+            winding_number += direction_[i];
+        } else if (side == 0 && y != (direction_[i] > 0 ? max_y_[i] : min_y_[i])) {
+            ++contacts;
+        }
+    }
+    WINDING_COUNT(kOnEdge, contacts > 0);
+    return contacts > 0 ? contacts : winding_number;
+}
+
+int PreparedEdges::HorizontalContacts(float x, float y) const {
+    int contacts = 0;
+    for (size_t i = 0; i < horizontal_y_.size(); ++i) {
+        const float start = horizontal_start_x_[i], end = horizontal_end_x_[i];
+        contacts += y == horizontal_y_[i] && x != end && ((start <= x && x <= end) || (end <= x && x <= start));
+    }
+    return contacts;
+}
+
+std::vector<std::optional<int>> PreparedEdges::CalculateWindingNumbers2D(const poly::PointBatch& points) const {
+    std::vector<std::optional<int>> winding_numbers;
+    winding_numbers.reserve(points.size());
+    for (size_t i = 0; i < points.size(); ++i) {
+        winding_numbers.push_back(CalculateWindingNumber2D(points.x_vec_[i], points.y_vec_[i]));
+    }
+    return winding_numbers;
+}
+
+EdgeForm PreparedEdges::form() const noexcept {
+    return form_;
+}
+
+size_t PreparedEdges::memory_bytes() const noexcept {
+    return (min_y_.capacity() + max_y_.capacity() + x_at_min_y_.capacity() + inverse_slope_.capacity()) *
+                   sizeof(float) +
+           direction_.capacity() * sizeof(int8_t) +
+           (dx_.capacity() + dy_.capacity()) * sizeof(double) +
+           (horizontal_y_.capacity() + horizontal_start_x_.capacity() + horizontal_end_x_.capacity()) * sizeof(float);
+}
+
+}  // namespace winding_number
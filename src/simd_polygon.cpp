@@ -0,0 +1,129 @@
+#include <simd_polygon.hpp>
+
+#include <algorithm>
+
+#include <instrumentation.hpp>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#    include <emmintrin.h>
+#    define SIMD_POLYGON_SSE2 1
+#endif
+
+namespace poly {
+
+SimdPolygon::SimdPolygon(const Polygon& polygon, float tolerance) :
+        closed_(polygon.size() > 0 && polygon.IsClosed(tolerance)) {
+    // The last point of a closed polygon repeats the first one, so it is dropped and the closing edge made implicit.
+    edge_count_ = closed_ ? polygon.size() - 1 : 0;
+    const size_t padded = std::max<size_t>((edge_count_ + kLaneCount - 1) / kLaneCount, 1) * kLaneCount;
+    x_vec_.reserve(padded + 1);
+    y_vec_.reserve(padded + 1);
+    for (size_t i = 0; i < edge_count_; ++i) {
+        x_vec_.push_back(polygon.x_vec_[i]);
+        y_vec_.push_back(polygon.y_vec_[i]);
+    }
+    const float first_x = polygon.size() > 0 ? polygon.x_vec_[0] : 0.f;
+    const float first_y = polygon.size() > 0 ? polygon.y_vec_[0] : 0.f;
+    x_vec_.resize(padded + 1, first_x);
+    y_vec_.resize(padded + 1, first_y);
+}
+
+size_t SimdPolygon::edge_count() const noexcept {
+    return edge_count_;
+}
+
+size_t SimdPolygon::padded_edge_count() const noexcept {
+    return x_vec_.size() - 1;
+}
+
+bool SimdPolygon::closed() const noexcept {
+    return closed_;
+}
+
+}  // namespace poly
+
+namespace winding_number {
+namespace {
+
+#if !SIMD_POLYGON_SSE2
+    // Scalar version of the kernel below, with the same single precision arithmetic.
+    inline void AccumulateEdge(float x0, float y0, float x1, float y1, float x, float y, int& winding_number,
+                               int& contacts) {
+        const float side = (x1 - x0) * (y - y0) - (x - x0) * (y1 - y0);
+        const bool start_below = y0 <= y;
+        const bool end_above = y1 > y;
+        winding_number += (start_below && end_above && side > 0) - (!start_below && !end_above && side < 0);
+        contacts += side == 0 && x >= std::min(x0, x1) && x <= std::max(x0, x1) && y >= std::min(y0, y1) &&
+                    y <= std::max(y0, y1) && !(x == x1 && y == y1);
+    }
+#else
+    inline int HorizontalSum(__m128i v) {
+        v = _mm_add_epi32(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2)));
+        v = _mm_add_epi32(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(2, 3, 0, 1)));
+        return _mm_cvtsi128_si32(v);
+    }
+#endif
+
+}  // namespace
+
+std::optional<int> CalculateWindingNumber2D(float x, float y, const poly::SimdPolygon& polygon) {
+    if (!polygon.closed()) {
+        WINDING_COUNT(kUnclosedPolygons, 1);
+        return std::nullopt;
+    }
+    const float* xs = polygon.x_vec_.data();
+    const float* ys = polygon.y_vec_.data();
+    const size_t edge_count = polygon.padded_edge_count();
+    WINDING_COUNT(kCalls, 1);
+    WINDING_COUNT(kVertices, edge_count);
+
+#if SIMD_POLYGON_SSE2
+    const __m128 px = _mm_set1_ps(x);
+    const __m128 py = _mm_set1_ps(y);
+    const __m128 zero = _mm_setzero_ps();
+    __m128i winding = _mm_setzero_si128();
+    __m128i contacts = _mm_setzero_si128();
+    for (size_t i = 0; i < edge_count; i += 4) {
+        const __m128 x0 = _mm_load_ps(xs + i);
+        const __m128 y0 = _mm_load_ps(ys + i);
+        const __m128 x1 = _mm_loadu_ps(xs + i + 1);
+        const __m128 y1 = _mm_loadu_ps(ys + i + 1);
+        const __m128 side = _mm_sub_ps(_mm_mul_ps(_mm_sub_ps(x1, x0), _mm_sub_ps(py, y0)),
+                                       _mm_mul_ps(_mm_sub_ps(px, x0), _mm_sub_ps(y1, y0)));
+        const __m128 start_below = _mm_cmple_ps(y0, py);
+        const __m128 end_above = _mm_cmpgt_ps(y1, py);
+        const __m128 up = _mm_and_ps(_mm_and_ps(start_below, end_above), _mm_cmpgt_ps(side, zero));
+        const __m128 down = _mm_andnot_ps(start_below, _mm_andnot_ps(end_above, _mm_cmplt_ps(side, zero)));
+        // Comparison masks are -1 in the lanes where they hold.
+        winding = _mm_add_epi32(_mm_sub_epi32(winding, _mm_castps_si128(up)), _mm_castps_si128(down));
+
+        const __m128 in_x = _mm_and_ps(_mm_cmpge_ps(px, _mm_min_ps(x0, x1)), _mm_cmple_ps(px, _mm_max_ps(x0, x1)));
+        const __m128 in_y = _mm_and_ps(_mm_cmpge_ps(py, _mm_min_ps(y0, y1)), _mm_cmple_ps(py, _mm_max_ps(y0, y1)));
+        const __m128 at_end = _mm_and_ps(_mm_cmpeq_ps(px, x1), _mm_cmpeq_ps(py, y1));
+        const __m128 contact = _mm_andnot_ps(at_end, _mm_and_ps(_mm_cmpeq_ps(side, zero), _mm_and_ps(in_x, in_y)));
+        contacts = _mm_sub_epi32(contacts, _mm_castps_si128(contact));
+    }
+    const int winding_number = HorizontalSum(winding);
+    const int contact_count = HorizontalSum(contacts);
+#else
+    int winding_number = 0;
+    int contact_count = 0;
+    for (size_t i = 0; i < edge_count; ++i) {
+        AccumulateEdge(xs[i], ys[i], xs[i + 1], ys[i + 1], x, y, winding_number, contact_count);
+    }
+#endif
+    WINDING_COUNT(kOnEdge, contact_count > 0);
+    return contact_count > 0 ? contact_count : winding_number;
+}
+
+std::vector<std::optional<int>> CalculateWindingNumbers2D(const poly::PointBatch& points,
+                                                          const poly::SimdPolygon& polygon) {
+    std::vector<std::optional<int>> winding_numbers;
+    winding_numbers.reserve(points.size());
+    for (size_t i = 0; i < points.size(); ++i) {
+        winding_numbers.push_back(CalculateWindingNumber2D(points.x_vec_[i], points.y_vec_[i], polygon));
+    }
+    return winding_numbers;
+}
+
+}  // namespace winding_number
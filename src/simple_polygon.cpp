@@ -0,0 +1,259 @@
+#include <simple_polygon.hpp>
+
+#include <algorithm>
+#include <set>
+#include <tuple>
+
+#include <edge_crossing.hpp>
+#include <exact_predicates.hpp>
+#include <instrumentation.hpp>
+
+namespace winding_number {
+namespace {
+
+    // An edge with its endpoints ordered left to right, and bottom to top if it is vertical.
+    struct Segment {
+        float x0, y0, x1, y1;
+        size_t edge;
+    };
+
+    bool LeftOf(float x0, float y0, float x1, float y1) {
+        return x0 < x1 || (x0 == x1 && y0 < y1);
+    }
+
+    // +1 when (x, y) is above the segment, -1 when it is below it and 0 when it is on the line through it. The sweep
+    // visits points in (x, y) order, which is the same as sweeping a line tilted ever so slightly clockwise from
+    // vertical. Shearing the plane to make that line vertical changes no orientations, so vertical segments need no
+    // special case: they just go up steeply, and points right of them are below them.
+    int Above(const Segment& s, float x, float y) {
+        return ExactEdgeSide(s.x0, s.y0, s.x1, s.y1, x, y);
+    }
+
+    bool WithinBox(const Segment& s, float x, float y) {
+        return std::min(s.x0, s.x1) <= x && x <= std::max(s.x0, s.x1) && std::min(s.y0, s.y1) <= y &&
+               y <= std::max(s.y0, s.y1);
+    }
+
+    // Whether the closed segments share any point.
+    bool Intersect(const Segment& a, const Segment& b) {
+        const int a_b0 = ExactEdgeSide(a.x0, a.y0, a.x1, a.y1, b.x0, b.y0);
+        const int a_b1 = ExactEdgeSide(a.x0, a.y0, a.x1, a.y1, b.x1, b.y1);
+        const int b_a0 = ExactEdgeSide(b.x0, b.y0, b.x1, b.y1, a.x0, a.y0);
+        const int b_a1 = ExactEdgeSide(b.x0, b.y0, b.x1, b.y1, a.x1, a.y1);
+        if (a_b0 * a_b1 < 0 && b_a0 * b_a1 < 0) {
+            return true;
+        }
+        return (a_b0 == 0 && WithinBox(a, b.x0, b.y0)) || (a_b1 == 0 && WithinBox(a, b.x1, b.y1)) ||
+               (b_a0 == 0 && WithinBox(b, a.x0, a.y0)) || (b_a1 == 0 && WithinBox(b, a.x1, a.y1));
+    }
+
+    int Sign(float value) {
+        return (value > 0) - (value < 0);
+    }
+
+    // Consecutive edges always share a vertex. They only overlap when the boundary doubles back along itself there.
+    bool Overlap(float x_before, float y_before, float x, float y, float x_after, float y_after) {
+        if (ExactEdgeSide(x_before, y_before, x, y, x_after, y_after) != 0) {
+            return false;
+        }
+        return Sign(x_before - x) == Sign(x_after - x) && Sign(y_before - y) == Sign(y_after - y);
+    }
+
+    // The order of the segments crossing the sweep line, bottom to top. Two segments are compared where the one that
+    // starts further right starts, so the order only depends on the pair, and stays right as long as no segments
+    // cross left of the sweep line -- which the sweep makes sure of by stopping at the first intersection it finds.
+    class SweepOrder {
+    public:
+        explicit SweepOrder(const std::vector<Segment>& segments) : segments_(&segments) {}
+
+        bool operator()(size_t a, size_t b) const {
+            if (a == b) {
+                return false;
+            }
+            const Segment& s = (*segments_)[a];
+            const Segment& t = (*segments_)[b];
+            if (LeftOf(t.x0, t.y0, s.x0, s.y0) || (s.x0 == t.x0 && s.y0 == t.y0 && b < a)) {
+                return !(*this)(b, a);
+            }
+            int side = Above(s, t.x0, t.y0);
+            if (side == 0) {
+                side = Above(s, t.x1, t.y1);
+            }
+            return side == 0 ? a < b : side > 0;
+        }
+
+    private:
+        const std::vector<Segment>* segments_;
+    };
+
+    // Shamos-Hoey: sweeps a vertical line left to right, keeping the segments it crosses in order. Two segments that
+    // meet are next to each other in that order somewhere left of the first point where any two segments meet, so it
+    // is enough to check each segment against its neighbors when it is inserted, and the two segments that become
+    // neighbors when one is removed.
+    bool IsSimple(const std::vector<float>& xs, const std::vector<float>& ys) {
+        const size_t n = xs.size();
+        std::vector<Segment> segments;
+        segments.reserve(n);
+        for (size_t i = 0; i < n; ++i) {
+            const size_t next = (i + 1) % n;
+            if (LeftOf(xs[i], ys[i], xs[next], ys[next])) {
+                segments.push_back({xs[i], ys[i], xs[next], ys[next], i});
+            } else {
+                segments.push_back({xs[next], ys[next], xs[i], ys[i], i});
+            }
+        }
+
+        auto acceptable = [&](size_t a, size_t b) {
+            if ((a + 1) % n == b || (b + 1) % n == a) {
+                const size_t vertex = (a + 1) % n == b ? b : a;
+                const size_t before = (vertex + n - 1) % n, after = (vertex + 1) % n;
+                return !Overlap(xs[before], ys[before], xs[vertex], ys[vertex], xs[after], ys[after]);
+            }
+            return !Intersect(segments[a], segments[b]);
+        };
+
+        // (x, y, removal, segment): at each point, segments starting there are inserted before the segments ending
+        // there are removed, so that segments touching at the point are compared.
+        std::vector<std::tuple<float, float, bool, size_t>> events;
+        events.reserve(2 * n);
+        for (size_t i = 0; i < n; ++i) {
+            events.emplace_back(segments[i].x0, segments[i].y0, false, i);
+            events.emplace_back(segments[i].x1, segments[i].y1, true, i);
+        }
+        std::sort(events.begin(), events.end());
+
+        std::set<size_t, SweepOrder> sweep{SweepOrder(segments)};
+        std::vector<std::set<size_t, SweepOrder>::iterator> positions(n);
+        for (const auto& [x, y, removal, segment] : events) {
+            if (!removal) {
+                const auto position = sweep.insert(segment).first;
+                positions[segment] = position;
+                if (position != sweep.begin() && !acceptable(*std::prev(position), segment)) {
+                    return false;
+                }
+                if (std::next(position) != sweep.end() && !acceptable(segment, *std::next(position))) {
+                    return false;
+                }
+            } else {
+                const auto position = positions[segment];
+                const auto next = std::next(position);
+                if (position != sweep.begin() && next != sweep.end() && !acceptable(*std::prev(position), *next)) {
+                    return false;
+                }
+                sweep.erase(position);
+            }
+        }
+        return true;
+    }
+
+}  // namespace
+
+SimplePolygon::SimplePolygon(const poly::Polygon& polygon, float tolerance) :
+        closed_(polygon.size() > 0 && polygon.IsClosed(tolerance)),
+        x_vec_(polygon.x_vec_.begin(), polygon.x_vec_.end()),
+        y_vec_(polygon.y_vec_.begin(), polygon.y_vec_.end()) {
+    if (!closed_ || polygon.x_vec_.back() != polygon.x_vec_.front() ||
+        polygon.y_vec_.back() != polygon.y_vec_.front()) {
+        return;
+    }
+
+    // The distinct vertices, in order and without the closing point.
+    std::vector<float> xs, ys;
+    for (size_t i = 0; i + 1 < polygon.size(); ++i) {
+        if (xs.empty() || polygon.x_vec_[i] != xs.back() || polygon.y_vec_[i] != ys.back()) {
+            xs.push_back(polygon.x_vec_[i]);
+            ys.push_back(polygon.y_vec_[i]);
+        }
+    }
+    while (xs.size() > 1 && xs.back() == xs.front() && ys.back() == ys.front()) {
+        xs.pop_back();
+        ys.pop_back();
+    }
+    if (xs.size() < 3 || !IsSimple(xs, ys)) {
+        return;
+    }
+
+    // The boundary turns the polygon's way at its lowest vertex, and it can't go straight on there without doubling
+    // back, which IsSimple() has ruled out.
+    const size_t n = xs.size();
+    size_t lowest = 0;
+    for (size_t i = 1; i < n; ++i) {
+        if (ys[i] < ys[lowest] || (ys[i] == ys[lowest] && xs[i] < xs[lowest])) {
+            lowest = i;
+        }
+    }
+    const size_t before = (lowest + n - 1) % n, after = (lowest + 1) % n;
+    orientation_ = ExactEdgeSide(xs[before], ys[before], xs[lowest], ys[lowest], xs[after], ys[after]);
+
+    xs.push_back(xs.front());
+    ys.push_back(ys.front());
+    x_vec_ = std::move(xs);
+    y_vec_ = std::move(ys);
+}
+
+std::optional<int> SimplePolygon::CalculateWindingNumber2D(float x, float y) const {
+    if (!closed_) {
+        WINDING_COUNT(kUnclosedPolygons, 1);
+        return std::nullopt;
+    }
+    WINDING_COUNT(kCalls, 1);
+    return orientation_ != 0 ? ParityWindingNumber(x, y) : GeneralWindingNumber(x, y);
+}
+
+int SimplePolygon::ParityWindingNumber(float x, float y) const {
+    const float* xs = x_vec_.data();
+    const float* ys = y_vec_.data();
+    const size_t last = x_vec_.size() - 1;
+    bool inside = false;
+    for (size_t i = 0; i < last; ++i) {
+        const float x0 = xs[i], y0 = ys[i], x1 = xs[i + 1], y1 = ys[i + 1];
+        if ((y < y0 && y < y1) || (y > y0 && y > y1)) {
+            continue;
+        }
+        // The edge spans the ray's height, so the point is either on it, or to one side of it.
+        const double side = EdgeSide(x0, y0, x1, y1, x, y);
+        if (side == 0 && std::min(x0, x1) <= x && x <= std::max(x0, x1)) {
+            WINDING_COUNT(kVertices, i + 1);
+            WINDING_COUNT(kOnEdge, 1);
+            return 1;
+        }
+        if ((y0 <= y) != (y1 <= y) && (side > 0) == (y1 > y0)) {
+            inside = !inside;
+        }
+    }
+    WINDING_COUNT(kVertices, x_vec_.size());
+    return inside ? orientation_ : 0;
+}
+
+int SimplePolygon::GeneralWindingNumber(float x, float y) const {
+    int winding_number = 0;
+    int contacts = 0;
+    const float* xs = x_vec_.data();
+    const float* ys = y_vec_.data();
+    for (size_t i = 0; i + 1 < x_vec_.size(); ++i) {
+        contacts += EdgeContainsPoint(xs[i], ys[i], xs[i + 1], ys[i + 1], x, y);
+        winding_number += EdgeCrossing(xs[i], ys[i], xs[i + 1], ys[i + 1], x, y);
+    }
+    WINDING_COUNT(kVertices, x_vec_.size());
+    WINDING_COUNT(kOnEdge, contacts > 0);
+    return contacts > 0 ? contacts : winding_number;
+}
+
+std::vector<std::optional<int>> SimplePolygon::CalculateWindingNumbers2D(const poly::PointBatch& points) const {
+    std::vector<std::optional<int>> winding_numbers;
+    winding_numbers.reserve(points.size());
+    for (size_t i = 0; i < points.size(); ++i) {
+        winding_numbers.push_back(CalculateWindingNumber2D(points.x_vec_[i], points.y_vec_[i]));
+    }
+    return winding_numbers;
+}
+
+bool SimplePolygon::simple() const noexcept {
+    return orientation_ != 0;
+}
+
+int SimplePolygon::orientation() const noexcept {
+    return orientation_;
+}
+
+}  // namespace winding_number
@@ -0,0 +1,168 @@
+#include <small_polygon.hpp>
+
+#include <algorithm>
+#include <iterator>
+#include <utility>
+
+#include <edge_crossing.hpp>
+#include <instrumentation.hpp>
+
+namespace winding_number {
+namespace {
+
+    // EdgeContainsPoint() and EdgeCrossing() in one, sharing the side test. Most edges of a small polygon are entirely
+    // above or below the point, and need nothing more than the first compares.
+    inline void AddEdge(float x0, float y0, float x1, float y1, float x, float y, int& winding_number, int& contacts) {
+        if ((y < y0 && y < y1) || (y > y0 && y > y1)) {
+            return;
+        }
+        const double side = EdgeSide(x0, y0, x1, y1, x, y);
+        if (side == 0) {
+            contacts += std::min(x0, x1) <= x && x <= std::max(x0, x1) && !(x == x1 && y == y1);
+        } else if (y0 <= y) {
+            winding_number += y1 > y && side > 0;
+        } else {
+            winding_number -= y1 <= y && side < 0;
+        }
+    }
+
+    // Sums the crossings and contacts of edges I -> I + 1, with every index known at compile time.
+    template <size_t... I>
+    int UnrolledEdges(const float* xs, const float* ys, float x, float y, std::index_sequence<I...>) {
+        int winding_number = 0;
+        int contacts = 0;
+        (AddEdge(xs[I], ys[I], xs[I + 1], ys[I + 1], x, y, winding_number, contacts), ...);
+        WINDING_COUNT(kOnEdge, contacts > 0);
+        return contacts > 0 ? contacts : winding_number;
+    }
+
+    // Whether the four edges of a closed polygon of five points alternate between horizontal and vertical. Since none
+    // of them has zero length and the last point is the first, the points are then the corners of a rectangle.
+    bool IsRectangle(const poly::Polygon& polygon) {
+        const auto& xs = polygon.x_vec_;
+        const auto& ys = polygon.y_vec_;
+        if (polygon.size() != 5 || xs[4] != xs[0] || ys[4] != ys[0]) {
+            return false;
+        }
+        // Either the first edge is horizontal and the second vertical, or the other way round.
+        const bool horizontal_first = ys[0] == ys[1];
+        for (size_t i = 0; i < 4; ++i) {
+            const bool horizontal = (i % 2 == 0) == horizontal_first;
+            if (horizontal ? (ys[i] != ys[i + 1] || xs[i] == xs[i + 1]) : (xs[i] != xs[i + 1] || ys[i] == ys[i + 1])) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+}  // namespace
+
+SmallPolygon::SmallPolygon(const poly::Polygon& polygon, float tolerance) :
+        closed_(polygon.size() > 0 && polygon.IsClosed(tolerance)),
+        edge_count_(polygon.size() > 0 ? polygon.size() - 1 : 0) {
+    if (!closed_) {
+        return;
+    }
+    if (IsRectangle(polygon)) {
+        shape_ = Shape::kRectangle;
+        min_x_ = std::min(polygon.x_vec_[0], polygon.x_vec_[2]);
+        max_x_ = std::max(polygon.x_vec_[0], polygon.x_vec_[2]);
+        min_y_ = std::min(polygon.y_vec_[0], polygon.y_vec_[2]);
+        max_y_ = std::max(polygon.y_vec_[0], polygon.y_vec_[2]);
+        orientation_ = EdgeSide(polygon.x_vec_[0], polygon.y_vec_[0], polygon.x_vec_[1], polygon.y_vec_[1],
+                                polygon.x_vec_[2], polygon.y_vec_[2]) > 0 ? 1 : -1;
+        kernel_ = &RectangleWindingNumber;
+        batch_kernel_ = &BatchWindingNumbers<&RectangleWindingNumber>;
+        return;
+    }
+    if (edge_count_ >= 3 && edge_count_ <= kMaxEdges) {
+        shape_ = Shape::kUnrolled;
+        std::copy(polygon.x_vec_.begin(), polygon.x_vec_.end(), xs_.begin());
+        std::copy(polygon.y_vec_.begin(), polygon.y_vec_.end(), ys_.begin());
+        static constexpr Kernel kKernels[] = {&UnrolledWindingNumber<3>, &UnrolledWindingNumber<4>,
+                                              &UnrolledWindingNumber<5>, &UnrolledWindingNumber<6>,
+                                              &UnrolledWindingNumber<7>, &UnrolledWindingNumber<8>};
+        static constexpr BatchKernel kBatchKernels[] = {
+                &BatchWindingNumbers<&UnrolledWindingNumber<3>>, &BatchWindingNumbers<&UnrolledWindingNumber<4>>,
+                &BatchWindingNumbers<&UnrolledWindingNumber<5>>, &BatchWindingNumbers<&UnrolledWindingNumber<6>>,
+                &BatchWindingNumbers<&UnrolledWindingNumber<7>>, &BatchWindingNumbers<&UnrolledWindingNumber<8>>};
+        static_assert(std::size(kKernels) == kMaxEdges - 2, "one kernel for each of 3 to kMaxEdges edges");
+        kernel_ = kKernels[edge_count_ - 3];
+        batch_kernel_ = kBatchKernels[edge_count_ - 3];
+        return;
+    }
+    x_vec_.assign(polygon.x_vec_.begin(), polygon.x_vec_.end());
+    y_vec_.assign(polygon.y_vec_.begin(), polygon.y_vec_.end());
+}
+
+std::optional<int> SmallPolygon::CalculateWindingNumber2D(float x, float y) const {
+    if (!closed_) {
+        WINDING_COUNT(kUnclosedPolygons, 1);
+        return std::nullopt;
+    }
+    return kernel_(*this, x, y);
+}
+
+std::vector<std::optional<int>> SmallPolygon::CalculateWindingNumbers2D(const poly::PointBatch& points) const {
+    if (!closed_) {
+        WINDING_COUNT(kUnclosedPolygons, points.size());
+        return std::vector<std::optional<int>>(points.size());
+    }
+    std::vector<std::optional<int>> winding_numbers;
+    winding_numbers.reserve(points.size());
+    batch_kernel_(*this, points, winding_numbers);
+    return winding_numbers;
+}
+
+template <size_t N>
+int SmallPolygon::UnrolledWindingNumber(const SmallPolygon& polygon, float x, float y) {
+    WINDING_COUNT(kCalls, 1);
+    WINDING_COUNT(kVertices, N + 1);
+    return UnrolledEdges(polygon.xs_.data(), polygon.ys_.data(), x, y, std::make_index_sequence<N>());
+}
+
+int SmallPolygon::RectangleWindingNumber(const SmallPolygon& polygon, float x, float y) {
+    WINDING_COUNT(kCalls, 1);
+    if (x < polygon.min_x_ || x > polygon.max_x_ || y < polygon.min_y_ || y > polygon.max_y_) {
+        WINDING_COUNT(kEarlyRejects, 1);
+        return 0;
+    }
+    if (polygon.min_x_ < x && x < polygon.max_x_ && polygon.min_y_ < y && y < polygon.max_y_) {
+        return polygon.orientation_;
+    }
+    // On the boundary, which passes through each of its points once.
+    WINDING_COUNT(kOnEdge, 1);
+    return 1;
+}
+
+int SmallPolygon::GeneralWindingNumber(const SmallPolygon& polygon, float x, float y) {
+    int winding_number = 0;
+    int contacts = 0;
+    const float* xs = polygon.x_vec_.data();
+    const float* ys = polygon.y_vec_.data();
+    for (size_t i = 0; i + 1 < polygon.x_vec_.size(); ++i) {
+        AddEdge(xs[i], ys[i], xs[i + 1], ys[i + 1], x, y, winding_number, contacts);
+    }
+    WINDING_COUNT(kCalls, 1);
+    WINDING_COUNT(kVertices, polygon.x_vec_.size());
+    WINDING_COUNT(kOnEdge, contacts > 0);
+    return contacts > 0 ? contacts : winding_number;
+}
+
+template <SmallPolygon::Kernel kernel>
+void SmallPolygon::BatchWindingNumbers(const SmallPolygon& polygon, const poly::PointBatch& points,
+                                       std::vector<std::optional<int>>& winding_numbers) {
+    for (size_t i = 0; i < points.size(); ++i) {
+        winding_numbers.push_back(kernel(polygon, points.x_vec_[i], points.y_vec_[i]));
+    }
+}
+
+SmallPolygon::Shape SmallPolygon::shape() const noexcept {
+    return shape_;
+}
+
+size_t SmallPolygon::edge_count() const noexcept {
+    return edge_count_;
+}
+
+}  // namespace winding_number
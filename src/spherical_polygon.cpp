@@ -0,0 +1,235 @@
+#include <spherical_polygon.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+#include <instrumentation.hpp>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#    include <emmintrin.h>
+#    define SPHERICAL_POLYGON_SSE2 1
+#endif
+
+namespace {
+
+    // Slack for rounding in the cap test, on the cosine of an angle between unit vectors.
+    constexpr double kCapSlack = 1e-12;
+
+    constexpr double kPi = 3.14159265358979323846;
+
+    double Dot(const double u[3], const double v[3]) {
+        return u[0] * v[0] + u[1] * v[1] + u[2] * v[2];
+    }
+
+    void LonLatToUnitVector(double lon, double lat, double p[3]) {
+        if (std::abs(lat) == 90.0) {
+            p[0] = 0.0;
+            p[1] = 0.0;
+            p[2] = lat > 0 ? 1.0 : -1.0;
+            return;
+        }
+        // Longitudes in [-180, 180), so that 180 and -180 give the same bits.
+        lon = std::remainder(lon, 360.0);
+        if (lon == 180.0) {
+            lon = -180.0;
+        }
+        const double lambda = lon * (kPi / 180.0), phi = lat * (kPi / 180.0);
+        p[0] = std::cos(phi) * std::cos(lambda);
+        p[1] = std::cos(phi) * std::sin(lambda);
+        p[2] = std::sin(phi);
+    }
+
+    void Normalize(double p[3]) {
+        const double length = std::sqrt(Dot(p, p));
+        for (size_t i = 0; i < 3; ++i) {
+            p[i] /= length;
+        }
+    }
+
+}  // namespace
+
+namespace poly {
+
+SphericalPolygon::SphericalPolygon(size_t capacity) {
+    x_vec_.reserve(capacity);
+    y_vec_.reserve(capacity);
+    z_vec_.reserve(capacity);
+}
+
+SphericalPolygon SphericalPolygon::FromLonLat(const Polygon& lon_lat) {
+    SphericalPolygon polygon(lon_lat.size());
+    for (size_t i = 0; i < lon_lat.size(); ++i) {
+        polygon.AppendLonLat(lon_lat.x_vec_[i], lon_lat.y_vec_[i]);
+    }
+    return polygon;
+}
+
+void SphericalPolygon::AppendLonLat(double lon, double lat) {
+    double p[3];
+    LonLatToUnitVector(lon, lat, p);
+    x_vec_.push_back(p[0]);
+    y_vec_.push_back(p[1]);
+    z_vec_.push_back(p[2]);
+}
+
+void SphericalPolygon::AppendPoint(double x, double y, double z) {
+    double p[3] = {x, y, z};
+    Normalize(p);
+    x_vec_.push_back(p[0]);
+    y_vec_.push_back(p[1]);
+    z_vec_.push_back(p[2]);
+}
+
+size_t SphericalPolygon::size() const {
+    return x_vec_.size();
+}
+
+void SphericalPolygon::ClosePolygon() {
+    if (size() == 0 || IsClosed()) {
+        return;
+    }
+    x_vec_.push_back(x_vec_.front());
+    y_vec_.push_back(y_vec_.front());
+    z_vec_.push_back(z_vec_.front());
+}
+
+bool SphericalPolygon::IsClosed(double tolerance) const {
+    if (size() == 0) {
+        return false;
+    }
+    const double dx = x_vec_.back() - x_vec_.front(), dy = y_vec_.back() - y_vec_.front(),
+                 dz = z_vec_.back() - z_vec_.front();
+    return std::sqrt(dx * dx + dy * dy + dz * dz) <= tolerance;
+}
+
+}  // namespace poly
+
+namespace winding_number {
+
+PreparedSphericalPolygon::PreparedSphericalPolygon(const poly::SphericalPolygon& polygon, double tolerance) :
+        closed_(polygon.size() > 0 && polygon.IsClosed(tolerance)),
+        x_vec_(polygon.x_vec_.begin(), polygon.x_vec_.end()),
+        y_vec_(polygon.y_vec_.begin(), polygon.y_vec_.end()),
+        z_vec_(polygon.z_vec_.begin(), polygon.z_vec_.end()) {
+    if (!closed_) {
+        return;
+    }
+    const size_t edge_count = x_vec_.size() - 1;
+    normal_x_vec_.resize(edge_count);
+    normal_y_vec_.resize(edge_count);
+    normal_z_vec_.resize(edge_count);
+    for (size_t i = 0; i < edge_count; ++i) {
+        normal_x_vec_[i] = y_vec_[i] * z_vec_[i + 1] - z_vec_[i] * y_vec_[i + 1];
+        normal_y_vec_[i] = z_vec_[i] * x_vec_[i + 1] - x_vec_[i] * z_vec_[i + 1];
+        normal_z_vec_[i] = x_vec_[i] * y_vec_[i + 1] - y_vec_[i] * x_vec_[i + 1];
+        cap_center_[0] += x_vec_[i];
+        cap_center_[1] += y_vec_[i];
+        cap_center_[2] += z_vec_[i];
+    }
+    if (edge_count == 0 || Dot(cap_center_, cap_center_) == 0.0) {
+        return;
+    }
+    Normalize(cap_center_);
+    cap_cos_radius_ = 1.0;
+    for (size_t i = 0; i < edge_count; ++i) {
+        const double p[3] = {x_vec_[i], y_vec_[i], z_vec_[i]};
+        cap_cos_radius_ = std::min(cap_cos_radius_, Dot(p, cap_center_));
+    }
+    fits_in_hemisphere_ = cap_cos_radius_ > kCapSlack;
+}
+
+int PreparedSphericalPolygon::CountCrossings(const double p[3]) const {
+    // The half plane is bounded by the axis through p and faces away from `side`, a direction perpendicular to p:
+    // p x k for the coordinate axis k least aligned with p. Only signs are compared, so it is not normalized.
+    size_t k = 0;
+    for (size_t i = 1; i < 3; ++i) {
+        if (std::abs(p[i]) < std::abs(p[k])) {
+            k = i;
+        }
+    }
+    double side[3] = {0, 0, 0};
+    side[(k + 1) % 3] = p[(k + 2) % 3];
+    side[(k + 2) % 3] = -p[(k + 1) % 3];
+
+    const size_t edge_count = normal_x_vec_.size();
+    int winding_number = 0;
+    size_t i = 0;
+#ifdef SPHERICAL_POLYGON_SSE2
+    const __m128d side_x = _mm_set1_pd(side[0]), side_y = _mm_set1_pd(side[1]), side_z = _mm_set1_pd(side[2]);
+    const __m128d p_x = _mm_set1_pd(p[0]), p_y = _mm_set1_pd(p[1]), p_z = _mm_set1_pd(p[2]);
+    const __m128d zero = _mm_setzero_pd();
+    __m128i counts = _mm_setzero_si128();
+    for (; i + 2 <= edge_count; i += 2) {
+        // Two edges per iteration: x_vec_ is aligned and i is even, so the starting points load aligned.
+        const __m128d start_side = _mm_add_pd(
+                _mm_add_pd(_mm_mul_pd(_mm_load_pd(&x_vec_[i]), side_x), _mm_mul_pd(_mm_load_pd(&y_vec_[i]), side_y)),
+                _mm_mul_pd(_mm_load_pd(&z_vec_[i]), side_z));
+        const __m128d end_side = _mm_add_pd(_mm_add_pd(_mm_mul_pd(_mm_loadu_pd(&x_vec_[i + 1]), side_x),
+                                                       _mm_mul_pd(_mm_loadu_pd(&y_vec_[i + 1]), side_y)),
+                                            _mm_mul_pd(_mm_loadu_pd(&z_vec_[i + 1]), side_z));
+        const __m128d left = _mm_add_pd(_mm_add_pd(_mm_mul_pd(_mm_load_pd(&normal_x_vec_[i]), p_x),
+                                                   _mm_mul_pd(_mm_load_pd(&normal_y_vec_[i]), p_y)),
+                                        _mm_mul_pd(_mm_load_pd(&normal_z_vec_[i]), p_z));
+        const __m128d up = _mm_and_pd(_mm_and_pd(_mm_cmple_pd(start_side, zero), _mm_cmpgt_pd(end_side, zero)),
+                                      _mm_cmpgt_pd(left, zero));
+        const __m128d down = _mm_and_pd(_mm_and_pd(_mm_cmpgt_pd(start_side, zero), _mm_cmple_pd(end_side, zero)),
+                                        _mm_cmplt_pd(left, zero));
+        // Masks are all ones, i.e. -1 per lane.
+        counts = _mm_sub_epi64(counts, _mm_castpd_si128(up));
+        counts = _mm_add_epi64(counts, _mm_castpd_si128(down));
+    }
+    int64_t lanes[2];
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), counts);
+    winding_number = int(lanes[0] + lanes[1]);
+#endif
+    for (; i < edge_count; ++i) {
+        const double start_side = x_vec_[i] * side[0] + y_vec_[i] * side[1] + z_vec_[i] * side[2];
+        const double end_side = x_vec_[i + 1] * side[0] + y_vec_[i + 1] * side[1] + z_vec_[i + 1] * side[2];
+        const double left = normal_x_vec_[i] * p[0] + normal_y_vec_[i] * p[1] + normal_z_vec_[i] * p[2];
+        if (start_side <= 0) {
+            winding_number += end_side > 0 && left > 0;
+        } else {
+            winding_number -= end_side <= 0 && left < 0;
+        }
+    }
+    return winding_number;
+}
+
+std::optional<int> PreparedSphericalPolygon::CalculateWindingNumberLonLat(double lon, double lat) const {
+    double p[3];
+    LonLatToUnitVector(lon, lat, p);
+    return CalculateWindingNumberOnSphere(p[0], p[1], p[2]);
+}
+
+std::optional<int> PreparedSphericalPolygon::CalculateWindingNumberOnSphere(double x, double y, double z) const {
+    if (!closed_) {
+        WINDING_COUNT(kUnclosedPolygons, 1);
+        return std::nullopt;
+    }
+    WINDING_COUNT(kCalls, 1);
+    double p[3] = {x, y, z};
+    Normalize(p);
+    if (fits_in_hemisphere_ && Dot(p, cap_center_) < cap_cos_radius_ - kCapSlack) {
+        WINDING_COUNT(kEarlyRejects, 1);
+        return 0;
+    }
+    WINDING_COUNT(kVertices, normal_x_vec_.size());
+    return CountCrossings(p);
+}
+
+std::vector<std::optional<int>> PreparedSphericalPolygon::CalculateWindingNumbersLonLat(
+        const poly::PointBatch& lon_lat) const {
+    std::vector<std::optional<int>> winding_numbers;
+    winding_numbers.reserve(lon_lat.size());
+    for (size_t i = 0; i < lon_lat.size(); ++i) {
+        winding_numbers.push_back(CalculateWindingNumberLonLat(lon_lat.x_vec_[i], lon_lat.y_vec_[i]));
+    }
+    return winding_numbers;
+}
+
+bool PreparedSphericalPolygon::fits_in_hemisphere() const noexcept {
+    return fits_in_hemisphere_;
+}
+
+}  // namespace winding_number
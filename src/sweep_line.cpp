@@ -0,0 +1,348 @@
+#include <sweep_line.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <list>
+#include <set>
+#include <tuple>
+#include <utility>
+
+#include <edge_bvh.hpp>
+#include <exact_predicates.hpp>
+#include <instrumentation.hpp>
+#include <parallel.hpp>
+
+namespace winding_number {
+namespace {
+
+    // Points sampled per band to place the band boundaries.
+    constexpr size_t kSamplesPerBand = 256;
+
+    // A polygon edge that is not horizontal, from its lower to its upper end. It is active -- crossed by the sweep
+    // line -- for y0 <= y < y1, the half-open rule of edge_crossing.hpp.
+    struct SweepEdge {
+        float x0, y0, x1, y1;
+        int direction;  // +1 if the polygon goes up along it
+    };
+
+    struct SweepPoint {
+        float x, y;
+    };
+
+    // Left to right order of edges active at the same time, and of edges against a point on the sweep line. For edges
+    // that do not cross, whichever of the two starts higher has its lower end within the other's y range, so its side
+    // of the other settles the order; if it touches the other there, its upper end does.
+    class EdgeOrder {
+    public:
+        using is_transparent = void;
+
+        explicit EdgeOrder(const std::vector<SweepEdge>& edges) : edges_(&edges) {}
+
+        bool operator()(uint32_t a, uint32_t b) const {
+            if (a == b) {
+                return false;
+            }
+            const SweepEdge& first = (*edges_)[a];
+            const SweepEdge& second = (*edges_)[b];
+            if (first.y0 >= second.y0) {
+                const int side = SideOf(second, first);
+                return side != 0 ? side > 0 : a < b;
+            }
+            const int side = SideOf(first, second);
+            return side != 0 ? side < 0 : a < b;
+        }
+
+        // An edge comes before a point unless the point is strictly left of it, i.e. unless it crosses the ray.
+        bool operator()(uint32_t edge, const SweepPoint& point) const {
+            return Side((*edges_)[edge], point.x, point.y) <= 0;
+        }
+
+        bool operator()(const SweepPoint& point, uint32_t edge) const {
+            return Side((*edges_)[edge], point.x, point.y) > 0;
+        }
+
+        static int Side(const SweepEdge& edge, float x, float y) {
+            return ExactEdgeSide(edge.x0, edge.y0, edge.x1, edge.y1, x, y);
+        }
+
+    private:
+        // The side of `edge` that `other`, whose lower end is within its y range, is on: +1 for left.
+        static int SideOf(const SweepEdge& edge, const SweepEdge& other) {
+            const int side = Side(edge, other.x0, other.y0);
+            return side != 0 ? side : Side(edge, other.x1, other.y1);
+        }
+
+        const std::vector<SweepEdge>* edges_;
+    };
+
+    using ActiveSet = std::set<uint32_t, EdgeOrder>;
+
+    // Whether two edges cross, or overlap along a common line, either of which breaks EdgeOrder. Touching at a point
+    // does not.
+    bool Cross(const SweepEdge& a, const SweepEdge& b) {
+        const int a0 = EdgeOrder::Side(b, a.x0, a.y0), a1 = EdgeOrder::Side(b, a.x1, a.y1);
+        if (a0 == 0 && a1 == 0) {
+            return std::max(a.y0, b.y0) < std::min(a.y1, b.y1);
+        }
+        const int b0 = EdgeOrder::Side(a, b.x0, b.y0), b1 = EdgeOrder::Side(a, b.x1, b.y1);
+        return a0 * a1 < 0 && b0 * b1 < 0;
+    }
+
+    // Sums of edge directions by rank in the left to right order.
+    class FenwickTree {
+    public:
+        explicit FenwickTree(size_t size) : sums_(size + 1, 0) {}
+
+        void Add(uint32_t rank, int value) {
+            total_ += value;
+            for (size_t i = size_t(rank) + 1; i < sums_.size(); i += i & (~i + 1)) {
+                sums_[i] += value;
+            }
+        }
+
+        // Sum over the ranks >= rank.
+        int SuffixSum(uint32_t rank) const {
+            int prefix = 0;
+            for (size_t i = rank; i > 0; i -= i & (~i + 1)) {
+                prefix += sums_[i];
+            }
+            return total_ - prefix;
+        }
+
+    private:
+        std::vector<int> sums_;
+        int total_ = 0;
+    };
+
+    // The polygon's edges, their sweep events and left to right ranks, and what is needed to find points on its
+    // boundary.
+    struct SweepPolygon {
+        explicit SweepPolygon(const poly::Polygon& polygon) {
+            const size_t edge_count = polygon.size() - 1;
+            if (edge_count > std::numeric_limits<uint32_t>::max()) {
+                // Edges are numbered in 32 bits to keep the active set small; larger polygons use the fallback.
+                return;
+            }
+            for (size_t i = 0; i < edge_count; ++i) {
+                const float x0 = polygon.x_vec_[i], y0 = polygon.y_vec_[i];
+                const float x1 = polygon.x_vec_[i + 1], y1 = polygon.y_vec_[i + 1];
+                vertices.push_back({x0, y0});
+                if (y0 < y1) {
+                    edges.push_back({x0, y0, x1, y1, 1});
+                } else if (y1 < y0) {
+                    edges.push_back({x1, y1, x0, y0, -1});
+                } else {
+                    horizontal.push_back({y0, std::min(x0, x1), std::max(x0, x1)});
+                }
+            }
+            std::sort(vertices.begin(), vertices.end());
+            std::sort(horizontal.begin(), horizontal.end());
+
+            by_start.resize(edges.size());
+            for (uint32_t e = 0; e < edges.size(); ++e) {
+                by_start[e] = e;
+            }
+            by_end = by_start;
+            std::sort(by_start.begin(), by_start.end(),
+                      [this](uint32_t a, uint32_t b) { return edges[a].y0 < edges[b].y0; });
+            std::sort(by_end.begin(), by_end.end(),
+                      [this](uint32_t a, uint32_t b) { return edges[a].y1 < edges[b].y1; });
+            simple = RankEdges();
+        }
+
+        // Sweeps the edges alone (Shamos and Hoey): if any two cross, two that are next to each other in the active
+        // set do, before the sweep passes the crossing, so only new neighbours need checking. Meanwhile each edge is
+        // put right after its left neighbour in a list, which ends up in an order that agrees with the active set at
+        // every moment. Returns false, with no ranks, if edges cross.
+        bool RankEdges() {
+            ActiveSet active{EdgeOrder(edges)};
+            std::vector<ActiveSet::iterator> positions(edges.size());
+            std::list<uint32_t> order;
+            std::vector<std::list<uint32_t>::iterator> order_positions(edges.size());
+            auto cross = [this](ActiveSet::iterator a, ActiveSet::iterator b) { return Cross(edges[*a], edges[*b]); };
+
+            size_t next_start = 0, next_end = 0;
+            while (next_start < by_start.size()) {
+                // Edges end before others start at the same y.
+                if (edges[by_end[next_end]].y1 <= edges[by_start[next_start]].y0) {
+                    const auto it = positions[by_end[next_end++]];
+                    const auto after = active.erase(it);
+                    if (after != active.begin() && after != active.end() && cross(std::prev(after), after)) {
+                        return false;
+                    }
+                    continue;
+                }
+                const uint32_t e = by_start[next_start++];
+                const auto it = active.insert(e).first;
+                positions[e] = it;
+                if (it == active.begin()) {
+                    order_positions[e] = order.insert(order.begin(), e);
+                } else {
+                    if (cross(std::prev(it), it)) {
+                        return false;
+                    }
+                    order_positions[e] = order.insert(std::next(order_positions[*std::prev(it)]), e);
+                }
+                if (std::next(it) != active.end() && cross(it, std::next(it))) {
+                    return false;
+                }
+            }
+            ranks.resize(edges.size());
+            uint32_t rank = 0;
+            for (uint32_t e : order) {
+                ranks[e] = rank++;
+            }
+            return true;
+        }
+
+        // Whether the point is a vertex or on a horizontal edge. Points on other edges are found by the sweep.
+        bool OnVertexOrHorizontalEdge(float x, float y) const {
+            if (std::binary_search(vertices.begin(), vertices.end(), std::make_pair(x, y))) {
+                return true;
+            }
+            auto it = std::lower_bound(horizontal.begin(), horizontal.end(),
+                                       std::make_tuple(y, -std::numeric_limits<float>::infinity(), 0.f));
+            for (; it != horizontal.end() && std::get<0>(*it) == y && std::get<1>(*it) <= x; ++it) {
+                if (x <= std::get<2>(*it)) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        std::vector<SweepEdge> edges;
+        std::vector<uint32_t> by_start;  // edges by y0
+        std::vector<uint32_t> by_end;    // edges by y1
+        std::vector<uint32_t> ranks;
+        bool simple = false;
+        std::vector<std::pair<float, float>> vertices;
+        std::vector<std::tuple<float, float, float>> horizontal;  // y, lowest x, highest x
+    };
+
+    // Sweeps one band of points, given in increasing y, from the y of its first point. Points on the boundary are left
+    // to the fallback.
+    void SweepBand(const SweepPolygon& polygon, const poly::PointBatch& points, const std::vector<size_t>& band,
+                   const EdgeBvh& fallback, std::vector<std::optional<int>>& winding_numbers) {
+        if (band.empty()) {
+            return;
+        }
+        const auto& edges = polygon.edges;
+        ActiveSet active{EdgeOrder(edges)};
+        std::vector<ActiveSet::iterator> positions(edges.size());
+        std::vector<char> inserted(edges.size(), 0);
+        FenwickTree directions(edges.size());
+        auto insert = [&](uint32_t e) {
+            positions[e] = active.insert(e).first;
+            inserted[e] = 1;
+            directions.Add(polygon.ranks[e], edges[e].direction);
+        };
+
+        // Edges already active where the band starts.
+        const float start_y = points.y_vec_[band.front()];
+        size_t next_start = 0;
+        for (; next_start < edges.size() && edges[polygon.by_start[next_start]].y0 <= start_y; ++next_start) {
+            const uint32_t e = polygon.by_start[next_start];
+            if (edges[e].y1 > start_y) {
+                insert(e);
+            }
+        }
+        size_t next_end = std::upper_bound(polygon.by_end.begin(), polygon.by_end.end(), start_y,
+                                           [&edges](float y, uint32_t e) { return y < edges[e].y1; }) -
+                          polygon.by_end.begin();
+
+        size_t on_boundary = 0;
+        for (size_t i : band) {
+            const SweepPoint point{points.x_vec_[i], points.y_vec_[i]};
+            while (true) {
+                const bool can_end = next_end < edges.size() && edges[polygon.by_end[next_end]].y1 <= point.y;
+                const bool can_start = next_start < edges.size() && edges[polygon.by_start[next_start]].y0 <= point.y;
+                if (can_end && (!can_start || edges[polygon.by_end[next_end]].y1 <=
+                                                      edges[polygon.by_start[next_start]].y0)) {
+                    const uint32_t e = polygon.by_end[next_end++];
+                    if (inserted[e]) {
+                        active.erase(positions[e]);
+                        directions.Add(polygon.ranks[e], -edges[e].direction);
+                        inserted[e] = 0;
+                    }
+                } else if (can_start) {
+                    // Edges that also end before the point never need to be in the set.
+                    const uint32_t e = polygon.by_start[next_start++];
+                    if (edges[e].y1 > point.y) {
+                        insert(e);
+                    }
+                } else {
+                    break;
+                }
+            }
+
+            const auto right = active.lower_bound(point);
+            if (polygon.OnVertexOrHorizontalEdge(point.x, point.y) ||
+                (right != active.begin() && EdgeOrder::Side(edges[*std::prev(right)], point.x, point.y) == 0)) {
+                winding_numbers[i] = fallback.CalculateWindingNumber2D(point.x, point.y);
+                ++on_boundary;
+                continue;
+            }
+            winding_numbers[i] = right == active.end() ? 0 : directions.SuffixSum(polygon.ranks[*right]);
+        }
+        WINDING_COUNT(kCalls, band.size());
+        WINDING_COUNT(kOnEdge, on_boundary);
+    }
+
+}  // namespace
+
+std::vector<std::optional<int>> CalculateWindingNumbersBySweep(const poly::PointBatch& points,
+                                                               const poly::Polygon& polygon, float tolerance,
+                                                               size_t thread_count) {
+    std::vector<std::optional<int>> winding_numbers(points.size());
+    if (polygon.size() == 0 || !polygon.IsClosed(tolerance)) {
+        WINDING_COUNT(kUnclosedPolygons, points.size());
+        return winding_numbers;
+    }
+    const EdgeBvh fallback(polygon, tolerance);
+    const SweepPolygon sweep(polygon);
+    if (!sweep.simple) {
+        ParallelFor(
+                points.size(),
+                [&](size_t i) {
+                    winding_numbers[i] = fallback.CalculateWindingNumber2D(points.x_vec_[i], points.y_vec_[i]);
+                },
+                thread_count);
+        return winding_numbers;
+    }
+
+    // Band boundaries at quantiles of a sample of the points' y.
+    if (thread_count == 0) {
+        thread_count = DefaultThreadCount();
+    }
+    const size_t band_count = std::max<size_t>(std::min(thread_count, points.size() / kSamplesPerBand), 1);
+    std::vector<float> sample;
+    const size_t stride = std::max<size_t>(points.size() / (band_count * kSamplesPerBand), 1);
+    for (size_t i = 0; i < points.size(); i += stride) {
+        sample.push_back(points.y_vec_[i]);
+    }
+    std::sort(sample.begin(), sample.end());
+    std::vector<float> band_bottoms;
+    for (size_t b = 1; b < band_count; ++b) {
+        band_bottoms.push_back(sample[sample.size() * b / band_count]);
+    }
+
+    std::vector<std::vector<size_t>> bands(band_count);
+    for (size_t i = 0; i < points.size(); ++i) {
+        const size_t b = std::upper_bound(band_bottoms.begin(), band_bottoms.end(), points.y_vec_[i]) -
+                         band_bottoms.begin();
+        bands[b].push_back(i);
+    }
+    ParallelFor(
+            band_count,
+            [&](size_t b) {
+                std::sort(bands[b].begin(), bands[b].end(),
+                          [&points](size_t i, size_t j) { return points.y_vec_[i] < points.y_vec_[j]; });
+                SweepBand(sweep, points, bands[b], fallback, winding_numbers);
+            },
+            band_count);
+    return winding_numbers;
+}
+
+}  // namespace winding_number
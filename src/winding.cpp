@@ -7,21 +7,42 @@
 
 
 #include <winding.hpp>
+#include <convex_polygon.hpp>
+#include <edge_bvh.hpp>
+#include <edge_crossing.hpp>
+#include <instrumentation.hpp>
+#include <polygon_arrangement.hpp>
+#include <prepared_edges.hpp>
+#include <simd_polygon.hpp>
+#include <simple_polygon.hpp>
+#include <small_polygon.hpp>
 #include <math.h> //for sqrt
+#include <algorithm>
+#include <chrono>
+#include <functional>
 #include <utility>
 
 namespace winding_number {
 namespace {
 
-//Base Code
-class BadWindingNumberAlgorithm : public IWindingNumberAlgorithm {
-    std::optional<int> CalculateWindingNumber2D(float x, float y, poly::Polygon polygon) override {
-        // Clearly we can do better...
-        error_message("Unimplemented algorithm.");
-        return std::nullopt;
+// Sums the crossings of every edge of every ring, in one pass over the multipolygon's contiguous storage.
+int MultiPolygonWindingNumber(float x, float y, const poly::MultiPolygon& multi_polygon) {
+    int winding_number = 0;
+    int contacts = 0;
+    const float* xs = multi_polygon.x_vec_.data();
+    const float* ys = multi_polygon.y_vec_.data();
+    for (size_t ring = 0; ring < multi_polygon.ring_count(); ++ring) {
+        const size_t last = multi_polygon.ring_offsets_[ring + 1] - 1;
+        for (size_t i = multi_polygon.ring_offsets_[ring]; i < last; ++i) {
+            contacts += EdgeContainsPoint(xs[i], ys[i], xs[i + 1], ys[i + 1], x, y);
+            winding_number += EdgeCrossing(xs[i], ys[i], xs[i + 1], ys[i + 1], x, y);
+        }
     }
-};
-
+    WINDING_COUNT(kCalls, 1);
+    WINDING_COUNT(kVertices, multi_polygon.size());
+    WINDING_COUNT(kOnEdge, contacts > 0);
+    return contacts > 0 ? contacts : winding_number;
+}
 
 //Improved Code
 class ImprovedWindingNumberAlgorithm : public IWindingNumberAlgorithm {  
@@ -63,11 +84,39 @@ class ImprovedWindingNumberAlgorithm : public IWindingNumberAlgorithm {
    //  because if a line goes through a point, we cannot say which direction (clockwise or counter clockwise) the line
    //  goes without having scanning for further information about the closed curve.
 
+public:
+    using IWindingNumberAlgorithm::CalculateWindingNumber2D;
+    using IWindingNumberAlgorithm::CalculateWindingNumbers2D;
+
+    std::string name() const override {
+        return "improved";
+    }
+
     std::optional<int> CalculateWindingNumber2D(float x, float y, poly::Polygon polygon) override {
+        WINDING_TIME_CALL();
+        return Calculate(x, y, polygon);
+    }
+
+    std::vector<std::optional<int>> CalculateWindingNumbers2D(const poly::PointBatch& points,
+                                                              const poly::Polygon& polygon) override {
+        WINDING_TIME_CALL();
+        std::vector<std::optional<int>> winding_numbers;
+        winding_numbers.reserve(points.size());
+        for (size_t i = 0; i < points.size(); ++i) {
+            winding_numbers.push_back(Calculate(points.x_vec_[i], points.y_vec_[i], polygon));
+        }
+        return winding_numbers;
+    }
+
+private:
+    std::optional<int> Calculate(float x, float y, const poly::Polygon& polygon) const {
         //Base case when the expected closed curve line is not a closed curve or a point
         if(!polygon.IsClosed(tolerance())){ 
+           WINDING_COUNT(kUnclosedPolygons, 1);
            return std::nullopt;
         } 
+        WINDING_COUNT(kCalls, 1);
+        WINDING_COUNT(kVertices, polygon.size());
         
 
         int windingNumber = 0; //we initialize a counter first
@@ -190,16 +239,430 @@ class ImprovedWindingNumberAlgorithm : public IWindingNumberAlgorithm {
             y0 = y1;
          
         }   //end for loop
+        WINDING_COUNT(kOnEdge, onEdge);
         return windingNumber; 
     }
 };
 
+
+const char* const kUnclosedPolygon = "The polygon must be closed.";
+
+bool IsClosed(const poly::Polygon& polygon, float tolerance) {
+    return polygon.size() > 0 && polygon.IsClosed(tolerance);
+}
+
+// The rules of edge_crossing.hpp applied edge by edge, with nothing prepared up front.
+class ScalarWindingNumberAlgorithm : public IWindingNumberAlgorithm {
+public:
+    using IWindingNumberAlgorithm::CalculateWindingNumber2D;
+    using IWindingNumberAlgorithm::CalculateWindingNumbers2D;
+
+    std::string name() const override {
+        return "scalar";
+    }
+
+    std::optional<int> CalculateWindingNumber2D(float x, float y, poly::Polygon polygon) override {
+        WINDING_TIME_CALL();
+        if (!IsClosed(polygon, tolerance())) {
+            WINDING_COUNT(kUnclosedPolygons, 1);
+            error_message(kUnclosedPolygon);
+            return std::nullopt;
+        }
+        return Calculate(x, y, polygon);
+    }
+
+    std::vector<std::optional<int>> CalculateWindingNumbers2D(const poly::PointBatch& points,
+                                                              const poly::Polygon& polygon) override {
+        WINDING_TIME_CALL();
+        if (!IsClosed(polygon, tolerance())) {
+            WINDING_COUNT(kUnclosedPolygons, points.size());
+            error_message(kUnclosedPolygon);
+            return std::vector<std::optional<int>>(points.size());
+        }
+        std::vector<std::optional<int>> winding_numbers;
+        winding_numbers.reserve(points.size());
+        for (size_t i = 0; i < points.size(); ++i) {
+            winding_numbers.push_back(Calculate(points.x_vec_[i], points.y_vec_[i], polygon));
+        }
+        return winding_numbers;
+    }
+
+private:
+    static int Calculate(float x, float y, const poly::Polygon& polygon) {
+        int winding_number = 0;
+        int contacts = 0;
+        const float* xs = polygon.x_vec_.data();
+        const float* ys = polygon.y_vec_.data();
+        for (size_t i = 0; i + 1 < polygon.size(); ++i) {
+            contacts += EdgeContainsPoint(xs[i], ys[i], xs[i + 1], ys[i + 1], x, y);
+            winding_number += EdgeCrossing(xs[i], ys[i], xs[i + 1], ys[i + 1], x, y);
+        }
+        WINDING_COUNT(kCalls, 1);
+        WINDING_COUNT(kVertices, polygon.size());
+        WINDING_COUNT(kOnEdge, contacts > 0);
+        return contacts > 0 ? contacts : winding_number;
+    }
+};
+
+// SimdPolygon's kernels behind the same calls as EdgeBvh and PreparedEdges.
+class SimdEngine {
+public:
+    SimdEngine(const poly::Polygon& polygon, float tolerance) : polygon_(polygon, tolerance) {}
+
+    std::optional<int> CalculateWindingNumber2D(float x, float y) const {
+        return winding_number::CalculateWindingNumber2D(x, y, polygon_);
+    }
+
+    std::vector<std::optional<int>> CalculateWindingNumbers2D(const poly::PointBatch& points) const {
+        return winding_number::CalculateWindingNumbers2D(points, polygon_);
+    }
+
+private:
+    poly::SimdPolygon polygon_;
+};
+
+// A handle that owns a prepared engine, or nothing if the polygon was not closed.
+template <typename Engine>
+class PreparedPolygon : public IPreparedPolygon {
+public:
+    explicit PreparedPolygon(std::optional<Engine> engine) : engine_(std::move(engine)) {}
+
+    std::optional<int> CalculateWindingNumber2D(float x, float y) const override {
+        WINDING_TIME_CALL();
+        if (!engine_) {
+            WINDING_COUNT(kUnclosedPolygons, 1);
+            return std::nullopt;
+        }
+        return engine_->CalculateWindingNumber2D(x, y);
+    }
+
+    std::vector<std::optional<int>> CalculateWindingNumbers2D(const poly::PointBatch& points) const override {
+        WINDING_TIME_CALL();
+        if (!engine_) {
+            WINDING_COUNT(kUnclosedPolygons, points.size());
+            return std::vector<std::optional<int>>(points.size());
+        }
+        return engine_->CalculateWindingNumbers2D(points);
+    }
+
+private:
+    std::optional<Engine> engine_;
+};
+
+// A handle for algorithms that prepare nothing: it keeps a copy of the polygon and passes it on every query.
+class CopiedPolygon : public IPreparedPolygon {
+public:
+    CopiedPolygon(IWindingNumberAlgorithm& algorithm, const poly::Polygon& polygon) :
+            algorithm_(&algorithm), polygon_(polygon) {}
+
+    std::optional<int> CalculateWindingNumber2D(float x, float y) const override {
+        return algorithm_->CalculateWindingNumber2D(x, y, polygon_);
+    }
+
+    std::vector<std::optional<int>> CalculateWindingNumbers2D(const poly::PointBatch& points) const override {
+        return algorithm_->CalculateWindingNumbers2D(points, polygon_);
+    }
+
+private:
+    IWindingNumberAlgorithm* algorithm_;
+    poly::Polygon polygon_;
+};
+
+// Adapts an engine that prepares a polygon once -- EdgeBvh, PolygonArrangement, PreparedEdges, ConvexPolygon,
+// SimplePolygon, SmallPolygon or SimdPolygon -- to the interface. Prepare() hands out an engine of its own. Calls that
+// pass the polygon keep the last engine until a call brings a different polygon or tolerance, so consecutive calls on
+// the same polygon only pay for copying it and comparing it with the kept copy.
+template <typename Engine>
+class PreparedWindingNumberAlgorithm : public IWindingNumberAlgorithm {
+public:
+    using IWindingNumberAlgorithm::CalculateWindingNumber2D;
+    using IWindingNumberAlgorithm::CalculateWindingNumbers2D;
+    using Build = std::function<Engine(const poly::Polygon&, float)>;
+
+    PreparedWindingNumberAlgorithm(std::string name, Build build) : name_(std::move(name)), build_(std::move(build)) {}
+
+    std::string name() const override {
+        return name_;
+    }
+
+    std::optional<int> CalculateWindingNumber2D(float x, float y, poly::Polygon polygon) override {
+        WINDING_TIME_CALL();
+        const Engine* engine = Cached(polygon);
+        if (!engine) {
+            WINDING_COUNT(kUnclosedPolygons, 1);
+            return std::nullopt;
+        }
+        return engine->CalculateWindingNumber2D(x, y);
+    }
+
+    std::vector<std::optional<int>> CalculateWindingNumbers2D(const poly::PointBatch& points,
+                                                              const poly::Polygon& polygon) override {
+        WINDING_TIME_CALL();
+        const Engine* engine = Cached(polygon);
+        if (!engine) {
+            WINDING_COUNT(kUnclosedPolygons, points.size());
+            return std::vector<std::optional<int>>(points.size());
+        }
+        return engine->CalculateWindingNumbers2D(points);
+    }
+
+    std::unique_ptr<IPreparedPolygon> Prepare(const poly::Polygon& polygon) override {
+        std::optional<Engine> engine;
+        if (IsClosed(polygon, tolerance())) {
+            engine.emplace(build_(polygon, tolerance()));
+        } else {
+            error_message(kUnclosedPolygon);
+        }
+        return std::make_unique<PreparedPolygon<Engine>>(std::move(engine));
+    }
+
+private:
+    // Returns the engine kept for this polygon, preparing it if it is not the last one, or nullptr if the polygon is
+    // not closed.
+    const Engine* Cached(const poly::Polygon& polygon) {
+        if (!IsClosed(polygon, tolerance())) {
+            error_message(kUnclosedPolygon);
+            return nullptr;
+        }
+        if (!engine_ || engine_tolerance_ != tolerance() || polygon.x_vec_ != polygon_.x_vec_ ||
+            polygon.y_vec_ != polygon_.y_vec_) {
+            engine_.reset();
+            polygon_ = polygon;
+            engine_tolerance_ = tolerance();
+            engine_.emplace(build_(polygon_, engine_tolerance_));
+        }
+        return &*engine_;
+    }
+
+    std::string name_;
+    Build build_;
+    poly::Polygon polygon_;
+    float engine_tolerance_ = 0.f;
+    std::optional<Engine> engine_;
+};
+
+template <typename Engine>
+std::unique_ptr<IWindingNumberAlgorithm> MakePrepared(std::string name,
+                                                      typename PreparedWindingNumberAlgorithm<Engine>::Build build) {
+    return std::make_unique<PreparedWindingNumberAlgorithm<Engine>>(std::move(name), std::move(build));
+}
+
+struct Registration {
+    AlgorithmInfo info;
+    std::function<std::unique_ptr<IWindingNumberAlgorithm>()> create;
+};
+
+// Every algorithm Create() can return. The first one is the default.
+const std::vector<Registration>& Registry() {
+    static const std::vector<Registration> registry = {
+            {{"improved", "Normalized vectors around the point, quadrant by quadrant.", Precision::kFast},
+             [] { return std::make_unique<ImprovedWindingNumberAlgorithm>(); }},
+            {{"scalar", "Ray crossings of every edge, with nothing prepared.", Precision::kExactBoundary},
+             [] { return std::make_unique<ScalarWindingNumberAlgorithm>(); }},
+            {{"simd", "Float ray crossings of four edges at a time (SimdPolygon).", Precision::kFast},
+             [] {
+                 return MakePrepared<SimdEngine>(
+                         "simd", [](const poly::Polygon& polygon, float tolerance) {
+                             return SimdEngine(polygon, tolerance);
+                         });
+             }},
+            {{"prepared_slope", "Per-edge slopes in float (PreparedEdges, EdgeForm::kSlope).", Precision::kFast},
+             [] {
+                 return MakePrepared<PreparedEdges>(
+                         "prepared_slope", [](const poly::Polygon& polygon, float tolerance) {
+                             return PreparedEdges(polygon, EdgeForm::kSlope, tolerance);
+                         });
+             }},
+            {{"prepared_line", "Per-edge extents in double (PreparedEdges, EdgeForm::kLine).",
+              Precision::kExactBoundary},
+             [] {
+                 return MakePrepared<PreparedEdges>(
+                         "prepared_line", [](const poly::Polygon& polygon, float tolerance) {
+                             return PreparedEdges(polygon, EdgeForm::kLine, tolerance);
+                         });
+             }},
+            {{"small", "Kernels unrolled for 3 to 8 edges, and bounds tests for rectangles (SmallPolygon).",
+              Precision::kExactBoundary},
+             [] {
+                 return MakePrepared<SmallPolygon>(
+                         "small", [](const poly::Polygon& polygon, float tolerance) {
+                             return SmallPolygon(polygon, tolerance);
+                         });
+             }},
+            {{"convex", "Binary search of the fan around a corner of a convex polygon (ConvexPolygon).",
+              Precision::kExactBoundary},
+             [] {
+                 return MakePrepared<ConvexPolygon>(
+                         "convex", [](const poly::Polygon& polygon, float tolerance) {
+                             return ConvexPolygon(polygon, tolerance);
+                         });
+             }},
+            {{"simple", "Crossing parity times the orientation of a simple polygon (SimplePolygon).",
+              Precision::kExactBoundary},
+             [] {
+                 return MakePrepared<SimplePolygon>(
+                         "simple", [](const poly::Polygon& polygon, float tolerance) {
+                             return SimplePolygon(polygon, tolerance);
+                         });
+             }},
+            {{"bvh", "Bounding volume hierarchy over y-monotone chains (EdgeBvh).", Precision::kExactBoundary},
+             [] {
+                 return MakePrepared<EdgeBvh>(
+                         "bvh", [](const poly::Polygon& polygon, float tolerance) {
+                             return EdgeBvh(polygon, tolerance);
+                         });
+             }},
+            {{"arrangement", "Point location in the slabs between vertices and crossings (PolygonArrangement).",
+              Precision::kExactBoundary},
+             [] {
+                 return MakePrepared<PolygonArrangement>(
+                         "arrangement", [](const poly::Polygon& polygon, float tolerance) {
+                             return PolygonArrangement(polygon, tolerance);
+                         });
+             }},
+    };
+    return registry;
+}
+
+bool MeetsPrecision(const AlgorithmInfo& info, Precision precision) {
+    return precision == Precision::kFast || info.precision == Precision::kExactBoundary;
+}
+
 }  // namespace poly
 
 std::unique_ptr<IWindingNumberAlgorithm> IWindingNumberAlgorithm::Create() {
     return std::make_unique<ImprovedWindingNumberAlgorithm>(); //improved winding number algorithm
 }
 
+std::unique_ptr<IWindingNumberAlgorithm> IWindingNumberAlgorithm::Create(std::string_view name) {
+    for (const auto& registration : Registry()) {
+        if (registration.info.name == name) {
+            return registration.create();
+        }
+    }
+    return nullptr;
+}
+
+std::unique_ptr<IWindingNumberAlgorithm> IWindingNumberAlgorithm::Create(const AlgorithmHints& hints) {
+    // Preparing a polygon costs a few passes over it, so it only pays off once several points share the polygon.
+    // Measured on polygons of 3 to 16k vertices: the unrolled kernels win for polygons they cover, per-edge
+    // coefficients for other small polygons queried by large batches, and the BVH wins everywhere else once a polygon
+    // has more than a few dozen edges. All four picks meet Precision::kExactBoundary, so the precision hint only
+    // matters to autotuning.
+    const size_t n = hints.polygon_size;
+    if (hints.batch_size < 4) {
+        return Create("scalar");
+    }
+    if (n != 0 && n <= SmallPolygon::kMaxEdges + 1) {
+        return Create(hints.batch_size < 16 ? "scalar" : "small");
+    }
+    if (n != 0 && n <= 32) {
+        return Create(hints.batch_size < 64 ? "scalar" : "prepared_line");
+    }
+    if (n != 0 && n < 128 && hints.batch_size < 16) {
+        return Create("scalar");
+    }
+    return Create("bvh");
+}
+
+std::unique_ptr<IWindingNumberAlgorithm> IWindingNumberAlgorithm::Create(const AlgorithmHints& hints,
+                                                                         const poly::Polygon& sample_polygon,
+                                                                         const poly::PointBatch& sample_points) {
+    // Each candidate is timed from a fresh instance, so that the time includes preparing the polygon, and the best of
+    // a few runs is kept to filter out noise.
+    constexpr int kRuns = 3;
+    const Registration* best = nullptr;
+    auto best_time = std::chrono::steady_clock::duration::max();
+    for (const auto& registration : Registry()) {
+        if (!MeetsPrecision(registration.info, hints.precision)) {
+            continue;
+        }
+        auto time = std::chrono::steady_clock::duration::max();
+        for (int run = 0; run < kRuns; ++run) {
+            const auto start = std::chrono::steady_clock::now();
+            auto algorithm = registration.create();
+            auto winding_numbers = algorithm->CalculateWindingNumbers2D(sample_points, sample_polygon);
+            time = std::min(time, std::chrono::steady_clock::now() - start);
+        }
+        if (time < best_time) {
+            best = &registration;
+            best_time = time;
+        }
+    }
+    return best->create();
+}
+
+std::vector<AlgorithmInfo> IWindingNumberAlgorithm::Algorithms() {
+    std::vector<AlgorithmInfo> algorithms;
+    for (const auto& registration : Registry()) {
+        algorithms.push_back(registration.info);
+    }
+    return algorithms;
+}
+
+std::vector<std::optional<int>> IWindingNumberAlgorithm::CalculateWindingNumbers2D(const poly::PointBatch& points,
+                                                                                   const poly::Polygon& polygon) {
+    std::vector<std::optional<int>> winding_numbers;
+    winding_numbers.reserve(points.size());
+    for (size_t i = 0; i < points.size(); ++i) {
+        winding_numbers.push_back(CalculateWindingNumber2D(points.x_vec_[i], points.y_vec_[i], polygon));
+    }
+    return winding_numbers;
+}
+
+std::optional<int> IWindingNumberAlgorithm::CalculateWindingNumber2D(float x, float y,
+                                                                     const poly::MultiPolygon& multi_polygon) {
+    WINDING_TIME_CALL();
+    if (!multi_polygon.IsClosed(tolerance())) {
+        WINDING_COUNT(kUnclosedPolygons, 1);
+        error_message("Every ring of the multipolygon must be closed.");
+        return std::nullopt;
+    }
+    return MultiPolygonWindingNumber(x, y, multi_polygon);
+}
+
+std::vector<std::optional<int>> IWindingNumberAlgorithm::CalculateWindingNumbers2D(
+        const poly::PointBatch& points, const poly::MultiPolygon& multi_polygon) {
+    WINDING_TIME_CALL();
+    if (!multi_polygon.IsClosed(tolerance())) {
+        WINDING_COUNT(kUnclosedPolygons, points.size());
+        error_message("Every ring of the multipolygon must be closed.");
+        return std::vector<std::optional<int>>(points.size());
+    }
+    std::vector<std::optional<int>> winding_numbers(points.size(), 0);
+    if (multi_polygon.size() == 0) {
+        return winding_numbers;
+    }
+    auto [min_x, max_x] = std::minmax_element(multi_polygon.x_vec_.begin(), multi_polygon.x_vec_.end());
+    auto [min_y, max_y] = std::minmax_element(multi_polygon.y_vec_.begin(), multi_polygon.y_vec_.end());
+    for (size_t i = 0; i < points.size(); ++i) {
+        const float x = points.x_vec_[i], y = points.y_vec_[i];
+        if (x >= *min_x && x <= *max_x && y >= *min_y && y <= *max_y) {
+            winding_numbers[i] = MultiPolygonWindingNumber(x, y, multi_polygon);
+        } else {
+            WINDING_COUNT(kEarlyRejects, 1);
+        }
+    }
+    return winding_numbers;
+}
+
+std::vector<std::optional<int>> IPreparedPolygon::CalculateWindingNumbers2D(const poly::PointBatch& points) const {
+    std::vector<std::optional<int>> winding_numbers;
+    winding_numbers.reserve(points.size());
+    for (size_t i = 0; i < points.size(); ++i) {
+        winding_numbers.push_back(CalculateWindingNumber2D(points.x_vec_[i], points.y_vec_[i]));
+    }
+    return winding_numbers;
+}
+
+std::unique_ptr<IPreparedPolygon> IWindingNumberAlgorithm::Prepare(const poly::Polygon& polygon) {
+    return std::make_unique<CopiedPolygon>(*this, polygon);
+}
+
+std::string IWindingNumberAlgorithm::name() const {
+    return {};
+}
+
 void IWindingNumberAlgorithm::tolerance(float tolerance) noexcept {
     tolerance_ = tolerance;
 }
@@ -0,0 +1,93 @@
+#include <winding_accumulator.hpp>
+
+#include <cmath>
+#include <utility>
+#include <vector>
+
+#include <instrumentation.hpp>
+
+namespace winding_number {
+namespace {
+
+    // Keeps the winding number of every record that parsed, in order.
+    class CollectingSink : public poly::IRecordSink {
+    public:
+        explicit CollectingSink(float tolerance) : accumulator_(tolerance) {}
+
+        void StartRecord(float point_x, float point_y) override {
+            accumulator_.StartRecord(point_x, point_y);
+        }
+        void AppendPoint(float x, float y) override {
+            accumulator_.AppendPoint(x, y);
+        }
+        void EndRecord() override {
+            accumulator_.EndRecord();
+            winding_numbers_.push_back(accumulator_.winding_number());
+        }
+
+        const std::vector<std::optional<int>>& winding_numbers() const noexcept {
+            return winding_numbers_;
+        }
+
+    private:
+        WindingAccumulator accumulator_;
+        std::vector<std::optional<int>> winding_numbers_;
+    };
+
+}  // namespace
+
+WindingAccumulator::WindingAccumulator(float tolerance) : tolerance_(tolerance) {}
+
+void WindingAccumulator::EndRecord() {
+    const auto result = winding_number();
+    WINDING_COUNT(kUnclosedPolygons, !result);
+    if (result) {
+        WINDING_COUNT(kCalls, 1);
+        WINDING_COUNT(kVertices, size_);
+        WINDING_COUNT(kOnEdge, contacts_ > 0);
+    }
+}
+
+std::optional<int> WindingAccumulator::winding_number() const noexcept {
+    if (size_ == 0 || std::abs(first_x_ - last_x_) > tolerance_ || std::abs(first_y_ - last_y_) > tolerance_) {
+        return std::nullopt;
+    }
+    return contacts_ > 0 ? contacts_ : crossings_;
+}
+
+size_t WindingAccumulator::size() const noexcept {
+    return size_;
+}
+
+poly::ParseResult<std::optional<int>> CalculateWindingNumberFromString(std::string_view polygon_string,
+                                                                       poly::IPolygonReader& reader,
+                                                                       float tolerance) {
+    WindingAccumulator accumulator(tolerance);
+    auto parsed = reader.TryStreamPointAndPolygonFromString(polygon_string, accumulator);
+    poly::ParseResult<std::optional<int>> result;
+    result.status = parsed.status;
+    result.error_position = parsed.error_position;
+    result.error_message = std::move(parsed.error_message);
+    if (result.ok()) {
+        result.record = {std::get<0>(parsed.record), std::get<1>(parsed.record), accumulator.winding_number()};
+    }
+    return result;
+}
+
+poly::ReadResult<std::optional<int>> CalculateWindingNumbersFromFile(std::string_view filepath,
+                                                                     poly::IPolygonReader& reader, float tolerance) {
+    CollectingSink sink(tolerance);
+    auto read = reader.TryStreamPointsAndPolygonsFromFile(filepath, sink);
+    poly::ReadResult<std::optional<int>> result;
+    result.status = read.status;
+    result.statistics = std::move(read.statistics);
+    result.error_message = std::move(read.error_message);
+    result.records.reserve(read.records.size());
+    for (size_t i = 0; i < read.records.size(); ++i) {
+        result.records.emplace_back(std::get<0>(read.records[i]), std::get<1>(read.records[i]),
+                                    sink.winding_numbers()[i]);
+    }
+    return result;
+}
+
+}  // namespace winding_number
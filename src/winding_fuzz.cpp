@@ -0,0 +1,482 @@
+// winding_fuzz is a differential test harness: it generates random and adversarial polygons and points, runs every
+// winding number engine in the library on them, and checks each result against an exact arithmetic reference.
+//
+// Each disagreement is shrunk to a small polygon that still disagrees and printed as a record in the polygons.txt
+// format, preceded by a '#' line naming the engine and both results. The exit code is 1 if anything disagreed.
+
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <edge_crossing.hpp>
+#include <exact_predicates.hpp>
+#include <parallel.hpp>
+#include <point_batch.hpp>
+#include <polygon_lanes.hpp>
+#include <poly_io.hpp>
+#include <winding.hpp>
+
+namespace {
+
+using poly::PointBatch;
+using poly::Polygon;
+using Results = std::vector<std::optional<int>>;
+
+constexpr double kPi = 3.14159265358979323846;
+
+const char* kUsage =
+        "usage: winding_fuzz [options]\n"
+        "  --seconds S      stop after S seconds (default 10)\n"
+        "  --cases N        stop after N point/polygon cases, 0 for no limit (default 0)\n"
+        "  --threads N      worker threads, 0 for one per hardware thread (default 0)\n"
+        "  --seed N         random seed (default 1)\n"
+        "  --max-reports N  disagreements to print (default 10)\n";
+
+struct Options {
+    double seconds = 10.0;
+    uint64_t cases = 0;
+    size_t threads = 0;
+    uint64_t seed = 1;
+    uint64_t max_reports = 10;
+};
+
+// What an engine promises about points on, or very close to, the boundary.
+enum class Boundary {
+    kExact,  // reports the same number of boundary passes as the reference
+    kSkip,   // makes no promise about boundary points
+};
+
+struct Engine {
+    std::string name;
+    Boundary boundary;
+    // Points closer than slack times the polygon's scale to an edge they are not on are not compared.
+    double slack;
+    std::function<Results(const Polygon&, const PointBatch&)> evaluate;
+};
+
+// Every registered algorithm, plus the multipolygon path of the default algorithm with a single ring, and PolygonLanes
+// holding just the one polygon.
+std::vector<Engine> Engines() {
+    std::vector<Engine> engines;
+    for (const auto& info : winding_number::IWindingNumberAlgorithm::Algorithms()) {
+        const bool exact = info.precision == winding_number::Precision::kExactBoundary;
+        engines.push_back({info.name, exact ? Boundary::kExact : Boundary::kSkip, exact ? 1e-12 : 1e-5,
+                           [name = info.name](const Polygon& polygon, const PointBatch& points) {
+                               return winding_number::IWindingNumberAlgorithm::Create(name)->CalculateWindingNumbers2D(
+                                       points, polygon);
+                           }});
+    }
+    engines.push_back({"multi_polygon", Boundary::kExact, 1e-12, [](const Polygon& polygon, const PointBatch& points) {
+                           poly::MultiPolygon multi_polygon;
+                           multi_polygon.AppendRing(polygon);
+                           return winding_number::IWindingNumberAlgorithm::Create()->CalculateWindingNumbers2D(
+                                   points, multi_polygon);
+                       }});
+    engines.push_back({"lanes", Boundary::kSkip, 1e-5, [](const Polygon& polygon, const PointBatch& points) {
+                           return winding_number::CalculateWindingNumbers2D(points, poly::PolygonLanes({polygon}));
+                       }});
+    return engines;
+}
+
+// splitmix64, so that a seed reproduces the same cases everywhere.
+class Random {
+public:
+    explicit Random(uint64_t seed) : state_(seed) {}
+
+    uint64_t Next() {
+        uint64_t z = (state_ += 0x9e3779b97f4a7c15ULL);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        return z ^ (z >> 31);
+    }
+
+    // Uniform in [low, high).
+    double Uniform(double low, double high) {
+        return low + (high - low) * ((Next() >> 11) * (1.0 / 9007199254740992.0));
+    }
+
+    // Uniform in [low, high].
+    int Integer(int low, int high) {
+        return low + static_cast<int>(Next() % static_cast<uint64_t>(high - low + 1));
+    }
+
+private:
+    uint64_t state_;
+};
+
+struct Case {
+    Polygon polygon;
+    PointBatch points;
+};
+
+// Random generators of adversarial cases. Every polygon is exactly closed.
+class CaseGenerator {
+public:
+    explicit CaseGenerator(uint64_t seed) : random_(seed) {}
+
+    Case Next() {
+        Case c;
+        switch (random_.Integer(0, 5)) {
+        case 0:
+            GridPolygon(c);
+            break;
+        case 1:
+            FloatPolygon(c);
+            break;
+        case 2:
+            StarOrSpiral(c);
+            break;
+        case 3:
+            NearDuplicates(c);
+            break;
+        case 4:
+            Rectangle(c);
+            break;
+        default:
+            FarFromOrigin(c);
+            break;
+        }
+        return c;
+    }
+
+private:
+    // Small integer coordinates: lots of collinear edges, repeated vertices, rays through vertices and points on the
+    // boundary.
+    void GridPolygon(Case& c) {
+        const float scale = std::ldexp(1.f, random_.Integer(-3, 3));
+        const int n = random_.Integer(3, 12);
+        for (int i = 0; i < n; ++i) {
+            c.polygon.AppendPoint(scale * random_.Integer(-4, 4), scale * random_.Integer(-4, 4));
+        }
+        Close(c.polygon);
+        for (int i = 0; i < 12; ++i) {
+            c.points.AppendPoint(scale * 0.5f * random_.Integer(-9, 9), scale * 0.5f * random_.Integer(-9, 9));
+        }
+        AddBoundaryPoints(c);
+    }
+
+    void FloatPolygon(Case& c) {
+        const int n = random_.Integer(3, 40);
+        for (int i = 0; i < n; ++i) {
+            c.polygon.AppendPoint(Coordinate(-1, 1), Coordinate(-1, 1));
+        }
+        Close(c.polygon);
+        for (int i = 0; i < 12; ++i) {
+            c.points.AppendPoint(Coordinate(-1.2, 1.2), Coordinate(-1.2, 1.2));
+        }
+        AddBoundaryPoints(c);
+    }
+
+    // {n/q} stars and multi-loop spirals that wind several times around their center.
+    void StarOrSpiral(Case& c) {
+        const int loops = random_.Integer(1, 5);
+        const int n = random_.Integer(2 * loops + 1, 80);
+        const bool spiral = random_.Integer(0, 1) == 1;
+        for (int i = 0; i < n; ++i) {
+            double t = static_cast<double>(i) / n;
+            double angle = spiral ? 2.0 * kPi * loops * t : 2.0 * kPi * loops * i / n;
+            double r = spiral ? 0.5 + 0.5 * t : 1.0;
+            c.polygon.AppendPoint(static_cast<float>(r * std::cos(angle)), static_cast<float>(r * std::sin(angle)));
+        }
+        Close(c.polygon);
+        for (int i = 0; i < 12; ++i) {
+            c.points.AppendPoint(Coordinate(-1.1, 1.1), Coordinate(-1.1, 1.1));
+        }
+        AddBoundaryPoints(c);
+    }
+
+    // Vertices followed by copies one or two float steps away, like the 1.0000001 records in polygons.txt.
+    void NearDuplicates(Case& c) {
+        const int n = random_.Integer(3, 10);
+        for (int i = 0; i < n; ++i) {
+            float x = Coordinate(-2, 2), y = Coordinate(-2, 2);
+            c.polygon.AppendPoint(x, y);
+            for (int copies = random_.Integer(0, 2); copies > 0; --copies) {
+                x = std::nextafter(x, random_.Integer(0, 1) ? HUGE_VALF : -HUGE_VALF);
+                y = std::nextafter(y, random_.Integer(0, 1) ? HUGE_VALF : -HUGE_VALF);
+                c.polygon.AppendPoint(x, y);
+            }
+        }
+        Close(c.polygon);
+        for (int i = 0; i < 8; ++i) {
+            c.points.AppendPoint(Coordinate(-2.2, 2.2), Coordinate(-2.2, 2.2));
+        }
+        AddBoundaryPoints(c);
+    }
+
+    // Axis-aligned rectangles, like the unit squares of polygons.txt, with points on their sides and corners.
+    void Rectangle(Case& c) {
+        float x0 = Coordinate(-10, 10), y0 = Coordinate(-10, 10);
+        float x1 = x0 + Coordinate(0.001, 10), y1 = y0 + Coordinate(0.001, 10);
+        if (random_.Integer(0, 1)) {
+            std::swap(x0, x1);
+        }
+        c.polygon.AppendPoint(x0, y0);
+        c.polygon.AppendPoint(x1, y0);
+        c.polygon.AppendPoint(x1, y1);
+        c.polygon.AppendPoint(x0, y1);
+        Close(c.polygon);
+        for (int i = 0; i < 8; ++i) {
+            float x = Coordinate(std::min(x0, x1) - 1, std::max(x0, x1) + 1);
+            float y = Coordinate(y0 - 1, y1 + 1);
+            switch (random_.Integer(0, 3)) {
+            case 0:
+                x = x0;
+                break;
+            case 1:
+                y = y1;
+                break;
+            default:
+                break;
+            }
+            c.points.AppendPoint(x, y);
+        }
+    }
+
+    // A small polygon far from the origin, where float coordinates are coarse.
+    void FarFromOrigin(Case& c) {
+        const float cx = Coordinate(-1e6, 1e6), cy = Coordinate(-1e6, 1e6);
+        const int n = random_.Integer(3, 16);
+        for (int i = 0; i < n; ++i) {
+            c.polygon.AppendPoint(cx + Coordinate(-1, 1), cy + Coordinate(-1, 1));
+        }
+        Close(c.polygon);
+        for (int i = 0; i < 12; ++i) {
+            c.points.AppendPoint(cx + Coordinate(-1.2, 1.2), cy + Coordinate(-1.2, 1.2));
+        }
+        AddBoundaryPoints(c);
+    }
+
+    // Adds a few vertices and edge midpoints of the polygon as query points.
+    void AddBoundaryPoints(Case& c) {
+        const auto edges = static_cast<int>(c.polygon.size() - 1);
+        for (int k = 0; k < 4; ++k) {
+            int i = random_.Integer(0, edges - 1);
+            float x0 = c.polygon.x_vec_[i], y0 = c.polygon.y_vec_[i];
+            float x1 = c.polygon.x_vec_[i + 1], y1 = c.polygon.y_vec_[i + 1];
+            if (k % 2 == 0) {
+                c.points.AppendPoint(x0, y0);
+            } else {
+                c.points.AppendPoint(x0 + (x1 - x0) * 0.5f, y0 + (y1 - y0) * 0.5f);
+            }
+        }
+    }
+
+    float Coordinate(double low, double high) {
+        return static_cast<float>(random_.Uniform(low, high));
+    }
+
+    static void Close(Polygon& polygon) {
+        polygon.AppendPoint(polygon.x_vec_[0], polygon.y_vec_[0]);
+    }
+
+    Random random_;
+};
+
+// Whether the point is exactly on the boundary, and its distance, relative to the polygon's scale, to the nearest edge
+// it is not on. A point within rounding of an edge it is not on may land on either side of it in double.
+struct Proximity {
+    bool on_boundary = false;
+    double distance = 0.0;
+};
+
+Proximity ProximityToBoundary(float x, float y, const Polygon& polygon) {
+    Proximity proximity;
+    double scale = 0.0, distance = INFINITY;
+    for (size_t i = 0; i + 1 < polygon.size(); ++i) {
+        const double x0 = polygon.x_vec_[i], y0 = polygon.y_vec_[i];
+        const double x1 = polygon.x_vec_[i + 1], y1 = polygon.y_vec_[i + 1];
+        scale = std::max({scale, std::abs(x0), std::abs(y0)});
+        const bool in_box = !((x < x0 && x < x1) || (x > x0 && x > x1) || (y < y0 && y < y1) || (y > y0 && y > y1));
+        if (in_box && winding_number::ExactEdgeSide(polygon.x_vec_[i], polygon.y_vec_[i], polygon.x_vec_[i + 1],
+                                                    polygon.y_vec_[i + 1], x, y) == 0) {
+            proximity.on_boundary = true;
+            continue;
+        }
+        const double dx = x1 - x0, dy = y1 - y0, length2 = dx * dx + dy * dy;
+        double t = length2 > 0 ? ((x - x0) * dx + (y - y0) * dy) / length2 : 0.0;
+        t = std::min(std::max(t, 0.0), 1.0);
+        distance = std::min(distance, std::hypot(x - (x0 + t * dx), y - (y0 + t * dy)));
+    }
+    proximity.distance = scale > 0 ? distance / scale : distance;
+    return proximity;
+}
+
+// Returns true if the engine's result for the point is acceptable under its contract.
+bool Agrees(const Engine& engine, const std::optional<int>& result, const std::optional<int>& reference,
+            const Proximity& proximity) {
+    if (!reference || !result) {
+        return reference == result;
+    }
+    if (proximity.distance <= engine.slack) {
+        return true;
+    }
+    if (proximity.on_boundary && engine.boundary == Boundary::kSkip) {
+        return true;
+    }
+    return result == reference;
+}
+
+// Returns true if the engine disagrees with the reference on this point and polygon.
+bool Disagrees(const Engine& engine, float x, float y, const Polygon& polygon) {
+    PointBatch point;
+    point.AppendPoint(x, y);
+    return !Agrees(engine, engine.evaluate(polygon, point)[0], winding_number::ExactWindingNumber2D(x, y, polygon),
+                   ProximityToBoundary(x, y, polygon));
+}
+
+// Greedily drops vertices from the polygon as long as the engine still disagrees on the point.
+Polygon Minimize(const Engine& engine, float x, float y, Polygon polygon) {
+    bool shrunk = true;
+    while (shrunk && polygon.size() > 3) {
+        shrunk = false;
+        const size_t vertex_count = polygon.size() - 1;
+        for (size_t drop = 0; drop < vertex_count && !shrunk; ++drop) {
+            Polygon candidate;
+            for (size_t i = 0; i < vertex_count; ++i) {
+                if (i != drop) {
+                    candidate.AppendPoint(polygon.x_vec_[i], polygon.y_vec_[i]);
+                }
+            }
+            candidate.AppendPoint(candidate.x_vec_[0], candidate.y_vec_[0]);
+            if (Disagrees(engine, x, y, candidate)) {
+                polygon = std::move(candidate);
+                shrunk = true;
+            }
+        }
+    }
+    return polygon;
+}
+
+void AppendFloat(std::string& line, float value) {
+    char digits[32];
+    if (!line.empty()) {
+        line += ' ';
+    }
+    line.append(digits, std::to_chars(digits, digits + sizeof(digits), value).ptr);
+}
+
+std::string ResultString(const std::optional<int>& result) {
+    return result ? std::to_string(*result) : "nullopt";
+}
+
+// Formats a disagreement as a comment and a record that IPolygonReader can read back.
+std::string Report(const Engine& engine, float x, float y, const Polygon& polygon) {
+    PointBatch point;
+    point.AppendPoint(x, y);
+    std::string record;
+    AppendFloat(record, x);
+    AppendFloat(record, y);
+    for (size_t i = 0; i < polygon.size(); ++i) {
+        AppendFloat(record, polygon.x_vec_[i]);
+        AppendFloat(record, polygon.y_vec_[i]);
+    }
+    return "# " + engine.name + " returned " + ResultString(engine.evaluate(polygon, point)[0]) +
+           ", the exact reference " + ResultString(winding_number::ExactWindingNumber2D(x, y, polygon)) + "\n" +
+           record + "\n";
+}
+
+Options ParseOptions(int nargs, char* args[]) {
+    Options options;
+    for (int i = 1; i < nargs; ++i) {
+        std::string_view arg = args[i];
+        auto value = [&]() -> std::string {
+            if (i + 1 >= nargs) {
+                throw std::runtime_error("Missing value for " + std::string(arg));
+            }
+            return args[++i];
+        };
+        if (arg == "--seconds") {
+            options.seconds = std::stod(value());
+        } else if (arg == "--cases") {
+            options.cases = std::stoull(value());
+        } else if (arg == "--threads") {
+            options.threads = std::stoull(value());
+        } else if (arg == "--seed") {
+            options.seed = std::stoull(value());
+        } else if (arg == "--max-reports") {
+            options.max_reports = std::stoull(value());
+        } else {
+            throw std::runtime_error("Unknown option: " + std::string(arg));
+        }
+    }
+    return options;
+}
+
+}  // namespace
+
+int main(int nargs, char* args[]) {
+    Options options;
+    try {
+        options = ParseOptions(nargs, args);
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "%s\n%s", e.what(), kUsage);
+        return 2;
+    }
+
+    const std::vector<Engine> engines = Engines();
+    const size_t thread_count = options.threads == 0 ? winding_number::DefaultThreadCount() : options.threads;
+    const auto start = std::chrono::steady_clock::now();
+    const auto deadline = start + std::chrono::duration<double>(options.seconds);
+
+    std::atomic<uint64_t> cases{0};
+    std::vector<std::atomic<uint64_t>> disagreements(engines.size());
+    std::atomic<uint64_t> reports{0};
+    std::mutex output_mutex;
+
+    winding_number::ParallelFor(
+            thread_count,
+            [&](size_t thread) {
+                CaseGenerator generator(options.seed * 0x100000001b3ULL + thread);
+                while (std::chrono::steady_clock::now() < deadline &&
+                       (options.cases == 0 || cases.load(std::memory_order_relaxed) < options.cases)) {
+                    Case c = generator.Next();
+                    Results reference;
+                    std::vector<Proximity> proximity;
+                    for (size_t p = 0; p < c.points.size(); ++p) {
+                        const float x = c.points.x_vec_[p], y = c.points.y_vec_[p];
+                        reference.push_back(winding_number::ExactWindingNumber2D(x, y, c.polygon));
+                        proximity.push_back(ProximityToBoundary(x, y, c.polygon));
+                    }
+                    for (size_t e = 0; e < engines.size(); ++e) {
+                        Results results = engines[e].evaluate(c.polygon, c.points);
+                        for (size_t p = 0; p < c.points.size(); ++p) {
+                            if (Agrees(engines[e], results[p], reference[p], proximity[p])) {
+                                continue;
+                            }
+                            disagreements[e].fetch_add(1, std::memory_order_relaxed);
+                            if (reports.fetch_add(1, std::memory_order_relaxed) < options.max_reports) {
+                                const float x = c.points.x_vec_[p], y = c.points.y_vec_[p];
+                                std::string report = Report(engines[e], x, y, Minimize(engines[e], x, y, c.polygon));
+                                std::lock_guard<std::mutex> lock(output_mutex);
+                                std::fputs(report.c_str(), stdout);
+                            }
+                        }
+                    }
+                    cases.fetch_add(c.points.size(), std::memory_order_relaxed);
+                }
+            },
+            thread_count);
+
+    const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    uint64_t total_disagreements = 0;
+    std::fprintf(stderr, "%llu cases in %.1f s (%.0f cases per minute) on %zu threads\n",
+                 static_cast<unsigned long long>(cases.load()), elapsed, 60.0 * cases.load() / elapsed, thread_count);
+    for (size_t e = 0; e < engines.size(); ++e) {
+        total_disagreements += disagreements[e].load();
+        std::fprintf(stderr, "  %-16s %llu disagreements\n", engines[e].name.c_str(),
+                     static_cast<unsigned long long>(disagreements[e].load()));
+    }
+    return total_disagreements == 0 ? 0 : 1;
+}
@@ -0,0 +1,154 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <optional>
+#include <random>
+
+#include <bezier_path.hpp>
+#include <poly_io.hpp>
+#include <winding.hpp>
+
+namespace winding_number {
+
+using poly::BezierPath;
+using poly::Polygon;
+
+class BezierPathTest : public ::testing::Test {
+protected:
+    BezierPathTest() : scalar_(IWindingNumberAlgorithm::Create("scalar")) {}
+
+    // A circle of radius 1 around (cx, cy) from four cubic quarter arcs, counter-clockwise.
+    static void AppendCircle(BezierPath& path, float cx, float cy, bool clockwise = false) {
+        const float k = 0.5522847f;
+        const float s = clockwise ? -1.f : 1.f;
+        path.MoveTo(cx + 1, cy);
+        path.CubicTo(cx + 1, cy + s * k, cx + k, cy + s, cx, cy + s);
+        path.CubicTo(cx - k, cy + s, cx - 1, cy + s * k, cx - 1, cy);
+        path.CubicTo(cx - 1, cy - s * k, cx - k, cy - s, cx, cy - s);
+        path.CubicTo(cx + k, cy - s, cx + 1, cy - s * k, cx + 1, cy);
+    }
+
+    // Compares against a finely flattened copy, away from the boundary where flattening moves it.
+    void ExpectMatchesFlattenedOnGrid(const BezierPath& path, float low, float high, float step) {
+        const PreparedBezierPath prepared(path);
+        const poly::MultiPolygon flattened = path.Flatten(1024);
+        const auto default_algorithm = IWindingNumberAlgorithm::Create();
+        for (float y = low; y <= high; y += step) {
+            for (float x = low; x <= high; x += step) {
+                const auto expected = default_algorithm->CalculateWindingNumber2D(x, y, flattened);
+                bool near_boundary = false;
+                for (float dx : {-1e-3f, 1e-3f}) {
+                    for (float dy : {-1e-3f, 1e-3f}) {
+                        const auto nearby = default_algorithm->CalculateWindingNumber2D(x + dx, y + dy, flattened);
+                        near_boundary |= nearby != expected;
+                    }
+                }
+                if (near_boundary) {
+                    continue;
+                }
+                EXPECT_EQ(expected, prepared.CalculateWindingNumber2D(x, y)) << "at " << x << ", " << y;
+            }
+        }
+    }
+
+    std::unique_ptr<IWindingNumberAlgorithm> scalar_;
+};
+
+TEST_F(BezierPathTest, LinesMatchScalar) {
+    // Boundary points included: straight segments follow edge_crossing.hpp exactly.
+    std::mt19937 random(44);
+    std::uniform_int_distribution<int> coordinate(0, 4);
+    for (int round = 0; round < 50; ++round) {
+        BezierPath path;
+        Polygon polygon;
+        for (int i = 0; i < 1 + round % 10; ++i) {
+            const float x = coordinate(random), y = coordinate(random);
+            i == 0 ? path.MoveTo(x, y) : path.LineTo(x, y);
+            polygon.AppendPoint(x, y);
+        }
+        path.ClosePolygon();
+        polygon.ClosePolygon();
+        const PreparedBezierPath prepared(path);
+        EXPECT_EQ(0u, prepared.piece_count());
+        for (float y = -0.5f; y <= 4.5f; y += 0.5f) {
+            for (float x = -0.5f; x <= 4.5f; x += 0.5f) {
+                EXPECT_EQ(scalar_->CalculateWindingNumber2D(x, y, polygon), prepared.CalculateWindingNumber2D(x, y))
+                        << "at " << x << ", " << y;
+            }
+        }
+    }
+}
+
+TEST_F(BezierPathTest, CountsCurvesAnalytically) {
+    BezierPath ring;
+    AppendCircle(ring, 0, 0);
+    AppendCircle(ring, 0, 0.25f, true);
+    ring.MoveTo(3, 0);
+    ring.QuadraticTo(4, 2, 5, 0);
+    ring.ClosePolygon();
+    const PreparedBezierPath prepared(ring);
+    // Each of the eight quarter arcs is monotone already; the quadratic is cut at its top.
+    EXPECT_EQ(10u, prepared.piece_count());
+
+    EXPECT_EQ(std::optional<int>(1), prepared.CalculateWindingNumber2D(0.f, -0.9f));
+    EXPECT_EQ(std::optional<int>(0), prepared.CalculateWindingNumber2D(0.f, 0.f));
+    EXPECT_EQ(std::optional<int>(0), prepared.CalculateWindingNumber2D(1.5f, 0.f));
+    EXPECT_EQ(std::optional<int>(-1), prepared.CalculateWindingNumber2D(4.f, 0.5f));
+    EXPECT_EQ(std::optional<int>(0), prepared.CalculateWindingNumber2D(4.f, 1.1f));
+
+    // Closer to the arc than any reasonable flattening: the last quarter at t = 1/2 is (k', -k') with k' = 0.7071...
+    const float inside = 0.7070f, outside = 0.7072f;
+    EXPECT_EQ(std::optional<int>(1), prepared.CalculateWindingNumber2D(inside, -inside));
+    EXPECT_EQ(std::optional<int>(0), prepared.CalculateWindingNumber2D(outside, -outside));
+
+    // End points of curved segments are on the boundary.
+    EXPECT_EQ(std::optional<int>(1), prepared.CalculateWindingNumber2D(0.f, 1.f));
+    EXPECT_EQ(std::optional<int>(1), prepared.CalculateWindingNumber2D(5.f, 0.f));
+}
+
+TEST_F(BezierPathTest, MatchesFlattenedOnRandomCurves) {
+    // Random control points make loops, cusps and self-intersections, and put grid points on the lines through the
+    // turning points.
+    std::mt19937 random(440);
+    std::uniform_int_distribution<int> coordinate(0, 8);
+    auto next = [&]() { return coordinate(random) * 0.5f; };
+    for (int round = 0; round < 24; ++round) {
+        BezierPath path;
+        path.MoveTo(next(), next());
+        for (int i = 0; i < 1 + round % 4; ++i) {
+            switch (coordinate(random) % 3) {
+            case 0:
+                path.LineTo(next(), next());
+                break;
+            case 1:
+                path.QuadraticTo(next(), next(), next(), next());
+                break;
+            default:
+                path.CubicTo(next(), next(), next(), next(), next(), next());
+                break;
+            }
+        }
+        path.ClosePolygon();
+        ExpectMatchesFlattenedOnGrid(path, -0.25f, 4.25f, 0.25f);
+    }
+}
+
+TEST_F(BezierPathTest, FailsWithUnclosedPath) {
+    BezierPath path;
+    path.MoveTo(0, 0);
+    path.QuadraticTo(1, 1, 2, 0);
+    EXPECT_FALSE(path.IsClosed());
+    EXPECT_FALSE(PreparedBezierPath(path).CalculateWindingNumber2D(1, 0.25f));
+    EXPECT_FALSE(PreparedBezierPath(BezierPath()).CalculateWindingNumber2D(0, 0));
+
+    path.LineTo(1e-7f, 0);
+    EXPECT_FALSE(path.IsClosed());
+    EXPECT_TRUE(path.IsClosed(1e-6f));
+    EXPECT_EQ(std::optional<int>(-1), PreparedBezierPath(path, 1e-6f).CalculateWindingNumber2D(1, 0.25f));
+
+    const auto batch = PreparedBezierPath(path).CalculateWindingNumbers2D(
+            poly::PointBatch::FromPoints({{1.f, 0.25f}, {3.f, 3.f}}));
+    EXPECT_EQ(std::vector<std::optional<int>>(2), batch);
+}
+
+}  // namespace winding_number
@@ -0,0 +1,188 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <optional>
+#include <random>
+#include <vector>
+
+#include <containment_hierarchy.hpp>
+#include <exact_predicates.hpp>
+#include <poly_io.hpp>
+
+namespace winding_number {
+
+using poly::Polygon;
+
+class ContainmentHierarchyTest : public ::testing::Test {
+protected:
+    static Polygon MakeRectangle(float min_x, float min_y, float max_x, float max_y) {
+        Polygon p;
+        p.AppendPoint(min_x, min_y);
+        p.AppendPoint(max_x, min_y);
+        p.AppendPoint(max_x, max_y);
+        p.AppendPoint(min_x, max_y);
+        p.ClosePolygon();
+        return p;
+    }
+
+    // Two countries, the first with two regions that split it down the middle, a site in the left region and a zone
+    // in the site; the second with one region. Shuffled, so the input order says nothing about the nesting.
+    static std::vector<Polygon> MakeGeofences() {
+        return {
+                MakeRectangle(2.f, 2.f, 3.f, 3.f),     // 0: zone
+                MakeRectangle(20.f, 0.f, 30.f, 10.f),  // 1: country
+                MakeRectangle(5.f, 0.f, 10.f, 10.f),   // 2: region of 3
+                MakeRectangle(0.f, 0.f, 10.f, 10.f),   // 3: country
+                MakeRectangle(1.f, 1.f, 4.f, 4.f),     // 4: site
+                MakeRectangle(22.f, 2.f, 28.f, 8.f),   // 5: region of 1
+                MakeRectangle(0.f, 0.f, 5.f, 10.f),    // 6: region of 3
+        };
+    }
+
+    // The polygons containing the point, tested one by one.
+    static std::vector<size_t> FindByScan(float x, float y, const std::vector<Polygon>& polygons) {
+        std::vector<size_t> found;
+        for (size_t i = 0; i < polygons.size(); ++i) {
+            if (ExactWindingNumber2D(x, y, polygons[i]).value_or(0) != 0) {
+                found.push_back(i);
+            }
+        }
+        return found;
+    }
+};
+
+TEST_F(ContainmentHierarchyTest, DetectsNesting) {
+    const ContainmentHierarchy hierarchy(MakeGeofences());
+    ASSERT_TRUE(hierarchy.valid()) << hierarchy.error_message();
+    EXPECT_EQ(2u, hierarchy.root_count());
+    EXPECT_EQ(4u, hierarchy.depth());
+    const std::vector<std::optional<size_t>> parents = {4, std::nullopt, 3, std::nullopt, 6, 1, 3};
+    for (size_t i = 0; i < parents.size(); ++i) {
+        EXPECT_EQ(parents[i], hierarchy.parent(i)) << "for polygon " << i;
+    }
+
+    EXPECT_EQ(std::vector<size_t>({3, 6, 4, 0}), hierarchy.FindPath(2.5f, 2.5f));
+    EXPECT_EQ(std::vector<size_t>({3, 6, 4}), hierarchy.FindPath(3.5f, 2.5f));
+    EXPECT_EQ(std::vector<size_t>({3, 2}), hierarchy.FindPath(7.5f, 2.5f));
+    EXPECT_EQ(std::vector<size_t>({1, 5}), hierarchy.FindPath(25.f, 5.f));
+    EXPECT_EQ(std::vector<size_t>({1}), hierarchy.FindPath(21.f, 5.f));
+    EXPECT_TRUE(hierarchy.FindPath(15.f, 5.f).empty());
+
+    // Boundaries are inside, so a point on the line between the regions is in both.
+    EXPECT_EQ(std::vector<size_t>({3, 2, 6}), hierarchy.FindPath(5.f, 7.f));
+}
+
+TEST_F(ContainmentHierarchyTest, MatchesScanOnRandomTrees) {
+    // Rectangles split into up to four smaller ones, at random points and a few levels deep, with some pieces left
+    // out, in random order.
+    std::mt19937 random(50);
+    std::uniform_real_distribution<float> fraction(0.2f, 0.8f);
+    std::vector<Polygon> polygons;
+    std::vector<std::vector<float>> pending = {{0.f, 0.f, 100.f, 100.f, 0.f}, {150.f, 0.f, 250.f, 80.f, 0.f}};
+    while (!pending.empty()) {
+        const std::vector<float> box = pending.back();
+        pending.pop_back();
+        polygons.push_back(MakeRectangle(box[0], box[1], box[2], box[3]));
+        if (box[4] == 4.f) {
+            continue;
+        }
+        const float mid_x = box[0] + fraction(random) * (box[2] - box[0]);
+        const float mid_y = box[1] + fraction(random) * (box[3] - box[1]);
+        for (const auto& child : {std::vector<float>{box[0], box[1], mid_x, mid_y},
+                                  {mid_x, box[1], box[2], mid_y},
+                                  {box[0], mid_y, mid_x, box[3]},
+                                  {mid_x, mid_y, box[2], box[3]}}) {
+            if (random() % 4 != 0) {
+                pending.push_back({child[0], child[1], child[2], child[3], box[4] + 1.f});
+            }
+        }
+    }
+    std::shuffle(polygons.begin(), polygons.end(), random);
+    const ContainmentHierarchy hierarchy(polygons);
+    ASSERT_TRUE(hierarchy.valid()) << hierarchy.error_message();
+    EXPECT_EQ(2u, hierarchy.root_count());
+    EXPECT_EQ(5u, hierarchy.depth());
+
+    std::uniform_real_distribution<float> x_coordinate(-10.f, 260.f), y_coordinate(-10.f, 110.f);
+    for (int i = 0; i < 5000; ++i) {
+        const float x = x_coordinate(random), y = y_coordinate(random);
+        const std::vector<size_t> path = hierarchy.FindPath(x, y);
+        for (size_t j = 0; j < path.size(); ++j) {
+            ASSERT_EQ(j == 0 ? std::nullopt : std::optional<size_t>(path[j - 1]), hierarchy.parent(path[j]));
+        }
+        std::vector<size_t> sorted = path;
+        std::sort(sorted.begin(), sorted.end());
+        ASSERT_EQ(FindByScan(x, y, polygons), sorted) << "at " << x << ", " << y;
+    }
+}
+
+TEST_F(ContainmentHierarchyTest, TakesGivenParents) {
+    const std::vector<Polygon> polygons = MakeGeofences();
+    const std::vector<std::optional<size_t>> parents = {4, std::nullopt, 3, std::nullopt, 6, 1, 3};
+    const ContainmentHierarchy hierarchy(polygons, parents);
+    ASSERT_TRUE(hierarchy.valid()) << hierarchy.error_message();
+    EXPECT_EQ(std::vector<size_t>({3, 6, 4, 0}), hierarchy.FindPath(2.5f, 2.5f));
+
+    // Given parents are not checked: the zone is only reached through the other country.
+    const ContainmentHierarchy misplaced(polygons, {1, std::nullopt, 3, std::nullopt, 6, 1, 3});
+    ASSERT_TRUE(misplaced.valid()) << misplaced.error_message();
+    EXPECT_EQ(std::vector<size_t>({3, 6, 4}), misplaced.FindPath(2.5f, 2.5f));
+
+    // Overlapping siblings are each descended into.
+    const ContainmentHierarchy overlapping(
+            {MakeRectangle(0.f, 0.f, 10.f, 10.f), MakeRectangle(1.f, 1.f, 6.f, 6.f), MakeRectangle(4.f, 4.f, 9.f, 9.f),
+             MakeRectangle(5.f, 5.f, 5.5f, 5.5f)},
+            {std::nullopt, 0, 0, 2});
+    ASSERT_TRUE(overlapping.valid()) << overlapping.error_message();
+    EXPECT_EQ(std::vector<size_t>({0, 1, 2, 3}), overlapping.FindPath(5.25f, 5.25f));
+    EXPECT_EQ(std::vector<size_t>({0, 1}), overlapping.FindPath(2.f, 2.f));
+}
+
+TEST_F(ContainmentHierarchyTest, BatchMatchesSinglePoints) {
+    const ContainmentHierarchy hierarchy(MakeGeofences());
+    ASSERT_TRUE(hierarchy.valid()) << hierarchy.error_message();
+    std::mt19937 random(500);
+    std::uniform_real_distribution<float> coordinate(-1.f, 31.f);
+    poly::PointBatch points;
+    for (int i = 0; i < 2000; ++i) {
+        points.AppendPoint(coordinate(random), coordinate(random) / 3);
+    }
+    for (size_t thread_count : {1, 4}) {
+        const auto paths = hierarchy.FindPaths(points, thread_count);
+        ASSERT_EQ(points.size(), paths.size());
+        for (size_t i = 0; i < points.size(); ++i) {
+            EXPECT_EQ(hierarchy.FindPath(points.x_vec_[i], points.y_vec_[i]), paths[i]);
+        }
+    }
+}
+
+TEST_F(ContainmentHierarchyTest, RejectsBadInput) {
+    std::vector<Polygon> polygons = MakeGeofences();
+    const std::vector<std::vector<std::optional<size_t>>> invalid_parents = {
+            {4, std::nullopt, 3, std::nullopt, 6, 1},     // too few
+            {4, std::nullopt, 3, std::nullopt, 6, 1, 7},  // out of range
+            {4, std::nullopt, 3, std::nullopt, 6, 5, 3},  // its own parent
+            {4, std::nullopt, 3, std::nullopt, 0, 1, 3},  // a cycle
+    };
+    for (size_t i = 0; i < invalid_parents.size(); ++i) {
+        const ContainmentHierarchy hierarchy(polygons, invalid_parents[i]);
+        EXPECT_FALSE(hierarchy.valid()) << "case " << i;
+        EXPECT_FALSE(hierarchy.error_message().empty()) << "case " << i;
+        EXPECT_TRUE(hierarchy.FindPath(2.5f, 2.5f).empty()) << "case " << i;
+        EXPECT_EQ(0u, hierarchy.root_count()) << "case " << i;
+    }
+
+    Polygon unclosed;
+    unclosed.AppendPoint(0.f, 0.f);
+    unclosed.AppendPoint(1.f, 0.f);
+    unclosed.AppendPoint(1.f, 1.f);
+    polygons.push_back(unclosed);
+    const ContainmentHierarchy hierarchy(polygons);
+    EXPECT_FALSE(hierarchy.valid());
+    EXPECT_FALSE(hierarchy.error_message().empty());
+    EXPECT_TRUE(hierarchy.FindPath(2.5f, 2.5f).empty());
+
+    EXPECT_TRUE(ContainmentHierarchy({}).valid());
+}
+
+}  // namespace winding_number
@@ -0,0 +1,101 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <optional>
+
+#include <convex_polygon.hpp>
+#include <engine_test.hpp>
+#include <poly_io.hpp>
+#include <winding.hpp>
+
+namespace winding_number {
+
+using poly::Polygon;
+
+constexpr double kPi = 3.14159265358979323846;
+
+class ConvexPolygonTest : public EngineTest<> {
+protected:
+    // Compares against the scalar algorithm on a grid that hits the vertices, the sides and the lines through them.
+    void ExpectMatchesScalarOnGrid(const Polygon& polygon, float low, float high, float step) {
+        ConvexPolygon convex(polygon);
+        for (float y = low; y <= high; y += step) {
+            for (float x = low; x <= high; x += step) {
+                EXPECT_EQ(scalar_->CalculateWindingNumber2D(x, y, polygon), convex.CalculateWindingNumber2D(x, y))
+                        << "at " << x << ", " << y;
+            }
+        }
+    }
+};
+
+TEST_F(ConvexPolygonTest, MatchesScalarForPolygonsFromFile) {
+    auto points_and_polygons = reader_->ReadPointsAndPolygonsFromFile(polygons_file_path_);
+    ASSERT_FALSE(points_and_polygons.empty());
+    for (size_t i = 0; i < points_and_polygons.size(); ++i) {
+        const auto& [x, y, polygon] = points_and_polygons[i];
+        ConvexPolygon convex(polygon, tolerance_);
+        EXPECT_EQ(scalar_->CalculateWindingNumber2D(x, y, polygon), convex.CalculateWindingNumber2D(x, y))
+                << "for record " << i;
+    }
+}
+
+TEST_F(ConvexPolygonTest, DetectsConvexityAndOrientation) {
+    Polygon square = MakePolygon({{0, 0}, {1, 0}, {1, 1}, {0, 1}});
+    EXPECT_TRUE(ConvexPolygon(square).convex());
+    EXPECT_EQ(1, ConvexPolygon(square).orientation());
+
+    Polygon clockwise = MakePolygon({{0, 0}, {0, 1}, {1, 1}, {1, 0}});
+    EXPECT_EQ(-1, ConvexPolygon(clockwise).orientation());
+
+    // Repeated vertices and vertices along a side don't change the shape.
+    Polygon padded = MakePolygon({{0, 0}, {0, 0}, {1, 0}, {2, 0}, {2, 2}, {2, 2}, {1, 2}, {0, 2}, {0, 0}});
+    EXPECT_TRUE(ConvexPolygon(padded).convex());
+
+    Polygon l_shape = MakePolygon({{0, 0}, {2, 0}, {2, 1}, {1, 1}, {1, 2}, {0, 2}});
+    EXPECT_FALSE(ConvexPolygon(l_shape).convex());
+
+    Polygon spike = MakePolygon({{0, 0}, {2, 0}, {3, 0}, {2, 0}, {2, 2}, {0, 2}});
+    EXPECT_FALSE(ConvexPolygon(spike).convex());
+
+    Polygon pentagram;
+    for (int i = 0; i <= 5; ++i) {
+        pentagram.AppendPoint(std::cos(4 * kPi * i / 5), std::sin(4 * kPi * i / 5));
+    }
+    EXPECT_FALSE(ConvexPolygon(pentagram).convex());
+
+    Polygon flat = MakePolygon({{0, 0}, {1, 0}, {2, 0}});
+    EXPECT_FALSE(ConvexPolygon(flat).convex());
+    EXPECT_EQ(0, ConvexPolygon(flat).orientation());
+}
+
+TEST_F(ConvexPolygonTest, MatchesScalarAroundSquares) {
+    ExpectMatchesScalarOnGrid(MakePolygon({{0, 0}, {1, 0}, {1, 1}, {0, 1}}), -0.5f, 1.5f, 0.25f);
+    ExpectMatchesScalarOnGrid(MakePolygon({{0, 0}, {0, 1}, {1, 1}, {1, 0}}), -0.5f, 1.5f, 0.25f);
+    ExpectMatchesScalarOnGrid(MakePolygon({{0, 0}, {0, 0}, {1, 0}, {2, 0}, {2, 2}, {1, 2}, {0, 2}}), -0.5f, 2.5f,
+                              0.25f);
+}
+
+TEST_F(ConvexPolygonTest, MatchesScalarAroundCircleAndNonConvexPolygons) {
+    Polygon circle;
+    for (int i = 0; i < 64; ++i) {
+        circle.AppendPoint(std::cos(2 * kPi * i / 64), std::sin(2 * kPi * i / 64));
+    }
+    circle.ClosePolygon();
+    ASSERT_TRUE(ConvexPolygon(circle).convex());
+    ExpectMatchesScalarOnGrid(circle, -1.25f, 1.25f, 0.0625f);
+
+    ExpectMatchesScalarOnGrid(MakePolygon({{0, 0}, {2, 0}, {2, 1}, {1, 1}, {1, 2}, {0, 2}}), -0.5f, 2.5f, 0.25f);
+    ExpectMatchesScalarOnGrid(MakePolygon({{0, 0}, {2, 0}, {3, 0}, {2, 0}, {2, 2}, {0, 2}}), -0.5f, 3.5f, 0.25f);
+}
+
+TEST_F(ConvexPolygonTest, FailsWithUnclosedPolygon) {
+    Polygon p;
+    p.AppendPoint(0.0, 0.0);
+    p.AppendPoint(1.0, 0.0);
+    p.AppendPoint(1.0, 1.0);
+    ConvexPolygon convex(p);
+    EXPECT_FALSE(convex.CalculateWindingNumber2D(0.5, 0.5));
+    EXPECT_FALSE(ConvexPolygon(Polygon()).CalculateWindingNumber2D(0.5, 0.5));
+}
+
+}  // namespace winding_number
@@ -0,0 +1,87 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <optional>
+#include <tuple>
+
+#include <edge_bvh.hpp>
+#include <engine_test.hpp>
+#include <poly_io.hpp>
+#include <winding.hpp>
+
+namespace winding_number {
+
+using poly::Polygon;
+
+class EdgeBvhTest : public EngineTest<> {
+protected:
+    // A spiral that winds `loops` times counter-clockwise around the origin, then returns to its start in a straight
+    // line.
+    static Polygon MakeSpiral(int loops, int points_per_loop) {
+        Polygon p;
+        const int n = loops * points_per_loop;
+        for (int i = 0; i <= n; ++i) {
+            float t = static_cast<float>(i) / points_per_loop;
+            float r = 1.f + t;
+            p.AppendPoint(r * std::cos(6.2831853f * t), r * std::sin(6.2831853f * t));
+        }
+        p.ClosePolygon();
+        return p;
+    }
+};
+
+TEST_F(EdgeBvhTest, MatchesAlgorithmForPolygonsFromFile) {
+    auto points_and_polygons = reader_->ReadPointsAndPolygonsFromFile(polygons_file_path_);
+    ASSERT_FALSE(points_and_polygons.empty());
+    for (size_t i = 0; i < points_and_polygons.size(); ++i) {
+        const auto& [x, y, polygon] = points_and_polygons[i];
+        EdgeBvh bvh(polygon, tolerance_);
+        EXPECT_EQ(algorithm_->CalculateWindingNumber2D(x, y, polygon), bvh.CalculateWindingNumber2D(x, y))
+                << "for record " << i;
+    }
+}
+
+TEST_F(EdgeBvhTest, FailsWithUnclosedPolygon) {
+    Polygon p;
+    p.AppendPoint(0.0, 0.0);
+    p.AppendPoint(1.0, 0.0);
+    p.AppendPoint(1.0, 1.0);
+    EdgeBvh bvh(p);
+    EXPECT_FALSE(bvh.CalculateWindingNumber2D(0.5, 0.25));
+}
+
+TEST_F(EdgeBvhTest, CountsEverySpiralLoop) {
+    Polygon spiral = MakeSpiral(4, 64);
+    EdgeBvh bvh(spiral, tolerance_);
+    EXPECT_EQ(4, bvh.CalculateWindingNumber2D(0.1f, 0.2f));
+    EXPECT_EQ(0, bvh.CalculateWindingNumber2D(6.5f, 0.3f));
+    EXPECT_LT(bvh.chain_count(), spiral.size() / 8);
+}
+
+TEST_F(EdgeBvhTest, MatchesAlgorithmOnGridAroundSpiral) {
+    Polygon spiral = MakeSpiral(3, 100);
+    EdgeBvh bvh(spiral, tolerance_);
+    for (float y = -4.63f; y < 4.7f; y += 0.37f) {
+        for (float x = -4.71f; x < 4.7f; x += 0.29f) {
+            EXPECT_EQ(algorithm_->CalculateWindingNumber2D(x, y, spiral), bvh.CalculateWindingNumber2D(x, y))
+                    << "at " << x << ", " << y;
+        }
+    }
+}
+
+TEST_F(EdgeBvhTest, CountsBoundaryPointsAsInside) {
+    Polygon p;
+    p.AppendPoint(0.0, 0.0);
+    p.AppendPoint(0.0, 1.0);
+    p.AppendPoint(1.0, 1.0);
+    p.AppendPoint(1.0, 0.0);
+    p.AppendPoint(0.0, 0.0);
+    EdgeBvh bvh(p);
+    EXPECT_EQ(-1, bvh.CalculateWindingNumber2D(0.5, 0.5));
+    EXPECT_EQ(1, bvh.CalculateWindingNumber2D(0.5, 0.0));
+    EXPECT_EQ(1, bvh.CalculateWindingNumber2D(1.0, 1.0));
+    EXPECT_EQ(1, bvh.CalculateWindingNumber2D(0.0, 0.0));
+    EXPECT_EQ(0, bvh.CalculateWindingNumber2D(1.5, 0.5));
+}
+
+}  // namespace winding_number
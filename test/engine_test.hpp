@@ -0,0 +1,52 @@
+#ifndef ENGINE_TEST_HPP_
+#define ENGINE_TEST_HPP_
+
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <initializer_list>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include <poly_io.hpp>
+#include <winding.hpp>
+
+namespace winding_number {
+
+// What the tests of the single-polygon engines share: a reader for polygons.txt, the default algorithm and the scalar
+// one to compare against, both set to the same tolerance. Base is ::testing::Test, or ::testing::TestWithParam<T> for
+// parameterized tests.
+template <typename Base = ::testing::Test>
+class EngineTest : public Base {
+protected:
+    EngineTest() :
+            reader_(poly::IPolygonReader::Create()),
+            algorithm_(IWindingNumberAlgorithm::Create()),
+            scalar_(IWindingNumberAlgorithm::Create("scalar")),
+            polygons_file_path_((std::filesystem::current_path() / "polygons.txt").string()),
+            tolerance_(1e-6f) {
+        algorithm_->tolerance(tolerance_);
+        scalar_->tolerance(tolerance_);
+    }
+
+    // The polygon through the points, closed.
+    static poly::Polygon MakePolygon(std::initializer_list<std::pair<float, float>> points) {
+        poly::Polygon p;
+        for (const auto& [x, y] : points) {
+            p.AppendPoint(x, y);
+        }
+        p.ClosePolygon();
+        return p;
+    }
+
+    std::unique_ptr<poly::IPolygonReader> reader_;
+    std::unique_ptr<IWindingNumberAlgorithm> algorithm_;
+    std::unique_ptr<IWindingNumberAlgorithm> scalar_;
+    const std::string polygons_file_path_;
+    const float tolerance_;
+};
+
+}  // namespace winding_number
+
+#endif
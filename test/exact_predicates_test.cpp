@@ -0,0 +1,73 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <optional>
+
+#include <edge_bvh.hpp>
+#include <engine_test.hpp>
+#include <exact_predicates.hpp>
+#include <poly_io.hpp>
+
+namespace winding_number {
+
+using poly::Polygon;
+
+using ExactPredicatesTest = EngineTest<>;
+
+TEST_F(ExactPredicatesTest, EdgeSideOfSimplePoints) {
+    EXPECT_EQ(1, ExactEdgeSide(0.f, 0.f, 1.f, 0.f, 0.5f, 1.f));
+    EXPECT_EQ(-1, ExactEdgeSide(0.f, 0.f, 1.f, 0.f, 0.5f, -1.f));
+    EXPECT_EQ(0, ExactEdgeSide(0.f, 0.f, 1.f, 0.f, 7.f, 0.f));
+    EXPECT_EQ(0, ExactEdgeSide(0.f, 0.f, 0.f, 0.f, 3.f, 4.f));
+}
+
+TEST_F(ExactPredicatesTest, EdgeSideOfNearlyCollinearPoints) {
+    // The edges miss the origin by half a float step.
+    const float big = 1e8f;
+    const float step = std::nextafter(big, 2 * big);
+    EXPECT_EQ(0, ExactEdgeSide(0.f, 0.f, big, big, step, step));
+    EXPECT_EQ(-1, ExactEdgeSide(-big, -big, big, step, 0.f, 0.f));
+    EXPECT_EQ(1, ExactEdgeSide(-big, -step, big, big, 0.f, 0.f));
+}
+
+TEST_F(ExactPredicatesTest, EdgeSideWithTinyAndHugeCoordinates) {
+    const float tiny = 1e-30f;
+    EXPECT_EQ(1, ExactEdgeSide(-1e30f, 0.f, 1e30f, 0.f, 0.f, tiny));
+    EXPECT_EQ(-1, ExactEdgeSide(-1e30f, 0.f, 1e30f, 0.f, 0.f, -tiny));
+    EXPECT_EQ(0, ExactEdgeSide(-1e30f, 0.f, 1e30f, 0.f, tiny, 0.f));
+}
+
+TEST_F(ExactPredicatesTest, MatchesEdgeBvhForPolygonsFromFile) {
+    auto points_and_polygons = reader_->ReadPointsAndPolygonsFromFile(polygons_file_path_);
+    ASSERT_FALSE(points_and_polygons.empty());
+    for (size_t i = 0; i < points_and_polygons.size(); ++i) {
+        const auto& [x, y, polygon] = points_and_polygons[i];
+        EdgeBvh bvh(polygon, tolerance_);
+        EXPECT_EQ(bvh.CalculateWindingNumber2D(x, y), ExactWindingNumber2D(x, y, polygon, tolerance_))
+                << "for record " << i;
+    }
+}
+
+TEST_F(ExactPredicatesTest, CountsBoundaryPasses) {
+    Polygon p;
+    p.AppendPoint(0.0, 0.0);
+    p.AppendPoint(2.0, 0.0);
+    p.AppendPoint(1.0, 1.0);
+    p.AppendPoint(0.0, 0.0);
+    EXPECT_EQ(1, ExactWindingNumber2D(1.0, 0.5, p));
+    EXPECT_EQ(1, ExactWindingNumber2D(1.0, 0.0, p));
+    EXPECT_EQ(1, ExactWindingNumber2D(0.0, 0.0, p));
+    EXPECT_EQ(0, ExactWindingNumber2D(2.0, 1.0, p));
+    EXPECT_EQ(0, ExactWindingNumber2D(-1.0, 0.0, p));
+}
+
+TEST_F(ExactPredicatesTest, UnclosedPolygonHasNoWindingNumber) {
+    Polygon p;
+    p.AppendPoint(0.0, 0.0);
+    p.AppendPoint(1.0, 0.0);
+    p.AppendPoint(1.0, 1.0);
+    EXPECT_EQ(std::nullopt, ExactWindingNumber2D(0.5, 0.5, p));
+    EXPECT_EQ(std::nullopt, ExactWindingNumber2D(0.5, 0.5, Polygon()));
+}
+
+}  // namespace winding_number
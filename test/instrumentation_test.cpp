@@ -0,0 +1,92 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <optional>
+
+#include <instrumentation.hpp>
+#include <parallel.hpp>
+#include <poly_io.hpp>
+#include <winding.hpp>
+
+namespace winding_number {
+
+using poly::Polygon;
+using instrumentation::Counter;
+using instrumentation::Snapshot;
+using instrumentation::TakeSnapshot;
+
+class InstrumentationTest : public ::testing::Test {
+protected:
+    InstrumentationTest() {
+        square_.AppendPoint(0.0, 0.0);
+        square_.AppendPoint(1.0, 0.0);
+        square_.AppendPoint(1.0, 1.0);
+        square_.AppendPoint(0.0, 1.0);
+        square_.ClosePolygon();
+    }
+
+    Polygon square_;
+};
+
+TEST_F(InstrumentationTest, SnapshotDifferencesAndQuantiles) {
+    Snapshot earlier, later;
+    later.counters[static_cast<size_t>(Counter::kCalls)] = 7;
+    earlier.counters[static_cast<size_t>(Counter::kCalls)] = 2;
+    later.latency_buckets[3] = 90;  // [8, 16) ns
+    later.latency_buckets[10] = 10;  // [1024, 2048) ns
+    Snapshot difference = later - earlier;
+    EXPECT_EQ(5u, difference.count(Counter::kCalls));
+    EXPECT_EQ(0u, difference.count(Counter::kVertices));
+    EXPECT_EQ(100u, difference.latency_count());
+    EXPECT_EQ(16u, difference.LatencyQuantileNs(0.5));
+    EXPECT_EQ(2048u, difference.LatencyQuantileNs(0.99));
+    EXPECT_EQ(0u, Snapshot().LatencyQuantileNs(0.5));
+}
+
+TEST_F(InstrumentationTest, AggregatesCountsOfExitedThreads) {
+    const Snapshot before = TakeSnapshot();
+    ParallelFor(
+            8,
+            [](size_t) {
+                for (int i = 0; i < 1000; ++i) {
+                    instrumentation::Add(Counter::kEarlyRejects, 2);
+                }
+                instrumentation::RecordLatency(std::chrono::nanoseconds(100));
+            },
+            4);
+    const Snapshot difference = TakeSnapshot() - before;
+    EXPECT_EQ(16000u, difference.count(Counter::kEarlyRejects));
+    EXPECT_EQ(8u, difference.latency_buckets[6]);  // [64, 128) ns
+}
+
+TEST_F(InstrumentationTest, HooksCountCallsInTheLibrary) {
+    auto algorithm = IWindingNumberAlgorithm::Create("scalar");
+    Polygon unclosed = square_;
+    unclosed.x_vec_.pop_back();
+    unclosed.y_vec_.pop_back();
+
+    const Snapshot before = TakeSnapshot();
+    EXPECT_EQ(1, algorithm->CalculateWindingNumber2D(0.5, 0.5, square_));
+    EXPECT_EQ(1, algorithm->CalculateWindingNumber2D(1.0, 0.5, square_));
+    EXPECT_EQ(std::nullopt, algorithm->CalculateWindingNumber2D(0.5, 0.5, unclosed));
+    poly::MultiPolygon multi_polygon;
+    multi_polygon.AppendRing(square_);
+    algorithm->CalculateWindingNumbers2D(poly::PointBatch::FromPoints({{0.5f, 0.5f}, {5.f, 5.f}}), multi_polygon);
+    const Snapshot difference = TakeSnapshot() - before;
+
+    if (instrumentation::Enabled()) {
+        EXPECT_EQ(3u, difference.count(Counter::kCalls));
+        EXPECT_EQ(3 * square_.size(), difference.count(Counter::kVertices));
+        EXPECT_EQ(1u, difference.count(Counter::kOnEdge));
+        EXPECT_EQ(1u, difference.count(Counter::kEarlyRejects));
+        EXPECT_EQ(1u, difference.count(Counter::kUnclosedPolygons));
+        EXPECT_EQ(4u, difference.latency_count());
+    } else {
+        for (size_t i = 0; i < instrumentation::kCounterCount; ++i) {
+            EXPECT_EQ(0u, difference.counters[i]);
+        }
+        EXPECT_EQ(0u, difference.latency_count());
+    }
+}
+
+}  // namespace winding_number
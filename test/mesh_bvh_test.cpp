@@ -0,0 +1,146 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <mesh_bvh.hpp>
+#include <point_batch.hpp>
+#include <poly_io.hpp>
+
+namespace winding_number {
+
+using poly::Point3D;
+using poly::TriangleMesh;
+
+class MeshBvhTest : public ::testing::Test {
+protected:
+    MeshBvhTest() : cube_file_path_((std::filesystem::current_path() / "cube.obj").string()) {}
+
+    // A unit sphere facing outwards, from a cube with each face cut into `divisions` x `divisions` squares.
+    static TriangleMesh Sphere(size_t divisions) {
+        TriangleMesh mesh;
+        for (size_t axis = 0; axis < 3; ++axis) {
+            for (float sign : {-1.f, 1.f}) {
+                float normal[3] = {0, 0, 0}, u[3] = {0, 0, 0}, v[3] = {0, 0, 0};
+                normal[axis] = sign;
+                // u x v is the outward normal.
+                (sign > 0 ? u : v)[(axis + 1) % 3] = 1;
+                (sign > 0 ? v : u)[(axis + 2) % 3] = 1;
+                const auto first = uint32_t(mesh.vertex_count());
+                for (size_t j = 0; j <= divisions; ++j) {
+                    for (size_t i = 0; i <= divisions; ++i) {
+                        const float s = 2.f * i / divisions - 1, t = 2.f * j / divisions - 1;
+                        float p[3];
+                        for (size_t k = 0; k < 3; ++k) {
+                            p[k] = normal[k] + s * u[k] + t * v[k];
+                        }
+                        const float length = std::sqrt(p[0] * p[0] + p[1] * p[1] + p[2] * p[2]);
+                        mesh.AppendVertex(p[0] / length, p[1] / length, p[2] / length);
+                    }
+                }
+                auto vertex = [first, divisions](size_t i, size_t j) { return first + j * (divisions + 1) + i; };
+                for (size_t j = 0; j < divisions; ++j) {
+                    for (size_t i = 0; i < divisions; ++i) {
+                        mesh.AppendTriangle(vertex(i, j), vertex(i + 1, j), vertex(i + 1, j + 1));
+                        mesh.AppendTriangle(vertex(i, j), vertex(i + 1, j + 1), vertex(i, j + 1));
+                    }
+                }
+            }
+        }
+        return mesh;
+    }
+
+    static std::vector<Point3D> RandomPoints(size_t count, float low, float high, unsigned seed) {
+        std::mt19937 random(seed);
+        std::uniform_real_distribution<float> coordinate(low, high);
+        std::vector<Point3D> points(count);
+        for (auto& point : points) {
+            point = {coordinate(random), coordinate(random), coordinate(random)};
+        }
+        return points;
+    }
+
+    const std::string cube_file_path_;
+};
+
+TEST_F(MeshBvhTest, ClosedMeshIsOneInsideAndZeroOutside) {
+    TriangleMesh cube = poly::ReadTriangleMeshFromFile(cube_file_path_);
+    const MeshBvh bvh(cube);
+    EXPECT_NEAR(1.0, bvh.CalculateWindingNumber3D(0.5f, 0.5f, 0.5f), 1e-12);
+    EXPECT_NEAR(1.0, bvh.CalculateWindingNumber3D(0.1f, 0.9f, 0.01f), 1e-12);
+    EXPECT_NEAR(0.0, bvh.CalculateWindingNumber3D(2.f, 0.5f, 0.5f), 1e-12);
+    EXPECT_NEAR(0.0, bvh.CalculateWindingNumber3D(-1.f, -1.f, -1.f), 1e-12);
+
+    // Turned inside out, the same surface winds the other way.
+    for (size_t t = 0; t < cube.triangle_count(); ++t) {
+        std::swap(cube.triangles_[3 * t + 1], cube.triangles_[3 * t + 2]);
+    }
+    EXPECT_NEAR(-1.0, MeshBvh(cube).CalculateWindingNumber3D(0.5f, 0.5f, 0.5f), 1e-12);
+
+    EXPECT_EQ(0.0, MeshBvh(TriangleMesh()).CalculateWindingNumber3D(0.f, 0.f, 0.f));
+    EXPECT_EQ(0.0, MeshBvh(TriangleMesh()).CalculateApproximateWindingNumber3D(0.f, 0.f, 0.f).winding_number);
+}
+
+TEST_F(MeshBvhTest, OpenMeshGivesFractions) {
+    // Without its top, the cube leaves a sixth of the view from its center open.
+    TriangleMesh cube = poly::ReadTriangleMeshFromFile(cube_file_path_);
+    cube.triangles_.erase(cube.triangles_.begin() + 6, cube.triangles_.begin() + 12);
+    const MeshBvh bvh(cube);
+    EXPECT_NEAR(5.0 / 6.0, bvh.CalculateWindingNumber3D(0.5f, 0.5f, 0.5f), 1e-12);
+    const double below = bvh.CalculateWindingNumber3D(0.5f, 0.5f, 0.2f);
+    const double above = bvh.CalculateWindingNumber3D(0.5f, 0.5f, 0.9f);
+    EXPECT_GT(below, 5.0 / 6.0);
+    EXPECT_LT(above, 5.0 / 6.0);
+    EXPECT_GT(above, 0.5);
+}
+
+TEST_F(MeshBvhTest, ApproximationIsWithinItsErrorBound) {
+    const MeshBvh bvh(Sphere(32));
+    EXPECT_EQ(12288u, bvh.triangle_count());
+    const auto points = RandomPoints(300, -3.f, 3.f, 45);
+    for (double tolerance : {1e-2, 1e-3, 1e-5}) {
+        for (const auto& [x, y, z] : points) {
+            const double exact = bvh.CalculateWindingNumber3D(x, y, z);
+            const auto approximate = bvh.CalculateApproximateWindingNumber3D(x, y, z, tolerance);
+            EXPECT_LE(std::abs(approximate.winding_number - exact), approximate.error_bound + 1e-12)
+                    << "at " << x << ", " << y << ", " << z << " with tolerance " << tolerance;
+            EXPECT_LE(approximate.error_bound, tolerance * (1 + 1e-12));
+
+            const float radius = std::sqrt(x * x + y * y + z * z);
+            if (radius < 0.95f) {
+                EXPECT_NEAR(1.0, exact, 1e-9);
+            } else if (radius > 1.05f) {
+                EXPECT_NEAR(0.0, exact, 1e-9);
+            }
+        }
+    }
+
+    // Far away, the sphere is expanded rather than summed.
+    const auto far = bvh.CalculateApproximateWindingNumber3D(10.f, -20.f, 5.f);
+    EXPECT_GT(far.error_bound, 0.0);
+    EXPECT_NEAR(0.0, far.winding_number, far.error_bound);
+}
+
+TEST_F(MeshBvhTest, BatchMatchesSinglePoints) {
+    const MeshBvh bvh(Sphere(8));
+    const auto points = RandomPoints(300, -2.f, 2.f, 450);
+    for (size_t threads : {1, 4}) {
+        const auto exact = bvh.CalculateWindingNumbers3D(points, threads);
+        const auto approximate = bvh.CalculateApproximateWindingNumbers3D(points, 1e-4, threads);
+        ASSERT_EQ(points.size(), exact.size());
+        ASSERT_EQ(points.size(), approximate.size());
+        for (size_t i = 0; i < points.size(); ++i) {
+            const auto [x, y, z] = points[i];
+            EXPECT_EQ(bvh.CalculateWindingNumber3D(x, y, z), exact[i]);
+            const auto single = bvh.CalculateApproximateWindingNumber3D(x, y, z, 1e-4);
+            EXPECT_EQ(single.winding_number, approximate[i].winding_number);
+            EXPECT_EQ(single.error_bound, approximate[i].error_bound);
+        }
+    }
+}
+
+}  // namespace winding_number
@@ -0,0 +1,180 @@
+#include <gtest/gtest.h>
+
+#include <optional>
+#include <random>
+#include <vector>
+
+#include <exact_predicates.hpp>
+#include <planar_subdivision.hpp>
+#include <poly_io.hpp>
+
+namespace winding_number {
+
+using poly::Polygon;
+
+class PlanarSubdivisionTest : public ::testing::Test {
+protected:
+    static Polygon MakeQuad(float x0, float y0, float x1, float y1, float x2, float y2, float x3, float y3) {
+        Polygon p;
+        p.AppendPoint(x0, y0);
+        p.AppendPoint(x1, y1);
+        p.AppendPoint(x2, y2);
+        p.AppendPoint(x3, y3);
+        p.ClosePolygon();
+        return p;
+    }
+
+    // The unit squares of an n by n grid, row by row, every other one running clockwise.
+    static std::vector<Polygon> MakeGrid(int n) {
+        std::vector<Polygon> cells;
+        for (int row = 0; row < n; ++row) {
+            for (int col = 0; col < n; ++col) {
+                const float x = float(col), y = float(row);
+                cells.push_back((row + col) % 2 == 0 ? MakeQuad(x, y, x + 1, y, x + 1, y + 1, x, y + 1)
+                                                     : MakeQuad(x, y, x, y + 1, x + 1, y + 1, x + 1, y));
+            }
+        }
+        return cells;
+    }
+
+    // The first polygon the point is inside of, for points off every boundary.
+    static std::optional<size_t> FindByScan(float x, float y, const std::vector<Polygon>& polygons) {
+        for (size_t i = 0; i < polygons.size(); ++i) {
+            if (ExactWindingNumber2D(x, y, polygons[i]).value_or(0) != 0) {
+                return i;
+            }
+        }
+        return std::nullopt;
+    }
+};
+
+TEST_F(PlanarSubdivisionTest, FindsCellsOfAGrid) {
+    const std::vector<Polygon> grid = MakeGrid(2);
+    const PlanarSubdivision subdivision(grid);
+    ASSERT_TRUE(subdivision.valid()) << subdivision.error_message();
+    EXPECT_EQ(12u, subdivision.edge_count());
+    EXPECT_EQ(std::optional<size_t>(0), subdivision.FindPolygon(0.5f, 0.5f));
+    EXPECT_EQ(std::optional<size_t>(1), subdivision.FindPolygon(1.5f, 0.5f));
+    EXPECT_EQ(std::optional<size_t>(2), subdivision.FindPolygon(0.5f, 1.5f));
+    EXPECT_EQ(std::optional<size_t>(3), subdivision.FindPolygon(1.5f, 1.5f));
+    EXPECT_EQ(std::nullopt, subdivision.FindPolygon(-0.5f, 0.5f));
+    EXPECT_EQ(std::nullopt, subdivision.FindPolygon(1.f, 2.5f));
+
+    const std::vector<Polygon> large_grid = MakeGrid(20);
+    const PlanarSubdivision large(large_grid);
+    ASSERT_TRUE(large.valid()) << large.error_message();
+    std::mt19937 random(49);
+    std::uniform_real_distribution<float> coordinate(-1.f, 21.f);
+    for (int i = 0; i < 5000; ++i) {
+        const float x = coordinate(random), y = coordinate(random);
+        ASSERT_EQ(FindByScan(x, y, large_grid), large.FindPolygon(x, y)) << "at " << x << ", " << y;
+    }
+}
+
+TEST_F(PlanarSubdivisionTest, PlacesBoundaryPointsRightThenUp) {
+    const PlanarSubdivision subdivision(MakeGrid(2));
+    ASSERT_TRUE(subdivision.valid()) << subdivision.error_message();
+    EXPECT_EQ(std::optional<size_t>(1), subdivision.FindPolygon(1.f, 0.5f));
+    EXPECT_EQ(std::optional<size_t>(2), subdivision.FindPolygon(0.5f, 1.f));
+    EXPECT_EQ(std::optional<size_t>(3), subdivision.FindPolygon(1.f, 1.f));
+    EXPECT_EQ(std::optional<size_t>(0), subdivision.FindPolygon(0.f, 0.f));
+    EXPECT_EQ(std::optional<size_t>(0), subdivision.FindPolygon(0.f, 0.5f));
+    EXPECT_EQ(std::nullopt, subdivision.FindPolygon(2.f, 0.5f));
+    EXPECT_EQ(std::nullopt, subdivision.FindPolygon(0.5f, 2.f));
+    EXPECT_EQ(std::nullopt, subdivision.FindPolygon(2.f, 2.f));
+}
+
+TEST_F(PlanarSubdivisionTest, MatchesScanOnJitteredPartitionWithGaps) {
+    // Cells of a grid whose vertices are moved at random, so that edges are shared but slanted, with every fifth cell
+    // left out.
+    constexpr int n = 30;
+    std::mt19937 random(490);
+    std::uniform_real_distribution<float> jitter(-0.3f, 0.3f);
+    std::vector<std::vector<std::pair<float, float>>> vertices(n + 1, std::vector<std::pair<float, float>>(n + 1));
+    for (int row = 0; row <= n; ++row) {
+        for (int col = 0; col <= n; ++col) {
+            vertices[row][col] = {col + jitter(random), row + jitter(random)};
+        }
+    }
+    std::vector<Polygon> cells;
+    for (int row = 0; row < n; ++row) {
+        for (int col = 0; col < n; ++col) {
+            if ((row * n + col) % 5 == 3) {
+                continue;
+            }
+            const auto [x0, y0] = vertices[row][col];
+            const auto [x1, y1] = vertices[row][col + 1];
+            const auto [x2, y2] = vertices[row + 1][col + 1];
+            const auto [x3, y3] = vertices[row + 1][col];
+            cells.push_back(MakeQuad(x0, y0, x1, y1, x2, y2, x3, y3));
+        }
+    }
+    const PlanarSubdivision subdivision(cells);
+    ASSERT_TRUE(subdivision.valid()) << subdivision.error_message();
+
+    std::uniform_real_distribution<float> coordinate(-1.f, n + 1.f);
+    poly::PointBatch points;
+    for (int i = 0; i < 20000; ++i) {
+        points.AppendPoint(coordinate(random), coordinate(random));
+    }
+    for (size_t thread_count : {1, 4}) {
+        const auto found = subdivision.FindPolygons(points, thread_count);
+        ASSERT_EQ(points.size(), found.size());
+        for (size_t i = 0; i < points.size(); ++i) {
+            const float x = points.x_vec_[i], y = points.y_vec_[i];
+            ASSERT_EQ(FindByScan(x, y, cells), found[i]) << "at " << x << ", " << y;
+            ASSERT_EQ(subdivision.FindPolygon(x, y), found[i]);
+        }
+    }
+}
+
+TEST_F(PlanarSubdivisionTest, AcceptsPolygonsClosedUpToTolerance) {
+    Polygon p;
+    p.AppendPoint(0.f, 0.f);
+    p.AppendPoint(1.f, 0.f);
+    p.AppendPoint(1.f, 1.f);
+    p.AppendPoint(0.f, 1.f);
+    const PlanarSubdivision unclosed({p});
+    EXPECT_FALSE(unclosed.valid());
+    EXPECT_FALSE(unclosed.error_message().empty());
+    EXPECT_EQ(std::nullopt, unclosed.FindPolygon(0.5f, 0.5f));
+
+    p.AppendPoint(1e-7f, 0.f);
+    const PlanarSubdivision closed({p, MakeQuad(1.f, 0.f, 2.f, 0.f, 2.f, 1.f, 1.f, 1.f)}, 1e-6f);
+    ASSERT_TRUE(closed.valid()) << closed.error_message();
+    EXPECT_EQ(std::optional<size_t>(0), closed.FindPolygon(0.5f, 0.5f));
+    EXPECT_EQ(std::optional<size_t>(1), closed.FindPolygon(1.5f, 0.5f));
+}
+
+TEST_F(PlanarSubdivisionTest, RejectsPolygonsThatDoNotPartition) {
+    const Polygon square = MakeQuad(0.f, 0.f, 2.f, 0.f, 2.f, 2.f, 0.f, 2.f);
+    const std::vector<std::vector<Polygon>> invalid = {
+            // crossing edges
+            {square, MakeQuad(1.f, 1.f, 3.f, 1.f, 3.f, 3.f, 1.f, 3.f)},
+            // one inside the other
+            {square, MakeQuad(0.5f, 0.5f, 1.f, 0.5f, 1.f, 1.f, 0.5f, 1.f)},
+            // the same polygon twice, once each way around
+            {square, MakeQuad(0.f, 0.f, 0.f, 2.f, 2.f, 2.f, 2.f, 0.f)},
+            // a vertex in the middle of a neighbour's edge
+            {square, MakeQuad(2.f, 0.f, 3.f, 0.f, 3.f, 1.f, 2.f, 1.f),
+             MakeQuad(2.f, 1.f, 3.f, 1.f, 3.f, 2.f, 2.f, 2.f)},
+            // collinear edges that overlap in part
+            {square, MakeQuad(2.f, 1.f, 3.f, 1.f, 3.f, 3.f, 2.f, 3.f)},
+            // no area
+            {MakeQuad(0.f, 0.f, 1.f, 1.f, 2.f, 2.f, 1.f, 1.f)},
+    };
+    for (size_t i = 0; i < invalid.size(); ++i) {
+        const PlanarSubdivision subdivision(invalid[i]);
+        EXPECT_FALSE(subdivision.valid()) << "case " << i;
+        EXPECT_FALSE(subdivision.error_message().empty()) << "case " << i;
+        EXPECT_EQ(std::nullopt, subdivision.FindPolygon(0.25f, 0.25f)) << "case " << i;
+    }
+
+    // Touching at a corner is fine.
+    const PlanarSubdivision corner({square, MakeQuad(2.f, 2.f, 3.f, 2.f, 3.f, 3.f, 2.f, 3.f)});
+    ASSERT_TRUE(corner.valid()) << corner.error_message();
+    EXPECT_EQ(std::optional<size_t>(1), corner.FindPolygon(2.5f, 2.5f));
+    EXPECT_EQ(std::nullopt, corner.FindPolygon(2.5f, 1.5f));
+}
+
+}  // namespace winding_number
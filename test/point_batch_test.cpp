@@ -0,0 +1,84 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <vector>
+
+#include <edge_bvh.hpp>
+#include <engine_test.hpp>
+#include <point_batch.hpp>
+#include <poly_io.hpp>
+#include <winding.hpp>
+
+namespace poly {
+
+class PointBatchTest : public winding_number::EngineTest<> {
+protected:
+    static bool IsAligned(const float* p) {
+        return reinterpret_cast<std::uintptr_t>(p) % kSimdAlignment == 0;
+    }
+};
+
+TEST_F(PointBatchTest, DeinterleavesOddSizedBuffers) {
+    std::vector<float> xy;
+    for (int i = 0; i < 11; ++i) {
+        xy.push_back(static_cast<float>(i));
+        xy.push_back(static_cast<float>(-i));
+    }
+    PointBatch batch = PointBatch::FromInterleaved(xy.data(), 11);
+    ASSERT_EQ(11u, batch.size());
+    EXPECT_TRUE(IsAligned(batch.x_vec_.data()));
+    EXPECT_TRUE(IsAligned(batch.y_vec_.data()));
+    for (size_t i = 0; i < batch.size(); ++i) {
+        EXPECT_EQ(static_cast<float>(i), batch.x_vec_[i]);
+        EXPECT_EQ(-static_cast<float>(i), batch.y_vec_[i]);
+    }
+
+    std::vector<float> round_trip(xy.size());
+    batch.CopyToInterleaved(round_trip.data());
+    EXPECT_EQ(xy, round_trip);
+}
+
+TEST_F(PointBatchTest, AppendsAfterExistingPoints) {
+    PointBatch batch = PointBatch::FromPoints({{1.f, 2.f}, {3.f, 4.f}});
+    batch.AppendPoint(5.f, 6.f);
+    batch.AppendInterleaved(std::vector<float>{7.f, 8.f, 9.f, 10.f, 11.f, 12.f, 13.f, 14.f, 15.f, 16.f}.data(), 5);
+    ASSERT_EQ(8u, batch.size());
+    for (size_t i = 0; i < batch.size(); ++i) {
+        EXPECT_EQ(2.f * i + 1.f, batch.x_vec_[i]);
+        EXPECT_EQ(2.f * i + 2.f, batch.y_vec_[i]);
+    }
+}
+
+TEST_F(PointBatchTest, CanMakeBatchFromRecords) {
+    auto records = reader_->ReadPointsAndPolygonsFromFile(polygons_file_path_);
+    PointBatch batch = PointBatch::FromRecords(records);
+    ASSERT_EQ(records.size(), batch.size());
+    for (size_t i = 0; i < records.size(); ++i) {
+        EXPECT_EQ(std::get<0>(records[i]), batch.x_vec_[i]);
+        EXPECT_EQ(std::get<1>(records[i]), batch.y_vec_[i]);
+    }
+}
+
+TEST_F(PointBatchTest, BatchAlgorithmsMatchSinglePointCalls) {
+    Polygon square;
+    square.AppendPoint(0.0, 0.0);
+    square.AppendPoint(1.0, 0.0);
+    square.AppendPoint(1.0, 1.0);
+    square.AppendPoint(0.0, 1.0);
+    square.AppendPoint(0.0, 0.0);
+    PointBatch batch = PointBatch::FromPoints({{0.5f, 0.5f}, {2.f, 0.5f}, {0.5f, 0.f}, {-1.f, -1.f}, {0.25f, 0.75f}});
+
+    auto algorithm = winding_number::IWindingNumberAlgorithm::Create();
+    winding_number::EdgeBvh bvh(square);
+    auto from_algorithm = algorithm->CalculateWindingNumbers2D(batch, square);
+    auto from_bvh = bvh.CalculateWindingNumbers2D(batch);
+    ASSERT_EQ(batch.size(), from_algorithm.size());
+    ASSERT_EQ(batch.size(), from_bvh.size());
+    for (size_t i = 0; i < batch.size(); ++i) {
+        auto expected = algorithm->CalculateWindingNumber2D(batch.x_vec_[i], batch.y_vec_[i], square);
+        EXPECT_EQ(expected, from_algorithm[i]);
+        EXPECT_EQ(expected, from_bvh[i]);
+    }
+}
+
+}  // namespace poly
@@ -1,10 +1,14 @@
 #include <gtest/gtest.h>
 #include <poly_io.hpp>
 
+#include <algorithm>
 #include <filesystem>
 #include <memory>
 #include <stdexcept>
+#include <string>
+#include <string_view>
 #include <tuple>
+#include <vector>
 
 namespace poly {
 
@@ -12,10 +16,16 @@ class PolygonTest : public ::testing::Test {
 protected:
     PolygonTest() :
             reader_(IPolygonReader::Create()),
-            polygons_file_path_((std::filesystem::current_path() / "polygons.txt").string()) {}
+            polygons_file_path_((std::filesystem::current_path() / "polygons.txt").string()),
+            multi_polygons_file_path_((std::filesystem::current_path() / "multipolygons.txt").string()),
+            malformed_polygons_file_path_((std::filesystem::current_path() / "malformed_polygons.txt").string()),
+            cube_file_path_((std::filesystem::current_path() / "cube.obj").string()) {}
 
     std::unique_ptr<IPolygonReader> reader_;
     const std::string polygons_file_path_;
+    const std::string multi_polygons_file_path_;
+    const std::string malformed_polygons_file_path_;
+    const std::string cube_file_path_;
 };
 
 TEST_F(PolygonTest, CanMakePolygon) {
@@ -30,6 +40,30 @@ TEST_F(PolygonTest, CanMakePolygon) {
     EXPECT_TRUE(polygon.IsClosed());
 }
 
+TEST_F(PolygonTest, StoresSmallPolygonsInline) {
+    Polygon polygon;
+    for (size_t i = 0; i + 1 < poly::kPolygonInlinePoints; ++i) {
+        polygon.AppendPoint(float(i), float(i * i));
+    }
+    polygon.ClosePolygon();
+    EXPECT_TRUE(polygon.x_vec_.is_inline());
+    EXPECT_TRUE(polygon.y_vec_.is_inline());
+
+    Polygon copy = polygon;
+    copy.AppendPoint(1.0, 1.0);
+    EXPECT_FALSE(copy.x_vec_.is_inline());
+    EXPECT_TRUE(polygon.x_vec_.is_inline());
+    EXPECT_EQ(poly::kPolygonInlinePoints + 1, copy.size());
+    EXPECT_EQ(polygon.y_vec_[3], copy.y_vec_[3]);
+
+    EXPECT_FALSE(Polygon(poly::kPolygonInlinePoints + 1).x_vec_.is_inline());
+
+    auto records = reader_->ReadPointsAndPolygonsFromFile(polygons_file_path_);
+    const auto& [x, y, square] = records.front();
+    EXPECT_EQ(5u, square.size());
+    EXPECT_TRUE(square.x_vec_.is_inline());
+}
+
 TEST_F(PolygonTest, CanMakePolygonFromString) {
     std::string polygon_string = "4.0 5.0 0.0 0.0 1.0 0.0 1.0 1.0 0.0 1.0 0.0 0.0";
     auto point_and_polygon = reader_->CreatePointAndPolygonFromString(polygon_string);
@@ -59,4 +93,369 @@ TEST_F(PolygonTest, FailToMakePolgyonFromStringWithMismatchedXYVectors) {
     EXPECT_THROW(auto polygon = reader_->CreatePointAndPolygonFromString(polygon_string), std::runtime_error);
 }
 
+TEST_F(PolygonTest, CanMakeMultiPolygon) {
+    MultiPolygon multi_polygon;
+    multi_polygon.AppendPoint(0.0, 0.0);
+    multi_polygon.AppendPoint(1.0, 0.0);
+    multi_polygon.AppendPoint(0.0, 1.0);
+    multi_polygon.StartRing();
+    multi_polygon.AppendPoint(2.0, 2.0);
+    multi_polygon.AppendPoint(3.0, 2.0);
+    multi_polygon.AppendPoint(2.0, 3.0);
+    EXPECT_EQ(2u, multi_polygon.ring_count());
+    EXPECT_FALSE(multi_polygon.IsClosed());
+
+    multi_polygon.ClosePolygon();
+    EXPECT_TRUE(multi_polygon.IsClosed());
+    EXPECT_EQ(8u, multi_polygon.size());
+    EXPECT_EQ((std::vector<size_t>{0, 4, 8}), multi_polygon.ring_offsets_);
+    EXPECT_EQ(2.f, multi_polygon.x_vec_[4]);
+}
+
+TEST_F(PolygonTest, ClosesMultiPolygonWithEmptyRings) {
+    MultiPolygon multi_polygon;
+    multi_polygon.StartRing();
+    multi_polygon.ClosePolygon();
+    EXPECT_EQ(1u, multi_polygon.ring_count());
+    EXPECT_EQ(0u, multi_polygon.size());
+    EXPECT_FALSE(multi_polygon.IsClosed());
+
+    multi_polygon.StartRing();
+    multi_polygon.AppendPoint(0.0, 0.0);
+    multi_polygon.AppendPoint(1.0, 0.0);
+    multi_polygon.AppendPoint(0.0, 1.0);
+    multi_polygon.ClosePolygon();
+    EXPECT_EQ(4u, multi_polygon.size());
+    EXPECT_EQ((std::vector<size_t>{0, 0, 4}), multi_polygon.ring_offsets_);
+    EXPECT_EQ(0.f, multi_polygon.x_vec_[3]);
+}
+
+TEST_F(PolygonTest, CanMakeMultiPolygonFromString) {
+    std::string multi_polygon_string = "0.5 0.5 0.0 0.0 1.0 0.0 1.0 1.0 0.0 0.0 | 2.0 2.0  3.0 2.0 3.0 3.0 2.0 2.0";
+    auto [x, y, multi_polygon] = reader_->CreatePointAndMultiPolygonFromString(multi_polygon_string);
+    EXPECT_EQ(0.5f, x);
+    EXPECT_EQ(0.5f, y);
+    EXPECT_EQ(2u, multi_polygon.ring_count());
+    EXPECT_EQ((std::vector<size_t>{0, 4, 8}), multi_polygon.ring_offsets_);
+    EXPECT_TRUE(multi_polygon.IsClosed());
+}
+
+TEST_F(PolygonTest, FailToMakeMultiPolygonFromStringWithEmptyRing) {
+    EXPECT_THROW(reader_->CreatePointAndMultiPolygonFromString("0.0 0.0 0.0 0.0 1.0 0.0 1.0 1.0 0.0 0.0 | |"),
+                 std::runtime_error);
+    EXPECT_THROW(reader_->CreatePointAndMultiPolygonFromString("0.0 0.0 0.0 0.0 1.0 0.0 1.0 1.0 0.0 0.0 |"),
+                 std::runtime_error);
+    EXPECT_THROW(reader_->CreatePointAndMultiPolygonFromString("0.0 0.0 0.0 0.0 1.0 0.0 1.0 | 1.0 0.0 0.0"),
+                 std::runtime_error);
+}
+
+TEST_F(PolygonTest, CanReadMultiPolygonsFromFile) {
+    auto multi_polygons = reader_->ReadPointsAndMultiPolygonsFromFile(multi_polygons_file_path_);
+    ASSERT_EQ(6u, multi_polygons.size());
+    EXPECT_EQ(2u, std::get<2>(multi_polygons[0]).ring_count());
+    EXPECT_EQ(1u, std::get<2>(multi_polygons[4]).ring_count());
+}
+
+TEST_F(PolygonTest, CountsWhatAFileHolds) {
+    ReadStatistics statistics;
+    auto polygons = reader_->ReadPointsAndPolygonsFromFile(malformed_polygons_file_path_, statistics);
+    ASSERT_EQ(3u, polygons.size());
+    EXPECT_EQ(-0.5f, std::get<1>(polygons[2]));
+    EXPECT_EQ(11u, statistics.lines);
+    EXPECT_EQ(3u, statistics.records);
+    EXPECT_EQ(2u, statistics.comment_lines);
+    EXPECT_EQ(2u, statistics.blank_lines);
+    EXPECT_EQ((std::vector<size_t>{5, 7, 8, 9}), statistics.malformed_lines);
+    EXPECT_EQ(std::filesystem::file_size(malformed_polygons_file_path_), statistics.bytes_read);
+    EXPECT_LE(statistics.parse_time, statistics.read_time);
+    EXPECT_GT(statistics.bytes_per_second(), 0.0);
+    EXPECT_GT(statistics.records_per_second(), 0.0);
+}
+
+TEST_F(PolygonTest, CountsCommentsInPolygonsFile) {
+    ReadStatistics statistics;
+    auto polygons = reader_->ReadPointsAndPolygonsFromFile(polygons_file_path_, statistics);
+    EXPECT_EQ(polygons.size(), statistics.records);
+    EXPECT_EQ(statistics.lines, statistics.records + statistics.comment_lines + statistics.blank_lines);
+    EXPECT_TRUE(statistics.malformed_lines.empty());
+    EXPECT_EQ(reader_->ReadPointsAndPolygonsFromFile(polygons_file_path_).size(), polygons.size());
+}
+
+TEST_F(PolygonTest, CountsWhatAMultiPolygonFileHolds) {
+    ReadStatistics statistics;
+    auto multi_polygons = reader_->ReadPointsAndMultiPolygonsFromFile(multi_polygons_file_path_, statistics);
+    EXPECT_EQ(6u, statistics.records);
+    EXPECT_EQ(multi_polygons.size(), statistics.records);
+}
+
+TEST_F(PolygonTest, FailToMakePolygonFromStringWithTrailingCharacters) {
+    EXPECT_THROW(reader_->CreatePointAndPolygonFromString("0.5abc 0.5 0.0 0.0 1.0 0.0 1.0 1.0 0.0 0.0"),
+                 std::runtime_error);
+    EXPECT_THROW(reader_->CreatePointAndPolygonFromString("1e99 0.5 0.0 0.0 1.0 0.0 1.0 1.0 0.0 0.0"),
+                 std::runtime_error);
+    EXPECT_THROW(reader_->CreatePointAndPolygonFromString("   "), std::runtime_error);
+
+    // The throwing call keeps the message it gave before the Try...() calls existed.
+    try {
+        reader_->CreatePointAndPolygonFromString("1e99 0.5 0.0 0.0 1.0 0.0 1.0 1.0 0.0 0.0");
+        ADD_FAILURE() << "expected a value out of range to throw";
+    } catch (const std::runtime_error& error) {
+        EXPECT_STREQ("Could not parse line because this is too large to fit in a float: 1e99", error.what());
+    }
+}
+
+TEST_F(PolygonTest, TryReportsWhereAStringIsMalformed) {
+    auto result = reader_->TryCreatePointAndPolygonFromString("0.0 0.0 1.0 0.0 1.0 I_Am_Not_A_float 1.0 0.0 1.0 0.0");
+    EXPECT_EQ(ParseStatus::kMalformed, result.status);
+    EXPECT_FALSE(result.ok());
+    EXPECT_EQ(20u, result.error_position);
+    EXPECT_NE(std::string::npos, result.error_message.find("I_Am_Not_A_float"));
+
+    std::string missing_y = "4.0 5.0 0.0 0.0 1.0 0.0 3.0";
+    result = reader_->TryCreatePointAndPolygonFromString(missing_y);
+    EXPECT_EQ(ParseStatus::kMalformed, result.status);
+    EXPECT_EQ(missing_y.size(), result.error_position);
+
+    auto multi_result = reader_->TryCreatePointAndMultiPolygonFromString("0.0 0.0 0.0 0.0 1.0 0.0 1.0 1.0 0.0 0.0 | |");
+    EXPECT_EQ(ParseStatus::kMalformed, multi_result.status);
+    EXPECT_EQ(42u, multi_result.error_position);
+}
+
+TEST_F(PolygonTest, TryParsesRecordsCommentsAndBlankLines) {
+    auto result = reader_->TryCreatePointAndPolygonFromString("4.0 5.0 0.0 0.0 1.0 0.0 1.0 1.0 0.0 0.0");
+    ASSERT_TRUE(result.ok());
+    EXPECT_EQ(4.f, std::get<0>(result.record));
+    EXPECT_EQ(4u, std::get<2>(result.record).size());
+    EXPECT_EQ(ParseStatus::kComment, reader_->TryCreatePointAndPolygonFromString("  # a comment").status);
+    EXPECT_EQ(ParseStatus::kBlank, reader_->TryCreatePointAndPolygonFromString(" \t ").status);
+    EXPECT_EQ(ParseStatus::kComment, reader_->TryCreatePointAndMultiPolygonFromString("#").status);
+    // The throwing call keeps the message it gave before comments were told apart.
+    try {
+        reader_->CreatePointAndPolygonFromString("# a comment");
+        ADD_FAILURE() << "expected a comment to throw";
+    } catch (const std::runtime_error& error) {
+        EXPECT_STREQ("Could not parse line because this is not a floating point value: #", error.what());
+    }
+}
+
+TEST_F(PolygonTest, TryReadReportsMissingFilesWithoutThrowing) {
+    auto result = reader_->TryReadPointsAndPolygonsFromFile("no_such_file.txt");
+    EXPECT_EQ(ReadStatus::kNotAFile, result.status);
+    EXPECT_TRUE(result.records.empty());
+    EXPECT_FALSE(result.error_message.empty());
+    EXPECT_EQ(ReadStatus::kNotAFile,
+              reader_->TryReadPointsAndMultiPolygonsFromFile(std::filesystem::current_path().string()).status);
+    EXPECT_THROW(reader_->ReadPointsAndPolygonsFromFile("no_such_file.txt"), std::runtime_error);
+}
+
+TEST_F(PolygonTest, TryReadMatchesThrowingRead) {
+    auto result = reader_->TryReadPointsAndPolygonsFromFile(malformed_polygons_file_path_);
+    ASSERT_TRUE(result.ok());
+    EXPECT_EQ(3u, result.records.size());
+    EXPECT_EQ((std::vector<size_t>{5, 7, 8, 9}), result.statistics.malformed_lines);
+    EXPECT_EQ(reader_->ReadPointsAndPolygonsFromFile(malformed_polygons_file_path_).size(), result.records.size());
+}
+
+// Writes down what an IRecordSink is told, one event per character.
+class RecordingSink : public IRecordSink {
+public:
+    void StartRecord(float point_x, float point_y) override {
+        events_ += 'S';
+        points_.push_back(point_x);
+        points_.push_back(point_y);
+    }
+    void AppendPoint(float x, float y) override {
+        events_ += 'P';
+        points_.push_back(x);
+        points_.push_back(y);
+    }
+    void EndRecord() override {
+        events_ += 'E';
+    }
+
+    std::string events_;
+    std::vector<float> points_;
+};
+
+TEST_F(PolygonTest, TryStreamPassesValuesToTheSink) {
+    RecordingSink sink;
+    auto result = reader_->TryStreamPointAndPolygonFromString("4.0 5.0 0.0 0.0 1.0 0.0 1.0 1.0 0.0 0.0", sink);
+    ASSERT_TRUE(result.ok());
+    EXPECT_EQ(std::make_tuple(4.f, 5.f, size_t(4)), result.record);
+    EXPECT_EQ("SPPPPE", sink.events_);
+    EXPECT_EQ((std::vector<float>{4, 5, 0, 0, 1, 0, 1, 1, 0, 0}), sink.points_);
+
+    // A malformed record ends without EndRecord(), with the same error as the non-streaming call.
+    RecordingSink malformed_sink;
+    const std::string malformed = "0.0 0.0 1.0 0.0 1.0 I_Am_Not_A_float 1.0 0.0 1.0 0.0";
+    result = reader_->TryStreamPointAndPolygonFromString(malformed, malformed_sink);
+    EXPECT_EQ(ParseStatus::kMalformed, result.status);
+    EXPECT_EQ(reader_->TryCreatePointAndPolygonFromString(malformed).error_position, result.error_position);
+    EXPECT_EQ("SP", malformed_sink.events_);
+    EXPECT_EQ(ParseStatus::kComment, reader_->TryStreamPointAndPolygonFromString("# a comment", malformed_sink).status);
+    EXPECT_EQ("SP", malformed_sink.events_);
+}
+
+TEST_F(PolygonTest, TryStreamReadMatchesTryRead) {
+    RecordingSink sink;
+    auto streamed = reader_->TryStreamPointsAndPolygonsFromFile(malformed_polygons_file_path_, sink);
+    auto read = reader_->TryReadPointsAndPolygonsFromFile(malformed_polygons_file_path_);
+    ASSERT_TRUE(streamed.ok());
+    ASSERT_EQ(read.records.size(), streamed.records.size());
+    for (size_t i = 0; i < read.records.size(); ++i) {
+        EXPECT_EQ(std::get<0>(read.records[i]), std::get<0>(streamed.records[i]));
+        EXPECT_EQ(std::get<1>(read.records[i]), std::get<1>(streamed.records[i]));
+        EXPECT_EQ(std::get<2>(read.records[i]).size(), std::get<2>(streamed.records[i]));
+    }
+    EXPECT_EQ(read.statistics.malformed_lines, streamed.statistics.malformed_lines);
+    EXPECT_EQ(read.records.size(), size_t(std::count(sink.events_.begin(), sink.events_.end(), 'E')));
+    EXPECT_EQ(ReadStatus::kNotAFile, reader_->TryStreamPointsAndPolygonsFromFile("no_such_file.txt", sink).status);
+}
+
+// A reader that implements only the calls IPolygonReader requires, with the default reader's parsing, so that its other
+// calls are the defaults built on them.
+class BaselineReader : public IPolygonReader {
+public:
+    using IPolygonReader::ReadPointsAndPolygonsFromFile;
+
+    std::tuple<float, float, Polygon> CreatePointAndPolygonFromString(std::string_view polygon_string) override {
+        return reader_->CreatePointAndPolygonFromString(polygon_string);
+    }
+
+    std::vector<std::tuple<float, float, Polygon>> ReadPointsAndPolygonsFromFile(std::string_view filepath) override {
+        return reader_->ReadPointsAndPolygonsFromFile(filepath);
+    }
+
+private:
+    std::unique_ptr<IPolygonReader> reader_ = IPolygonReader::Create();
+};
+
+TEST_F(PolygonTest, DefaultMultiPolygonCallsMatchTheReader) {
+    BaselineReader baseline;
+    const std::string multi_polygon_string =
+            "0.5 0.5 0.0 0.0 1.0 0.0 1.0 1.0 0.0 0.0 | 2.0 2.0  3.0 2.0 3.0 3.0 2.0 2.0";
+    auto [x, y, multi_polygon] = baseline.CreatePointAndMultiPolygonFromString(multi_polygon_string);
+    auto expected = std::get<2>(reader_->CreatePointAndMultiPolygonFromString(multi_polygon_string));
+    EXPECT_EQ(0.5f, x);
+    EXPECT_EQ(0.5f, y);
+    EXPECT_EQ(expected.x_vec_, multi_polygon.x_vec_);
+    EXPECT_EQ(expected.y_vec_, multi_polygon.y_vec_);
+    EXPECT_EQ(expected.ring_offsets_, multi_polygon.ring_offsets_);
+    EXPECT_EQ(1u, std::get<2>(baseline.CreatePointAndMultiPolygonFromString("0.5 0.5")).ring_count());
+    for (const char* malformed : {"0.0 0.0 0.0 0.0 1.0 0.0 1.0 1.0 0.0 0.0 | |", "0.0 0.0 0.0 0.0 1.0 0.0 1.0 1.0 |",
+                                  "0.0 0.0 | 0.0 0.0 1.0 0.0", "0.0 0.0 0.0 0.0 1.0 0.0 1.0 | 1.0 0.0 0.0"}) {
+        EXPECT_THROW(baseline.CreatePointAndMultiPolygonFromString(malformed), std::runtime_error) << malformed;
+    }
+
+    ReadStatistics statistics, expected_statistics;
+    auto multi_polygons = baseline.ReadPointsAndMultiPolygonsFromFile(multi_polygons_file_path_, statistics);
+    auto expected_multi_polygons = reader_->ReadPointsAndMultiPolygonsFromFile(multi_polygons_file_path_,
+                                                                               expected_statistics);
+    ASSERT_EQ(expected_multi_polygons.size(), multi_polygons.size());
+    for (size_t i = 0; i < multi_polygons.size(); ++i) {
+        EXPECT_EQ(std::get<2>(expected_multi_polygons[i]).ring_offsets_,
+                  std::get<2>(multi_polygons[i]).ring_offsets_);
+    }
+    EXPECT_EQ(expected_statistics.lines, statistics.lines);
+    EXPECT_EQ(expected_statistics.comment_lines, statistics.comment_lines);
+    EXPECT_EQ(multi_polygons.size(), baseline.ReadPointsAndMultiPolygonsFromFile(multi_polygons_file_path_).size());
+    EXPECT_THROW(baseline.ReadPointsAndMultiPolygonsFromFile("no_such_file.txt"), std::runtime_error);
+}
+
+TEST_F(PolygonTest, DefaultReadFillsInWhatItCan) {
+    BaselineReader baseline;
+    ReadStatistics statistics;
+    statistics.lines = 1;
+    auto polygons = baseline.ReadPointsAndPolygonsFromFile(malformed_polygons_file_path_, statistics);
+    EXPECT_EQ(3u, polygons.size());
+    EXPECT_EQ(3u, statistics.records);
+    EXPECT_EQ(std::filesystem::file_size(malformed_polygons_file_path_), statistics.bytes_read);
+    EXPECT_GT(statistics.read_time.count(), 0);
+    // What each line held is left out, rather than left over from before.
+    EXPECT_EQ(0u, statistics.lines);
+    EXPECT_TRUE(statistics.malformed_lines.empty());
+    EXPECT_THROW(baseline.ReadPointsAndPolygonsFromFile("no_such_file.txt", statistics), std::runtime_error);
+}
+
+TEST_F(PolygonTest, DefaultTryCallsCatchWhatTheThrowingCallsThrow) {
+    BaselineReader baseline;
+    auto parsed = baseline.TryCreatePointAndPolygonFromString("4.0 5.0 0.0 0.0 1.0 0.0 1.0 1.0 0.0 0.0");
+    ASSERT_TRUE(parsed.ok());
+    EXPECT_EQ(4u, std::get<2>(parsed.record).size());
+    EXPECT_EQ(ParseStatus::kComment, baseline.TryCreatePointAndPolygonFromString("  # a comment").status);
+    EXPECT_EQ(ParseStatus::kBlank, baseline.TryCreatePointAndPolygonFromString(" \t").status);
+
+    const std::string malformed = "0.0 0.0 1.0 0.0 1.0 I_Am_Not_A_float 1.0 0.0 1.0 0.0";
+    parsed = baseline.TryCreatePointAndPolygonFromString(malformed);
+    EXPECT_EQ(ParseStatus::kMalformed, parsed.status);
+    EXPECT_EQ(0u, parsed.error_position);
+    EXPECT_EQ(reader_->TryCreatePointAndPolygonFromString(malformed).error_message, parsed.error_message);
+    EXPECT_EQ(ParseStatus::kMalformed,
+              baseline.TryCreatePointAndMultiPolygonFromString("0.0 0.0 0.0 0.0 1.0 0.0 1.0 1.0 0.0 0.0 |").status);
+    EXPECT_EQ(2u, std::get<2>(baseline.TryCreatePointAndMultiPolygonFromString("0 0 1 1 | 2 2").record).ring_count());
+
+    auto read = baseline.TryReadPointsAndPolygonsFromFile(malformed_polygons_file_path_);
+    ASSERT_TRUE(read.ok());
+    EXPECT_EQ(3u, read.records.size());
+    EXPECT_EQ(3u, read.statistics.records);
+    auto multi_read = baseline.TryReadPointsAndMultiPolygonsFromFile(multi_polygons_file_path_);
+    ASSERT_TRUE(multi_read.ok());
+    EXPECT_EQ(6u, multi_read.records.size());
+    EXPECT_EQ(ReadStatus::kNotAFile, baseline.TryReadPointsAndPolygonsFromFile("no_such_file.txt").status);
+    EXPECT_EQ(ReadStatus::kNotAFile,
+              baseline.TryReadPointsAndMultiPolygonsFromFile(std::filesystem::current_path().string()).status);
+}
+
+TEST_F(PolygonTest, DefaultTryStreamReplaysRecordsIntoTheSink) {
+    BaselineReader baseline;
+    RecordingSink sink;
+    auto result = baseline.TryStreamPointAndPolygonFromString("4.0 5.0 0.0 0.0 1.0 0.0 1.0 1.0 0.0 0.0", sink);
+    ASSERT_TRUE(result.ok());
+    EXPECT_EQ(std::make_tuple(4.f, 5.f, size_t(4)), result.record);
+    EXPECT_EQ("SPPPPE", sink.events_);
+    EXPECT_EQ((std::vector<float>{4, 5, 0, 0, 1, 0, 1, 1, 0, 0}), sink.points_);
+
+    // Unlike the default reader's, a malformed record is rejected before the sink hears of it.
+    result = baseline.TryStreamPointAndPolygonFromString("0.0 0.0 1.0 0.0 1.0 I_Am_Not_A_float", sink);
+    EXPECT_EQ(ParseStatus::kMalformed, result.status);
+    EXPECT_FALSE(result.error_message.empty());
+    EXPECT_EQ("SPPPPE", sink.events_);
+
+    RecordingSink file_sink, expected_sink;
+    auto streamed = baseline.TryStreamPointsAndPolygonsFromFile(malformed_polygons_file_path_, file_sink);
+    auto expected = reader_->TryStreamPointsAndPolygonsFromFile(malformed_polygons_file_path_, expected_sink);
+    ASSERT_TRUE(streamed.ok());
+    EXPECT_EQ(expected.records, streamed.records);
+    EXPECT_EQ(expected.statistics.records, streamed.statistics.records);
+    EXPECT_EQ(streamed.records.size(), size_t(std::count(file_sink.events_.begin(), file_sink.events_.end(), 'S')));
+    EXPECT_EQ(streamed.records.size(), size_t(std::count(file_sink.events_.begin(), file_sink.events_.end(), 'E')));
+    EXPECT_EQ(ReadStatus::kNotAFile, baseline.TryStreamPointsAndPolygonsFromFile("no_such_file.txt", sink).status);
+}
+
+TEST_F(PolygonTest, ReadsTriangleMeshesFromObjFiles) {
+    auto result = TryReadTriangleMeshFromFile(cube_file_path_);
+    ASSERT_TRUE(result.ok());
+    EXPECT_EQ(8u, result.mesh.vertex_count());
+    EXPECT_EQ(0.f, result.mesh.x_vec_[0]);
+    EXPECT_EQ(1.f, result.mesh.z_vec_[7]);
+    // Six quads split around their first vertex, whichever way the references are written.
+    ASSERT_EQ(12u, result.mesh.triangle_count());
+    EXPECT_EQ((std::vector<uint32_t>{0, 3, 2, 0, 2, 1}),
+              std::vector<uint32_t>(result.mesh.triangles_.begin(), result.mesh.triangles_.begin() + 6));
+    EXPECT_EQ((std::vector<uint32_t>{3, 7, 6, 3, 6, 2}),
+              std::vector<uint32_t>(result.mesh.triangles_.begin() + 24, result.mesh.triangles_.begin() + 30));
+
+    const ReadStatistics& statistics = result.statistics;
+    EXPECT_EQ(28u, statistics.lines);
+    EXPECT_EQ(14u, statistics.records);
+    EXPECT_EQ(8u, statistics.comment_lines);
+    EXPECT_EQ(3u, statistics.blank_lines);
+    EXPECT_EQ((std::vector<size_t>{26, 27, 28}), statistics.malformed_lines);
+    EXPECT_EQ(std::filesystem::file_size(cube_file_path_), statistics.bytes_read);
+
+    EXPECT_EQ(result.mesh.triangles_, ReadTriangleMeshFromFile(cube_file_path_).triangles_);
+    EXPECT_EQ(ReadStatus::kNotAFile, TryReadTriangleMeshFromFile("no_such_file.obj").status);
+    EXPECT_THROW(ReadTriangleMeshFromFile("no_such_file.obj"), std::runtime_error);
+}
+
 }  // namespace poly
@@ -0,0 +1,148 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <optional>
+#include <random>
+
+#include <engine_test.hpp>
+#include <exact_predicates.hpp>
+#include <poly_io.hpp>
+#include <polygon_arrangement.hpp>
+#include <winding.hpp>
+
+namespace winding_number {
+
+using poly::Polygon;
+
+class PolygonArrangementTest : public EngineTest<> {
+protected:
+    // The star polygon {n/k}: n points on the unit circle, joining every k-th one.
+    static Polygon MakeStar(int n, int k) {
+        Polygon p;
+        for (int i = 0; i < n; ++i) {
+            const float angle = 6.2831853f * (i * k % n) / n;
+            p.AppendPoint(std::cos(angle), std::sin(angle));
+        }
+        p.ClosePolygon();
+        return p;
+    }
+};
+
+TEST_F(PolygonArrangementTest, MatchesAlgorithmForPolygonsFromFile) {
+    auto points_and_polygons = reader_->ReadPointsAndPolygonsFromFile(polygons_file_path_);
+    ASSERT_FALSE(points_and_polygons.empty());
+    for (size_t i = 0; i < points_and_polygons.size(); ++i) {
+        const auto& [x, y, polygon] = points_and_polygons[i];
+        const PolygonArrangement arrangement(polygon, tolerance_);
+        EXPECT_EQ(algorithm_->CalculateWindingNumber2D(x, y, polygon), arrangement.CalculateWindingNumber2D(x, y))
+                << "for record " << i;
+    }
+}
+
+TEST_F(PolygonArrangementTest, LabelsTheFacesOfStars) {
+    const PolygonArrangement pentagram(MakeStar(5, 2));
+    EXPECT_EQ(5u, pentagram.crossing_count());
+    EXPECT_EQ(std::optional<int>(2), pentagram.CalculateWindingNumber2D(0.f, 0.f));
+    EXPECT_EQ(std::optional<int>(1), pentagram.CalculateWindingNumber2D(0.7f, 0.05f));
+    EXPECT_EQ(std::optional<int>(0), pentagram.CalculateWindingNumber2D(0.f, -0.9f));
+    EXPECT_EQ(std::optional<int>(0), pentagram.CalculateWindingNumber2D(2.f, 0.f));
+
+    // {n/k} crosses itself n (k - 1) times and winds k times around its center.
+    std::mt19937 random(48);
+    std::uniform_real_distribution<float> coordinate(-1.1f, 1.1f);
+    for (auto [n, k] : {std::pair(7, 3), {11, 4}, {31, 15}}) {
+        const Polygon star = MakeStar(n, k);
+        const PolygonArrangement arrangement(star);
+        EXPECT_EQ(size_t(n * (k - 1)), arrangement.crossing_count()) << n << "/" << k;
+        EXPECT_EQ(std::optional<int>(k), arrangement.CalculateWindingNumber2D(0.f, 0.f)) << n << "/" << k;
+        for (int i = 0; i < 2000; ++i) {
+            const float x = coordinate(random), y = coordinate(random);
+            ASSERT_EQ(ExactWindingNumber2D(x, y, star), arrangement.CalculateWindingNumber2D(x, y))
+                    << n << "/" << k << " at " << x << ", " << y;
+        }
+    }
+}
+
+TEST_F(PolygonArrangementTest, MatchesScalarOnGridPolygons) {
+    // Random polygons through points of a small integer grid cross themselves at rational points, overlap along shared
+    // lines and pass through each other's vertices. Queries on the half grid land on all of those. The coordinates are
+    // small, so the scalar engine is exact on them.
+    std::mt19937 random(480);
+    std::uniform_int_distribution<int> coordinate(-4, 4);
+    for (int round = 0; round < 100; ++round) {
+        Polygon polygon;
+        for (int i = 0; i < 3 + round % 12; ++i) {
+            polygon.AppendPoint(float(coordinate(random)), float(coordinate(random)));
+        }
+        polygon.ClosePolygon();
+        const PolygonArrangement arrangement(polygon);
+        for (float y = -5.f; y <= 5.f; y += 0.25f) {
+            for (float x = -5.f; x <= 5.f; x += 0.25f) {
+                ASSERT_EQ(scalar_->CalculateWindingNumber2D(x, y, polygon), arrangement.CalculateWindingNumber2D(x, y))
+                        << "round " << round << " at " << x << ", " << y;
+            }
+        }
+    }
+}
+
+TEST_F(PolygonArrangementTest, BatchMatchesSinglePoints) {
+    // A spiral that winds 20 times, closed by a straight line back across every loop.
+    Polygon spiral;
+    for (int i = 0; i <= 20 * 64; ++i) {
+        const float t = i / 64.f;
+        spiral.AppendPoint((1.f + t) * std::cos(6.2831853f * t), (1.f + t) * std::sin(6.2831853f * t));
+    }
+    spiral.ClosePolygon();
+    const PolygonArrangement arrangement(spiral);
+    EXPECT_TRUE(arrangement.has_slabs());
+    EXPECT_EQ(std::optional<int>(20), arrangement.CalculateWindingNumber2D(0.f, 0.f));
+
+    std::mt19937 random(4800);
+    std::uniform_real_distribution<float> coordinate(-22.f, 22.f);
+    poly::PointBatch points;
+    for (int i = 0; i < 2000; ++i) {
+        points.AppendPoint(coordinate(random), coordinate(random));
+    }
+    const auto winding_numbers = arrangement.CalculateWindingNumbers2D(points);
+    ASSERT_EQ(points.size(), winding_numbers.size());
+    for (size_t i = 0; i < points.size(); ++i) {
+        EXPECT_EQ(ExactWindingNumber2D(points.x_vec_[i], points.y_vec_[i], spiral), winding_numbers[i]);
+    }
+}
+
+TEST_F(PolygonArrangementTest, FallsBackOverBudget) {
+    // {401/200} crosses itself 80 thousand times, with most of its edges in every slab: far more slab entries
+    // than kMaxSlabEdges.
+    const Polygon star = MakeStar(401, 200);
+    const PolygonArrangement arrangement(star);
+    EXPECT_FALSE(arrangement.has_slabs());
+    EXPECT_EQ(0u, arrangement.crossing_count());
+    EXPECT_EQ(0u, arrangement.slab_count());
+    EXPECT_EQ(std::optional<int>(200), arrangement.CalculateWindingNumber2D(0.f, 0.f));
+
+    std::mt19937 random(48000);
+    std::uniform_real_distribution<float> coordinate(-1.1f, 1.1f);
+    for (int i = 0; i < 500; ++i) {
+        const float x = coordinate(random), y = coordinate(random);
+        ASSERT_EQ(ExactWindingNumber2D(x, y, star), arrangement.CalculateWindingNumber2D(x, y))
+                << "at " << x << ", " << y;
+    }
+    EXPECT_TRUE(PolygonArrangement(MakeStar(31, 15)).has_slabs());
+}
+
+TEST_F(PolygonArrangementTest, FailsWithUnclosedPolygon) {
+    Polygon p;
+    p.AppendPoint(0.0, 0.0);
+    p.AppendPoint(1.0, 0.0);
+    p.AppendPoint(1.0, 1.0);
+    const PolygonArrangement arrangement(p);
+    EXPECT_EQ(std::nullopt, arrangement.CalculateWindingNumber2D(0.5, 0.25));
+    EXPECT_EQ(0u, arrangement.slab_count());
+    EXPECT_EQ(std::nullopt, PolygonArrangement(Polygon()).CalculateWindingNumber2D(0.0, 0.0));
+
+    p.AppendPoint(1e-7f, 0.0);
+    EXPECT_EQ(std::optional<int>(1), PolygonArrangement(p, 1e-6f).CalculateWindingNumber2D(0.75, 0.25));
+}
+
+}  // namespace winding_number
@@ -0,0 +1,46 @@
+#include <gtest/gtest.h>
+
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <sstream>
+#include <string>
+
+#include <engine_test.hpp>
+#include <poly_io.hpp>
+#include <winding.hpp>
+
+namespace winding_number {
+
+using PolygonGenTest = EngineTest<>;
+
+TEST_F(PolygonGenTest, AnnotationsMatchScalar) {
+    // Every shape, with both hits and misses, and small polygons whose hit points are the hardest to place.
+    const std::string output_path = (std::filesystem::current_path() / "polygon_gen_test.txt").string();
+    for (const char* vertices : {"4", "7", "50"}) {
+        const std::string command = std::string("\"") + POLYGON_GEN_PATH + "\" --records 400 --vertices " +
+                                    vertices + " --seed 31 --annotate --output \"" + output_path + "\"";
+        ASSERT_EQ(0, std::system(command.c_str())) << command;
+
+        std::ifstream file(output_path);
+        ASSERT_TRUE(file) << output_path;
+        std::string annotation, record;
+        size_t records = 0;
+        while (std::getline(file, annotation) && std::getline(file, record)) {
+            std::istringstream fields(annotation);
+            std::string hash, shape;
+            int expected = 0;
+            ASSERT_TRUE(fields >> hash >> shape >> expected) << annotation;
+            ASSERT_EQ("#", hash) << annotation;
+            const auto [x, y, polygon] = reader_->CreatePointAndPolygonFromString(record);
+            EXPECT_EQ(std::optional<int>(expected), scalar_->CalculateWindingNumber2D(x, y, polygon))
+                    << shape << " record " << records << " with " << vertices << " vertices";
+            ++records;
+        }
+        EXPECT_EQ(400u, records);
+    }
+    std::filesystem::remove(output_path);
+}
+
+}  // namespace winding_number
@@ -0,0 +1,128 @@
+#include <gtest/gtest.h>
+
+#include <optional>
+#include <random>
+
+#include <engine_test.hpp>
+#include <point_batch.hpp>
+#include <poly_io.hpp>
+#include <polygon_lanes.hpp>
+#include <winding.hpp>
+
+namespace winding_number {
+
+using poly::Polygon;
+using poly::PolygonLanes;
+
+class PolygonLanesTest : public EngineTest<> {
+protected:
+    // Compares every polygon against the scalar algorithm on a grid that hits the vertices, the sides and the lines
+    // through them.
+    void ExpectMatchesScalarOnGrid(const std::vector<Polygon>& polygons, float low, float high, float step) {
+        PolygonLanes lanes(polygons);
+        for (float y = low; y <= high; y += step) {
+            for (float x = low; x <= high; x += step) {
+                const auto winding_numbers = CalculateWindingNumbers2D(x, y, lanes);
+                ASSERT_EQ(polygons.size(), winding_numbers.size());
+                for (size_t j = 0; j < polygons.size(); ++j) {
+                    EXPECT_EQ(scalar_->CalculateWindingNumber2D(x, y, polygons[j]), winding_numbers[j])
+                            << "for polygon " << j << " at " << x << ", " << y;
+                }
+            }
+        }
+    }
+};
+
+TEST_F(PolygonLanesTest, MatchesScalarForPolygonsFromFile) {
+    auto points_and_polygons = reader_->ReadPointsAndPolygonsFromFile(polygons_file_path_);
+    ASSERT_FALSE(points_and_polygons.empty());
+    const PolygonLanes lanes = PolygonLanes::FromRecords(points_and_polygons, tolerance_);
+    ASSERT_EQ(points_and_polygons.size(), lanes.size());
+    for (size_t i = 0; i < points_and_polygons.size(); ++i) {
+        const auto& [x, y, polygon] = points_and_polygons[i];
+        EXPECT_EQ(scalar_->CalculateWindingNumber2D(x, y, polygon), CalculateWindingNumbers2D(x, y, lanes)[i])
+                << "for record " << i;
+    }
+}
+
+TEST_F(PolygonLanesTest, GroupsPolygonsByEdgeCount) {
+    const Polygon triangle = MakePolygon({{0, 0}, {1, 0}, {0, 1}});
+    const Polygon square = MakePolygon({{0, 0}, {1, 0}, {1, 1}, {0, 1}});
+    Polygon open;
+    open.AppendPoint(0, 0);
+    open.AppendPoint(1, 0);
+    open.AppendPoint(1, 1);
+
+    std::vector<Polygon> polygons;
+    for (size_t i = 0; i < PolygonLanes::kLaneCount + 1; ++i) {
+        polygons.push_back(triangle);
+        polygons.push_back(square);
+    }
+    polygons.push_back(open);
+
+    const PolygonLanes lanes(polygons);
+    EXPECT_EQ(polygons.size(), lanes.size());
+    ASSERT_EQ(2u, lanes.groups().size());
+    for (const auto& group : lanes.groups()) {
+        EXPECT_EQ(PolygonLanes::kLaneCount + 1, group.polygons.size());
+        EXPECT_EQ(2u, group.block_count());
+        EXPECT_EQ(2 * group.block_stride(), group.x_vec_.size());
+        for (size_t index : group.polygons) {
+            EXPECT_EQ(group.edge_count + 1, polygons[index].size());
+        }
+    }
+    EXPECT_EQ(std::vector<size_t>{polygons.size() - 1}, lanes.unclosed());
+
+    // Results come back in input order, whatever the grouping.
+    const auto winding_numbers = CalculateWindingNumbers2D(0.75f, 0.75f, lanes);
+    for (size_t i = 0; i + 1 < polygons.size(); ++i) {
+        EXPECT_EQ(i % 2 == 0 ? 0 : 1, winding_numbers[i]) << "for polygon " << i;
+    }
+    EXPECT_FALSE(winding_numbers.back());
+}
+
+TEST_F(PolygonLanesTest, MatchesScalarForMixedSizes) {
+    // Small integer coordinates make vertices and edges land on grid points, and many of the polygons cross
+    // themselves. Group sizes are not multiples of the lane count, so padded lanes are exercised too.
+    std::mt19937 random(41);
+    std::uniform_int_distribution<int> coordinate(0, 4);
+    std::uniform_int_distribution<size_t> size(1, 14);
+    std::vector<Polygon> polygons;
+    for (int i = 0; i < 150; ++i) {
+        Polygon polygon;
+        for (size_t points = size(random); points > 0; --points) {
+            polygon.AppendPoint(coordinate(random), coordinate(random));
+        }
+        polygon.ClosePolygon();
+        polygons.push_back(polygon);
+    }
+    ExpectMatchesScalarOnGrid(polygons, -0.5f, 4.5f, 0.5f);
+}
+
+TEST_F(PolygonLanesTest, BatchMatchesSinglePoints) {
+    std::vector<Polygon> polygons{MakePolygon({{0, 0}, {2, 0}, {2, 2}, {0, 2}}),
+                                  MakePolygon({{0, 0}, {2, 0}, {1, 2}}),
+                                  MakePolygon({{0, 0}, {2, 0}, {0, 2}, {2, 2}})};
+    // Enough triangles for several blocks in one group, and a polygon that is not closed.
+    for (int i = 0; i < 20; ++i) {
+        polygons.push_back(MakePolygon({{0, 0}, {i * 0.25f, 0}, {0, 2}}));
+    }
+    Polygon unclosed;
+    unclosed.AppendPoint(0.f, 0.f);
+    unclosed.AppendPoint(2.f, 0.f);
+    unclosed.AppendPoint(2.f, 2.f);
+    polygons.push_back(unclosed);
+    const PolygonLanes lanes(polygons);
+    const auto points = poly::PointBatch::FromPoints({{1.f, 1.f}, {1.f, 0.f}, {3.f, 1.f}, {0.5f, 1.5f}});
+    const auto winding_numbers = CalculateWindingNumbers2D(points, lanes);
+    ASSERT_EQ(points.size() * polygons.size(), winding_numbers.size());
+    for (size_t i = 0; i < points.size(); ++i) {
+        const auto expected = CalculateWindingNumbers2D(points.x_vec_[i], points.y_vec_[i], lanes);
+        for (size_t j = 0; j < polygons.size(); ++j) {
+            EXPECT_EQ(expected[j], winding_numbers[i * polygons.size() + j]) << "for point " << i << ", polygon " << j;
+        }
+    }
+    EXPECT_TRUE(CalculateWindingNumbers2D(points, PolygonLanes({})).empty());
+}
+
+}  // namespace winding_number
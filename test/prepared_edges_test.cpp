@@ -0,0 +1,125 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <optional>
+#include <random>
+#include <tuple>
+
+#include <engine_test.hpp>
+#include <prepared_edges.hpp>
+#include <poly_io.hpp>
+#include <winding.hpp>
+
+namespace winding_number {
+
+using poly::Polygon;
+
+using PreparedEdgesTest = EngineTest<::testing::TestWithParam<EdgeForm>>;
+
+TEST_P(PreparedEdgesTest, MatchesAlgorithmForPolygonsFromFile) {
+    auto points_and_polygons = reader_->ReadPointsAndPolygonsFromFile(polygons_file_path_);
+    ASSERT_FALSE(points_and_polygons.empty());
+    for (size_t i = 0; i < points_and_polygons.size(); ++i) {
+        const auto& [x, y, polygon] = points_and_polygons[i];
+        PreparedEdges edges(polygon, GetParam(), tolerance_);
+        EXPECT_EQ(algorithm_->CalculateWindingNumber2D(x, y, polygon), edges.CalculateWindingNumber2D(x, y))
+                << "for record " << i;
+    }
+}
+
+TEST_P(PreparedEdgesTest, MatchesAlgorithmOnGridAroundSpiral) {
+    Polygon spiral;
+    for (int i = 0; i <= 300; ++i) {
+        float t = i / 100.f;
+        spiral.AppendPoint((1.f + t) * std::cos(6.2831853f * t), (1.f + t) * std::sin(6.2831853f * t));
+    }
+    spiral.ClosePolygon();
+    PreparedEdges edges(spiral, GetParam(), tolerance_);
+
+    poly::PointBatch batch;
+    for (float y = -4.63f; y < 4.7f; y += 0.37f) {
+        for (float x = -4.71f; x < 4.7f; x += 0.29f) {
+            batch.AppendPoint(x, y);
+        }
+    }
+    auto winding_numbers = edges.CalculateWindingNumbers2D(batch);
+    ASSERT_EQ(batch.size(), winding_numbers.size());
+    for (size_t i = 0; i < batch.size(); ++i) {
+        EXPECT_EQ(algorithm_->CalculateWindingNumber2D(batch.x_vec_[i], batch.y_vec_[i], spiral), winding_numbers[i])
+                << "at " << batch.x_vec_[i] << ", " << batch.y_vec_[i];
+    }
+}
+
+TEST_P(PreparedEdgesTest, CountsBoundaryPointsAsInside) {
+    Polygon p;
+    p.AppendPoint(0.0, 0.0);
+    p.AppendPoint(2.0, 0.0);
+    p.AppendPoint(1.0, 1.0);
+    p.AppendPoint(0.0, 0.0);
+    PreparedEdges edges(p, GetParam());
+    EXPECT_EQ(GetParam(), edges.form());
+    EXPECT_EQ(1, edges.CalculateWindingNumber2D(1.0, 0.5));
+    EXPECT_EQ(1, edges.CalculateWindingNumber2D(1.0, 0.0));
+    EXPECT_EQ(1, edges.CalculateWindingNumber2D(1.0, 1.0));
+    EXPECT_EQ(1, edges.CalculateWindingNumber2D(0.5, 0.5));
+    EXPECT_EQ(1, edges.CalculateWindingNumber2D(0.0, 0.0));
+    EXPECT_EQ(0, edges.CalculateWindingNumber2D(2.0, 1.0));
+}
+
+TEST_P(PreparedEdgesTest, FailsWithUnclosedPolygon) {
+    Polygon p;
+    p.AppendPoint(0.0, 0.0);
+    p.AppendPoint(1.0, 0.0);
+    p.AppendPoint(1.0, 1.0);
+    PreparedEdges edges(p, GetParam());
+    EXPECT_FALSE(edges.CalculateWindingNumber2D(0.5, 0.25));
+}
+
+INSTANTIATE_TEST_CASE_P(EdgeForms, PreparedEdgesTest, ::testing::Values(EdgeForm::kSlope, EdgeForm::kLine));
+
+TEST(PreparedEdgesLineTest, MatchesAlgorithmOnTheBoundary) {
+    // The line form promises the boundary results of edge_crossing.hpp, so it is checked on vertices and on edge
+    // midpoints that are exactly representable. Coordinates of mixed magnitudes are where a * x + b * y + c used to
+    // round away from 0 and miss them.
+    auto algorithm = IWindingNumberAlgorithm::Create();
+    std::mt19937 random(29);
+    std::uniform_real_distribution<float> mantissa(-1.f, 1.f);
+    for (int round = 0; round < 1000; ++round) {
+        Polygon p;
+        for (int i = 0; i < 3 + round % 10; ++i) {
+            const float x = std::ldexp(mantissa(random), random() % 10);
+            p.AppendPoint(x, std::ldexp(mantissa(random), -int(random() % 10)));
+        }
+        p.ClosePolygon();
+        PreparedEdges edges(p, EdgeForm::kLine);
+        poly::PointBatch boundary;
+        for (size_t i = 0; i + 1 < p.size(); ++i) {
+            boundary.AppendPoint(p.x_vec_[i], p.y_vec_[i]);
+            const double x = (double(p.x_vec_[i]) + p.x_vec_[i + 1]) / 2;
+            const double y = (double(p.y_vec_[i]) + p.y_vec_[i + 1]) / 2;
+            if (float(x) == x && float(y) == y) {
+                boundary.AppendPoint(float(x), float(y));
+            }
+        }
+        for (size_t i = 0; i < boundary.size(); ++i) {
+            const float x = boundary.x_vec_[i], y = boundary.y_vec_[i];
+            ASSERT_EQ(algorithm->CalculateWindingNumber2D(x, y, p), edges.CalculateWindingNumber2D(x, y))
+                    << "round " << round << " at " << x << ", " << y;
+        }
+    }
+}
+
+TEST(PreparedEdgesMemoryTest, SlopeFormIsSmallerThanLineForm) {
+    Polygon p;
+    for (int i = 0; i < 64; ++i) {
+        p.AppendPoint(std::cos(i / 10.f), std::sin(i / 10.f));
+    }
+    p.ClosePolygon();
+    EXPECT_LT(PreparedEdges(p, EdgeForm::kSlope).memory_bytes(), PreparedEdges(p, EdgeForm::kLine).memory_bytes());
+
+    // None of the 64 edges is horizontal, so each costs exactly what EdgeForm says.
+    EXPECT_EQ(64u * 17, PreparedEdges(p, EdgeForm::kSlope).memory_bytes());
+    EXPECT_EQ(64u * 29, PreparedEdges(p, EdgeForm::kLine).memory_bytes());
+}
+
+}  // namespace winding_number
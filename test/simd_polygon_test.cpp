@@ -0,0 +1,88 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstdint>
+#include <optional>
+#include <tuple>
+
+#include <engine_test.hpp>
+#include <simd_polygon.hpp>
+#include <poly_io.hpp>
+#include <winding.hpp>
+
+namespace winding_number {
+
+using poly::Polygon;
+using poly::SimdPolygon;
+
+using SimdPolygonTest = EngineTest<>;
+
+TEST_F(SimdPolygonTest, PadsToFullLanesWithImplicitClosingEdge) {
+    Polygon p;
+    p.AppendPoint(0.0, 0.0);
+    p.AppendPoint(1.0, 0.0);
+    p.AppendPoint(1.0, 1.0);
+    p.AppendPoint(0.0, 1.0);
+    p.AppendPoint(0.0, 0.0);
+    SimdPolygon simd(p);
+    EXPECT_TRUE(simd.closed());
+    EXPECT_EQ(4u, simd.edge_count());
+    EXPECT_EQ(SimdPolygon::kLaneCount, simd.padded_edge_count());
+    EXPECT_EQ(0u, reinterpret_cast<std::uintptr_t>(simd.x_vec_.data()) % poly::kSimdAlignment);
+    EXPECT_EQ(0u, reinterpret_cast<std::uintptr_t>(simd.y_vec_.data()) % poly::kSimdAlignment);
+    for (size_t i = simd.edge_count(); i <= simd.padded_edge_count(); ++i) {
+        EXPECT_EQ(0.f, simd.x_vec_[i]);
+        EXPECT_EQ(0.f, simd.y_vec_[i]);
+    }
+    EXPECT_EQ(1, CalculateWindingNumber2D(0.5f, 0.5f, simd));
+    EXPECT_EQ(0, CalculateWindingNumber2D(1.5f, 0.5f, simd));
+    EXPECT_EQ(1, CalculateWindingNumber2D(0.5f, 0.f, simd));
+}
+
+TEST_F(SimdPolygonTest, FailsWithUnclosedPolygon) {
+    Polygon p;
+    p.AppendPoint(0.0, 0.0);
+    p.AppendPoint(1.0, 0.0);
+    p.AppendPoint(1.0, 1.0);
+    SimdPolygon simd(p);
+    EXPECT_FALSE(simd.closed());
+    EXPECT_FALSE(CalculateWindingNumber2D(0.5f, 0.25f, simd));
+}
+
+TEST_F(SimdPolygonTest, MatchesAlgorithmForPolygonsFromFile) {
+    auto points_and_polygons = reader_->ReadPointsAndPolygonsFromFile(polygons_file_path_);
+    ASSERT_FALSE(points_and_polygons.empty());
+    for (size_t i = 0; i < points_and_polygons.size(); ++i) {
+        const auto& [x, y, polygon] = points_and_polygons[i];
+        SimdPolygon simd(polygon, tolerance_);
+        EXPECT_EQ(algorithm_->CalculateWindingNumber2D(x, y, polygon), CalculateWindingNumber2D(x, y, simd))
+                << "for record " << i;
+    }
+}
+
+TEST_F(SimdPolygonTest, MatchesAlgorithmForBatchAroundStar) {
+    // A five-pointed star drawn in one stroke, so its core winds twice.
+    Polygon star;
+    for (int i = 0; i <= 5; ++i) {
+        float angle = 2.f * 6.2831853f * i / 5.f;
+        star.AppendPoint(3.f * std::cos(angle), 3.f * std::sin(angle));
+    }
+    star.ClosePolygon();
+    SimdPolygon simd(star, tolerance_);
+
+    poly::PointBatch batch;
+    for (float y = -3.13f; y < 3.2f; y += 0.21f) {
+        for (float x = -3.07f; x < 3.2f; x += 0.19f) {
+            batch.AppendPoint(x, y);
+        }
+    }
+    auto winding_numbers = CalculateWindingNumbers2D(batch, simd);
+    ASSERT_EQ(batch.size(), winding_numbers.size());
+    EXPECT_EQ(2, CalculateWindingNumber2D(0.01f, 0.02f, simd));
+    for (size_t i = 0; i < batch.size(); ++i) {
+        EXPECT_EQ(algorithm_->CalculateWindingNumber2D(batch.x_vec_[i], batch.y_vec_[i], star), winding_numbers[i])
+                << "at " << batch.x_vec_[i] << ", " << batch.y_vec_[i];
+    }
+}
+
+}  // namespace winding_number
@@ -0,0 +1,168 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <optional>
+#include <random>
+
+#include <engine_test.hpp>
+#include <exact_predicates.hpp>
+#include <poly_io.hpp>
+#include <simple_polygon.hpp>
+#include <winding.hpp>
+
+namespace winding_number {
+
+using poly::Polygon;
+
+class SimplePolygonTest : public EngineTest<> {
+protected:
+    // Checks every pair of edges of a closed polygon without repeated consecutive vertices: consecutive edges may only
+    // share their vertex, the others nothing at all.
+    static bool BruteForceSimple(const Polygon& polygon) {
+        const size_t n = polygon.size() - 1;
+        const auto& xs = polygon.x_vec_;
+        const auto& ys = polygon.y_vec_;
+        auto on_segment = [&](size_t i, float x, float y) {
+            return ExactEdgeSide(xs[i], ys[i], xs[i + 1], ys[i + 1], x, y) == 0 &&
+                   std::min(xs[i], xs[i + 1]) <= x && x <= std::max(xs[i], xs[i + 1]) &&
+                   std::min(ys[i], ys[i + 1]) <= y && y <= std::max(ys[i], ys[i + 1]);
+        };
+        for (size_t i = 0; i < n; ++i) {
+            for (size_t j = i + 1; j < n; ++j) {
+                if (j == i + 1 || (i == 0 && j == n - 1)) {
+                    // The far end of either edge lying on the other one means they overlap.
+                    const size_t far_i = j == i + 1 ? i : i + 1;
+                    const size_t far_j = j == i + 1 ? j + 1 : j;
+                    if (on_segment(i, xs[far_j], ys[far_j]) || on_segment(j, xs[far_i], ys[far_i])) {
+                        return false;
+                    }
+                    continue;
+                }
+                const int a = ExactEdgeSide(xs[i], ys[i], xs[i + 1], ys[i + 1], xs[j], ys[j]);
+                const int b = ExactEdgeSide(xs[i], ys[i], xs[i + 1], ys[i + 1], xs[j + 1], ys[j + 1]);
+                const int c = ExactEdgeSide(xs[j], ys[j], xs[j + 1], ys[j + 1], xs[i], ys[i]);
+                const int d = ExactEdgeSide(xs[j], ys[j], xs[j + 1], ys[j + 1], xs[i + 1], ys[i + 1]);
+                if ((a * b < 0 && c * d < 0) || on_segment(i, xs[j], ys[j]) || on_segment(i, xs[j + 1], ys[j + 1]) ||
+                    on_segment(j, xs[i], ys[i]) || on_segment(j, xs[i + 1], ys[i + 1])) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    // Compares against the scalar algorithm on a grid that hits the vertices, the sides and the lines through them.
+    void ExpectMatchesScalarOnGrid(const Polygon& polygon, float low, float high, float step) {
+        SimplePolygon simple(polygon);
+        for (float y = low; y <= high; y += step) {
+            for (float x = low; x <= high; x += step) {
+                EXPECT_EQ(scalar_->CalculateWindingNumber2D(x, y, polygon), simple.CalculateWindingNumber2D(x, y))
+                        << "at " << x << ", " << y;
+            }
+        }
+    }
+};
+
+TEST_F(SimplePolygonTest, MatchesScalarForPolygonsFromFile) {
+    auto points_and_polygons = reader_->ReadPointsAndPolygonsFromFile(polygons_file_path_);
+    ASSERT_FALSE(points_and_polygons.empty());
+    for (size_t i = 0; i < points_and_polygons.size(); ++i) {
+        const auto& [x, y, polygon] = points_and_polygons[i];
+        SimplePolygon simple(polygon, tolerance_);
+        EXPECT_EQ(scalar_->CalculateWindingNumber2D(x, y, polygon), simple.CalculateWindingNumber2D(x, y))
+                << "for record " << i;
+    }
+}
+
+TEST_F(SimplePolygonTest, DetectsSimplicityAndOrientation) {
+    Polygon square = MakePolygon({{0, 0}, {1, 0}, {1, 1}, {0, 1}});
+    EXPECT_TRUE(SimplePolygon(square).simple());
+    EXPECT_EQ(1, SimplePolygon(square).orientation());
+
+    Polygon clockwise = MakePolygon({{0, 0}, {0, 1}, {1, 1}, {1, 0}});
+    EXPECT_EQ(-1, SimplePolygon(clockwise).orientation());
+
+    Polygon comb = MakePolygon({{0, 0}, {5, 0}, {5, 3}, {4, 3}, {4, 1}, {3, 1}, {3, 3}, {2, 3}, {2, 1}, {1, 1},
+                                {1, 3}, {0, 3}});
+    EXPECT_TRUE(SimplePolygon(comb).simple());
+
+    // Repeated vertices and vertices along a side are fine.
+    Polygon padded = MakePolygon({{0, 0}, {0, 0}, {1, 0}, {2, 0}, {2, 2}, {2, 2}, {0, 2}});
+    EXPECT_TRUE(SimplePolygon(padded).simple());
+
+    Polygon bowtie = MakePolygon({{0, 0}, {1, 1}, {1, 0}, {0, 1}});
+    EXPECT_FALSE(SimplePolygon(bowtie).simple());
+    EXPECT_EQ(0, SimplePolygon(bowtie).orientation());
+
+    // A vertex touching another edge, two vertices touching, and a spike doubling back along a side.
+    Polygon touching_edge = MakePolygon({{0, 0}, {4, 0}, {4, 4}, {2, 0}, {0, 4}});
+    EXPECT_FALSE(SimplePolygon(touching_edge).simple());
+    Polygon touching_vertex = MakePolygon({{0, 0}, {2, 0}, {1, 1}, {2, 2}, {0, 2}, {1, 1}});
+    EXPECT_FALSE(SimplePolygon(touching_vertex).simple());
+    Polygon spike = MakePolygon({{0, 0}, {2, 0}, {3, 0}, {2, 0}, {2, 2}, {0, 2}});
+    EXPECT_FALSE(SimplePolygon(spike).simple());
+    Polygon vertical_spike = MakePolygon({{0, 0}, {2, 0}, {2, 2}, {1, 2}, {1, 4}, {1, 1}, {0, 2}});
+    EXPECT_FALSE(SimplePolygon(vertical_spike).simple());
+
+    Polygon flat = MakePolygon({{0, 0}, {1, 0}, {2, 0}});
+    EXPECT_FALSE(SimplePolygon(flat).simple());
+}
+
+TEST_F(SimplePolygonTest, MatchesScalarAroundSimpleAndSelfIntersectingPolygons) {
+    ExpectMatchesScalarOnGrid(MakePolygon({{0, 0}, {5, 0}, {5, 3}, {4, 3}, {4, 1}, {3, 1}, {3, 3}, {2, 3}, {2, 1},
+                                           {1, 1}, {1, 3}, {0, 3}}),
+                              -0.5f, 5.5f, 0.25f);
+    ExpectMatchesScalarOnGrid(MakePolygon({{0, 0}, {0, 3}, {1, 1}, {2, 3}, {3, 0}}), -0.5f, 3.5f, 0.25f);
+    ExpectMatchesScalarOnGrid(MakePolygon({{0, 0}, {1, 1}, {1, 0}, {0, 1}}), -0.5f, 1.5f, 0.125f);
+    ExpectMatchesScalarOnGrid(MakePolygon({{0, 0}, {2, 0}, {1, 1}, {2, 2}, {0, 2}, {1, 1}}), -0.5f, 2.5f, 0.25f);
+}
+
+TEST_F(SimplePolygonTest, AgreesWithBruteForceOnRandomGridPolygons) {
+    // Small integer coordinates make collinear edges, shared vertices and touching edges common.
+    std::mt19937 random(38);
+    std::uniform_int_distribution<int> coordinate(0, 4);
+    std::uniform_int_distribution<int> size(3, 8);
+    int simple_count = 0;
+    for (int round = 0; round < 2000; ++round) {
+        Polygon polygon;
+        const int n = size(random);
+        for (int i = 0; i < n; ++i) {
+            const float x = coordinate(random), y = coordinate(random);
+            if (polygon.size() == 0 || x != polygon.x_vec_.back() || y != polygon.y_vec_.back()) {
+                polygon.AppendPoint(x, y);
+            }
+        }
+        while (polygon.size() > 1 && polygon.x_vec_.back() == polygon.x_vec_.front() &&
+               polygon.y_vec_.back() == polygon.y_vec_.front()) {
+            polygon.x_vec_.pop_back();
+            polygon.y_vec_.pop_back();
+        }
+        if (polygon.size() < 3) {
+            continue;
+        }
+        polygon.ClosePolygon();
+
+        SimplePolygon simple(polygon);
+        ASSERT_EQ(BruteForceSimple(polygon), simple.simple()) << "for round " << round;
+        simple_count += simple.simple();
+        for (float y = -0.5f; y <= 4.5f; y += 0.5f) {
+            for (float x = -0.5f; x <= 4.5f; x += 0.5f) {
+                ASSERT_EQ(scalar_->CalculateWindingNumber2D(x, y, polygon), simple.CalculateWindingNumber2D(x, y))
+                        << "for round " << round << " at " << x << ", " << y;
+            }
+        }
+    }
+    EXPECT_GT(simple_count, 100);
+}
+
+TEST_F(SimplePolygonTest, FailsWithUnclosedPolygon) {
+    Polygon p;
+    p.AppendPoint(0.0, 0.0);
+    p.AppendPoint(1.0, 0.0);
+    p.AppendPoint(1.0, 1.0);
+    SimplePolygon simple(p);
+    EXPECT_FALSE(simple.CalculateWindingNumber2D(0.5, 0.5));
+    EXPECT_FALSE(SimplePolygon(Polygon()).CalculateWindingNumber2D(0.5, 0.5));
+}
+
+}  // namespace winding_number
@@ -0,0 +1,114 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <optional>
+#include <random>
+
+#include <engine_test.hpp>
+#include <poly_io.hpp>
+#include <small_polygon.hpp>
+#include <winding.hpp>
+
+namespace winding_number {
+
+using poly::Polygon;
+using Shape = SmallPolygon::Shape;
+
+constexpr double kPi = 3.14159265358979323846;
+
+class SmallPolygonTest : public EngineTest<> {
+protected:
+    // Compares against the scalar algorithm on a grid that hits the vertices, the sides and the lines through them.
+    void ExpectMatchesScalarOnGrid(const Polygon& polygon, float low, float high, float step) {
+        SmallPolygon small(polygon);
+        for (float y = low; y <= high; y += step) {
+            for (float x = low; x <= high; x += step) {
+                EXPECT_EQ(scalar_->CalculateWindingNumber2D(x, y, polygon), small.CalculateWindingNumber2D(x, y))
+                        << "at " << x << ", " << y;
+            }
+        }
+    }
+};
+
+TEST_F(SmallPolygonTest, MatchesScalarForPolygonsFromFile) {
+    auto points_and_polygons = reader_->ReadPointsAndPolygonsFromFile(polygons_file_path_);
+    ASSERT_FALSE(points_and_polygons.empty());
+    for (size_t i = 0; i < points_and_polygons.size(); ++i) {
+        const auto& [x, y, polygon] = points_and_polygons[i];
+        SmallPolygon small(polygon, tolerance_);
+        EXPECT_EQ(scalar_->CalculateWindingNumber2D(x, y, polygon), small.CalculateWindingNumber2D(x, y))
+                << "for record " << i;
+    }
+}
+
+TEST_F(SmallPolygonTest, PicksKernelFromShapeAndSize) {
+    EXPECT_EQ(Shape::kRectangle, SmallPolygon(MakePolygon({{0, 0}, {1, 0}, {1, 1}, {0, 1}})).shape());
+    EXPECT_EQ(Shape::kRectangle, SmallPolygon(MakePolygon({{0, 0}, {0, 1}, {1, 1}, {1, 0}})).shape());
+    EXPECT_EQ(Shape::kRectangle, SmallPolygon(MakePolygon({{2, 1}, {2, 3}, {-1, 3}, {-1, 1}})).shape());
+
+    // Four edges that are not a rectangle: a slanted square, a repeated vertex, and a flat trace that folds back.
+    EXPECT_EQ(Shape::kUnrolled, SmallPolygon(MakePolygon({{1, 0}, {2, 1}, {1, 2}, {0, 1}})).shape());
+    EXPECT_EQ(Shape::kUnrolled, SmallPolygon(MakePolygon({{0, 0}, {1, 0}, {1, 0}, {0, 1}})).shape());
+    EXPECT_EQ(Shape::kUnrolled, SmallPolygon(MakePolygon({{0, 0}, {1, 0}, {0, 0}, {1, 0}})).shape());
+
+    SmallPolygon triangle(MakePolygon({{0, 0}, {1, 0}, {0, 1}}));
+    EXPECT_EQ(Shape::kUnrolled, triangle.shape());
+    EXPECT_EQ(3u, triangle.edge_count());
+
+    Polygon octagon, nonagon;
+    for (int i = 0; i < 8; ++i) {
+        octagon.AppendPoint(std::cos(2 * kPi * i / 8), std::sin(2 * kPi * i / 8));
+    }
+    octagon.ClosePolygon();
+    EXPECT_EQ(Shape::kUnrolled, SmallPolygon(octagon).shape());
+    for (int i = 0; i < 9; ++i) {
+        nonagon.AppendPoint(std::cos(2 * kPi * i / 9), std::sin(2 * kPi * i / 9));
+    }
+    nonagon.ClosePolygon();
+    EXPECT_EQ(Shape::kGeneral, SmallPolygon(nonagon).shape());
+    EXPECT_EQ(9u, SmallPolygon(nonagon).edge_count());
+
+    // Closed only up to tolerance: still four edges, as every engine sees them, but not an exact rectangle.
+    Polygon almost_closed = MakePolygon({{0, 0}, {1, 0}, {1, 1}, {0, 1}});
+    almost_closed.x_vec_.back() = 1e-7f;
+    SmallPolygon gap(almost_closed, tolerance_);
+    EXPECT_EQ(Shape::kUnrolled, gap.shape());
+    EXPECT_EQ(4u, gap.edge_count());
+}
+
+TEST_F(SmallPolygonTest, MatchesScalarAroundRectangles) {
+    ExpectMatchesScalarOnGrid(MakePolygon({{0, 0}, {1, 0}, {1, 1}, {0, 1}}), -0.5f, 1.5f, 0.125f);
+    ExpectMatchesScalarOnGrid(MakePolygon({{0, 0}, {0, 1}, {1, 1}, {1, 0}}), -0.5f, 1.5f, 0.125f);
+    ExpectMatchesScalarOnGrid(MakePolygon({{1, 1}, {1, 0.5}, {0.25, 0.5}, {0.25, 1}}), -0.5f, 1.5f, 0.125f);
+}
+
+TEST_F(SmallPolygonTest, MatchesScalarForEveryUnrolledSize) {
+    // Small integer coordinates make vertices and edges land on grid points, and many of the polygons cross
+    // themselves.
+    std::mt19937 random(39);
+    std::uniform_int_distribution<int> coordinate(0, 4);
+    for (size_t points = 1; points <= SmallPolygon::kMaxEdges + 2; ++points) {
+        for (int round = 0; round < 20; ++round) {
+            Polygon polygon;
+            for (size_t i = 0; i < points; ++i) {
+                polygon.AppendPoint(coordinate(random), coordinate(random));
+            }
+            polygon.ClosePolygon();
+            ExpectMatchesScalarOnGrid(polygon, -0.5f, 4.5f, 0.5f);
+        }
+    }
+}
+
+TEST_F(SmallPolygonTest, FailsWithUnclosedPolygon) {
+    Polygon p;
+    p.AppendPoint(0.0, 0.0);
+    p.AppendPoint(1.0, 0.0);
+    p.AppendPoint(1.0, 1.0);
+    SmallPolygon small(p);
+    EXPECT_FALSE(small.CalculateWindingNumber2D(0.5, 0.5));
+    EXPECT_EQ(std::vector<std::optional<int>>(2), small.CalculateWindingNumbers2D(poly::PointBatch::FromPoints(
+                                                           {{0.5f, 0.5f}, {2.f, 2.f}})));
+    EXPECT_FALSE(SmallPolygon(Polygon()).CalculateWindingNumber2D(0.5, 0.5));
+}
+
+}  // namespace winding_number
@@ -0,0 +1,94 @@
+#include <gtest/gtest.h>
+
+#include <utility>
+#include <vector>
+
+#include <small_vector.hpp>
+
+namespace poly {
+
+using Vector = SmallVector<int, 4>;
+
+class SmallVectorTest : public ::testing::Test {
+protected:
+    static Vector Iota(int count) {
+        Vector v;
+        for (int i = 0; i < count; ++i) {
+            v.push_back(i);
+        }
+        return v;
+    }
+
+    static std::vector<int> Elements(const Vector& v) {
+        return std::vector<int>(v.begin(), v.end());
+    }
+};
+
+TEST_F(SmallVectorTest, SpillsToTheHeapOnlyWhenFull) {
+    Vector v = Iota(4);
+    EXPECT_TRUE(v.is_inline());
+    EXPECT_EQ(4u, v.capacity());
+    v.push_back(4);
+    EXPECT_FALSE(v.is_inline());
+    EXPECT_EQ((std::vector<int>{0, 1, 2, 3, 4}), Elements(v));
+
+    v.resize(2);
+    v.shrink_to_fit();
+    EXPECT_TRUE(v.is_inline());
+    EXPECT_EQ((std::vector<int>{0, 1}), Elements(v));
+
+    Vector reserved;
+    reserved.reserve(4);
+    EXPECT_TRUE(reserved.is_inline());
+    reserved.reserve(5);
+    EXPECT_FALSE(reserved.is_inline());
+}
+
+TEST_F(SmallVectorTest, CopiesAndMovesInlineAndHeapStorage) {
+    for (int count : {3, 9}) {
+        const Vector original = Iota(count);
+        Vector copy = original;
+        EXPECT_EQ(original, copy);
+        EXPECT_NE(original.data(), copy.data());
+
+        Vector moved = std::move(copy);
+        EXPECT_EQ(original, moved);
+        EXPECT_TRUE(copy.empty());
+        EXPECT_TRUE(copy.is_inline());
+
+        Vector assigned = Iota(7);
+        assigned = std::move(moved);
+        EXPECT_EQ(original, assigned);
+        assigned = Iota(2);
+        EXPECT_EQ(Iota(2), assigned);
+        EXPECT_NE(original, assigned);
+    }
+}
+
+TEST_F(SmallVectorTest, InsertsAndErasesLikeStdVector) {
+    Vector v = Iota(3);
+    v.insert(v.begin() + 1, 10);
+    EXPECT_EQ((std::vector<int>{0, 10, 1, 2}), Elements(v));
+
+    const std::vector<int> more{20, 21, 22};
+    v.insert(v.end(), more.begin(), more.end());
+    EXPECT_EQ((std::vector<int>{0, 10, 1, 2, 20, 21, 22}), Elements(v));
+
+    // Pushing an element of the vector itself while it grows.
+    Vector full = Iota(4);
+    full.push_back(full[1]);
+    EXPECT_EQ((std::vector<int>{0, 1, 2, 3, 1}), Elements(full));
+
+    v.erase(v.begin() + 1, v.begin() + 4);
+    EXPECT_EQ((std::vector<int>{0, 20, 21, 22}), Elements(v));
+    v.erase(v.begin());
+    v.pop_back();
+    EXPECT_EQ((std::vector<int>{20, 21}), Elements(v));
+    EXPECT_EQ(20, v.front());
+    EXPECT_EQ(21, v.back());
+
+    EXPECT_EQ((std::vector<int>{7, 7, 7, 7, 7, 7}), Elements(Vector(6, 7)));
+    EXPECT_EQ((std::vector<int>{1, 2, 3}), Elements(Vector{1, 2, 3}));
+}
+
+}  // namespace poly
@@ -0,0 +1,153 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <optional>
+#include <random>
+#include <utility>
+
+#include <point_batch.hpp>
+#include <poly_io.hpp>
+#include <spherical_polygon.hpp>
+#include <winding.hpp>
+
+namespace winding_number {
+
+using poly::Polygon;
+using poly::SphericalPolygon;
+
+constexpr double kPi = 3.14159265358979323846;
+
+class SphericalPolygonTest : public ::testing::Test {
+protected:
+    SphericalPolygonTest() : scalar_(IWindingNumberAlgorithm::Create("scalar")) {}
+
+    static SphericalPolygon MakeLonLat(std::initializer_list<std::pair<double, double>> points) {
+        SphericalPolygon polygon;
+        for (const auto& [lon, lat] : points) {
+            polygon.AppendLonLat(lon, lat);
+        }
+        polygon.ClosePolygon();
+        return polygon;
+    }
+
+    std::unique_ptr<IWindingNumberAlgorithm> scalar_;
+};
+
+TEST_F(SphericalPolygonTest, SmallPolygonsMatchPlanar) {
+    // Over a fraction of a degree, great circle arcs are within 1e-4 degrees of straight lines in lon/lat, so away
+    // from the boundary the planar winding numbers hold.
+    std::mt19937 random(46);
+    std::uniform_int_distribution<int> coordinate(0, 4);
+    for (int round = 0; round < 40; ++round) {
+        Polygon lon_lat;
+        for (int i = 0; i < 3 + round % 8; ++i) {
+            lon_lat.AppendPoint(-73.f + 0.1f * coordinate(random), 40.f + 0.1f * coordinate(random));
+        }
+        lon_lat.ClosePolygon();
+        const PreparedSphericalPolygon prepared(SphericalPolygon::FromLonLat(lon_lat));
+        EXPECT_TRUE(prepared.fits_in_hemisphere());
+        for (float lat = 39.925f; lat <= 40.5f; lat += 0.05f) {
+            for (float lon = -73.075f; lon <= -72.5f; lon += 0.05f) {
+                const auto expected = scalar_->CalculateWindingNumber2D(lon, lat, lon_lat);
+                bool near_boundary = false;
+                for (float d_lon : {-1e-3f, 1e-3f}) {
+                    for (float d_lat : {-1e-3f, 1e-3f}) {
+                        const auto nearby = scalar_->CalculateWindingNumber2D(lon + d_lon, lat + d_lat, lon_lat);
+                        near_boundary |= nearby != expected;
+                    }
+                }
+                if (!near_boundary) {
+                    EXPECT_EQ(expected, prepared.CalculateWindingNumberLonLat(lon, lat)) << "at " << lon << ", " << lat;
+                }
+            }
+        }
+    }
+}
+
+TEST_F(SphericalPolygonTest, CrossesTheAntimeridian) {
+    const PreparedSphericalPolygon prepared(MakeLonLat({{170, -10}, {-170, -10}, {190, 10}, {170, 10}}));
+    EXPECT_EQ(std::optional<int>(1), prepared.CalculateWindingNumberLonLat(180, 0));
+    EXPECT_EQ(std::optional<int>(1), prepared.CalculateWindingNumberLonLat(-180, 0));
+    EXPECT_EQ(std::optional<int>(1), prepared.CalculateWindingNumberLonLat(-175, 5));
+    EXPECT_EQ(std::optional<int>(1), prepared.CalculateWindingNumberLonLat(535, -5));
+    EXPECT_EQ(std::optional<int>(0), prepared.CalculateWindingNumberLonLat(169, 0));
+    EXPECT_EQ(std::optional<int>(0), prepared.CalculateWindingNumberLonLat(-169, 0));
+    EXPECT_EQ(std::optional<int>(0), prepared.CalculateWindingNumberLonLat(0, 0));
+
+    // 180 and -180 are the same point exactly, so the polygon is closed without a tolerance.
+    SphericalPolygon wrapped = MakeLonLat({{180, 5}, {190, 5}, {190, 15}});
+    wrapped.AppendLonLat(-180, 5);
+    EXPECT_TRUE(wrapped.IsClosed());
+}
+
+TEST_F(SphericalPolygonTest, CoversThePoles) {
+    // Counter-clockwise seen from above the north pole.
+    const auto around_pole = MakeLonLat({{0, 80}, {90, 80}, {180, 80}, {270, 80}});
+    const PreparedSphericalPolygon prepared(around_pole);
+    EXPECT_TRUE(prepared.fits_in_hemisphere());
+    EXPECT_EQ(std::optional<int>(1), prepared.CalculateWindingNumberLonLat(0, 90));
+    EXPECT_EQ(std::optional<int>(1), prepared.CalculateWindingNumberLonLat(123, 90));
+    EXPECT_EQ(std::optional<int>(1), prepared.CalculateWindingNumberLonLat(45, 85));
+    EXPECT_EQ(std::optional<int>(1), prepared.CalculateWindingNumberOnSphere(0, 0, 2));
+    EXPECT_EQ(std::optional<int>(0), prepared.CalculateWindingNumberLonLat(45, 70));
+    EXPECT_EQ(std::optional<int>(0), prepared.CalculateWindingNumberLonLat(0, -90));
+    // The edges are great circle arcs, which bulge towards the pole: halfway between two points at latitude 80 they
+    // reach latitude 82.9.
+    EXPECT_EQ(std::optional<int>(0), prepared.CalculateWindingNumberLonLat(45, 82.8));
+    EXPECT_EQ(std::optional<int>(1), prepared.CalculateWindingNumberLonLat(45, 83));
+
+    const auto clockwise = MakeLonLat({{0, 80}, {270, 80}, {180, 80}, {90, 80}});
+    EXPECT_EQ(std::optional<int>(-1), PreparedSphericalPolygon(clockwise).CalculateWindingNumberLonLat(0, 90));
+}
+
+TEST_F(SphericalPolygonTest, CountsAroundTheAxisBeyondAHemisphere) {
+    // The equator, counter-clockwise seen from the north: it winds once around the north pole and once the other way
+    // around the south pole.
+    const PreparedSphericalPolygon equator(MakeLonLat({{0, 0}, {120, 0}, {240, 0}}));
+    EXPECT_FALSE(equator.fits_in_hemisphere());
+    EXPECT_EQ(std::optional<int>(1), equator.CalculateWindingNumberLonLat(10, 45));
+    EXPECT_EQ(std::optional<int>(-1), equator.CalculateWindingNumberLonLat(10, -45));
+}
+
+TEST_F(SphericalPolygonTest, BatchMatchesSinglePoints) {
+    SphericalPolygon polygon;
+    // A star of 101 points around lon 30, lat -60, enough edges for the vector loop and its tail.
+    for (int i = 0; i < 101; ++i) {
+        const double angle = 2 * kPi * i / 101, radius = i % 2 ? 2 : 5;
+        polygon.AppendLonLat(30 + 2 * radius * std::cos(angle), -60 + radius * std::sin(angle));
+    }
+    polygon.ClosePolygon();
+    const PreparedSphericalPolygon prepared(polygon);
+    std::mt19937 random(460);
+    std::uniform_real_distribution<float> lon(10, 50), lat(-70, -50);
+    poly::PointBatch points;
+    for (int i = 0; i < 2000; ++i) {
+        points.AppendPoint(lon(random), lat(random));
+    }
+    const auto winding_numbers = prepared.CalculateWindingNumbersLonLat(points);
+    ASSERT_EQ(points.size(), winding_numbers.size());
+    size_t inside = 0;
+    for (size_t i = 0; i < points.size(); ++i) {
+        EXPECT_EQ(prepared.CalculateWindingNumberLonLat(points.x_vec_[i], points.y_vec_[i]), winding_numbers[i]);
+        inside += winding_numbers[i] == 1;
+    }
+    EXPECT_GT(inside, 100u);
+    EXPECT_EQ(std::optional<int>(1), prepared.CalculateWindingNumberLonLat(30, -60));
+}
+
+TEST_F(SphericalPolygonTest, FailsWithUnclosedPolygon) {
+    SphericalPolygon polygon;
+    polygon.AppendLonLat(0, 0);
+    polygon.AppendLonLat(1, 0);
+    polygon.AppendLonLat(1, 1);
+    EXPECT_FALSE(polygon.IsClosed());
+    EXPECT_FALSE(PreparedSphericalPolygon(polygon).CalculateWindingNumberLonLat(0.5, 0.25));
+    EXPECT_FALSE(PreparedSphericalPolygon(SphericalPolygon()).CalculateWindingNumberLonLat(0, 0));
+
+    polygon.AppendLonLat(1e-7, 0);
+    EXPECT_FALSE(polygon.IsClosed());
+    EXPECT_TRUE(polygon.IsClosed(1e-8));
+    EXPECT_EQ(std::optional<int>(1), PreparedSphericalPolygon(polygon, 1e-8).CalculateWindingNumberLonLat(0.75, 0.25));
+}
+
+}  // namespace winding_number
@@ -0,0 +1,175 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <optional>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include <exact_predicates.hpp>
+#include <point_batch.hpp>
+#include <poly_io.hpp>
+#include <sweep_line.hpp>
+#include <winding.hpp>
+
+namespace winding_number {
+
+using poly::PointBatch;
+using poly::Polygon;
+
+class SweepLineTest : public ::testing::Test {
+protected:
+    SweepLineTest() : scalar_(IWindingNumberAlgorithm::Create("scalar")) {}
+
+    // A polygon through points on a small integer grid, in order of angle around the middle of the grid, so that its
+    // edges do not cross but it has plenty of shared x and y coordinates, horizontal edges and collinear points.
+    static Polygon MakeStarShaped(std::mt19937& random, int point_count, bool clockwise) {
+        std::uniform_int_distribution<int> coordinate(-8, 8);
+        std::vector<std::pair<int, int>> points;
+        while (points.size() < size_t(point_count)) {
+            const std::pair<int, int> point(coordinate(random), coordinate(random));
+            if ((point.first != 0 || point.second != 0) &&
+                std::find(points.begin(), points.end(), point) == points.end()) {
+                points.push_back(point);
+            }
+        }
+        auto angle = [](const std::pair<int, int>& p) { return std::atan2(double(p.second), double(p.first)); };
+        std::sort(points.begin(), points.end(), [&](const auto& a, const auto& b) {
+            return angle(a) != angle(b) ? angle(a) < angle(b) : std::abs(a.first) + std::abs(a.second) <
+                                                                        std::abs(b.first) + std::abs(b.second);
+        });
+        if (clockwise) {
+            std::reverse(points.begin(), points.end());
+        }
+        Polygon polygon;
+        for (const auto& [x, y] : points) {
+            polygon.AppendPoint(float(x), float(y));
+        }
+        polygon.ClosePolygon();
+        return polygon;
+    }
+
+    // Every point of the grid, and halfway between, over a margin around the polygons.
+    static PointBatch MakeGrid() {
+        PointBatch points;
+        for (float y = -10.f; y <= 10.f; y += 0.5f) {
+            for (float x = -10.f; x <= 10.f; x += 0.5f) {
+                points.AppendPoint(x, y);
+            }
+        }
+        return points;
+    }
+
+    std::unique_ptr<IWindingNumberAlgorithm> scalar_;
+};
+
+TEST_F(SweepLineTest, MatchesScalarOnGridPolygons) {
+    // Grid points land on vertices and edges as well as in between; the coordinates are small integers and halves, so
+    // the scalar engine is exact on them.
+    std::mt19937 random(47);
+    const PointBatch points = MakeGrid();
+    for (int round = 0; round < 60; ++round) {
+        const Polygon polygon = MakeStarShaped(random, 3 + round % 20, round % 2 == 1);
+        const auto winding_numbers = CalculateWindingNumbersBySweep(points, polygon, 0.f, 1 + round % 3);
+        ASSERT_EQ(points.size(), winding_numbers.size());
+        for (size_t i = 0; i < points.size(); ++i) {
+            const float x = points.x_vec_[i], y = points.y_vec_[i];
+            ASSERT_EQ(scalar_->CalculateWindingNumber2D(x, y, polygon), winding_numbers[i])
+                    << "round " << round << " at " << x << ", " << y;
+        }
+    }
+}
+
+TEST_F(SweepLineTest, MatchesExactOffTheBoundary) {
+    // A spiral of 2000 edges with shallow turns, and points with arbitrary float coordinates.
+    Polygon polygon;
+    for (int i = 0; i < 1000; ++i) {
+        const float angle = 0.02f * i, radius = 1.f + 0.001f * i;
+        polygon.AppendPoint(radius * std::cos(angle), radius * std::sin(angle));
+    }
+    for (int i = 999; i >= 0; --i) {
+        const float angle = 0.02f * i, radius = 1.05f + 0.001f * i;
+        polygon.AppendPoint(radius * std::cos(angle), radius * std::sin(angle));
+    }
+    polygon.ClosePolygon();
+    std::mt19937 random(470);
+    std::uniform_real_distribution<float> coordinate(-2.2f, 2.2f);
+    PointBatch points;
+    for (int i = 0; i < 20000; ++i) {
+        points.AppendPoint(coordinate(random), coordinate(random));
+    }
+    const auto winding_numbers = CalculateWindingNumbersBySweep(points, polygon, 0.f, 4);
+    size_t inside = 0;
+    for (size_t i = 0; i < points.size(); ++i) {
+        EXPECT_EQ(ExactWindingNumber2D(points.x_vec_[i], points.y_vec_[i], polygon), winding_numbers[i]);
+        inside += winding_numbers[i] != 0;
+    }
+    EXPECT_GT(inside, 100u);
+}
+
+TEST_F(SweepLineTest, FallsBackWhenEdgesCross) {
+    std::mt19937 random(4700);
+    std::uniform_int_distribution<int> coordinate(-8, 8);
+    const PointBatch points = MakeGrid();
+    for (int round = 0; round < 20; ++round) {
+        Polygon polygon;
+        for (int i = 0; i < 4 + round; ++i) {
+            polygon.AppendPoint(float(coordinate(random)), float(coordinate(random)));
+        }
+        polygon.ClosePolygon();
+        const auto winding_numbers = CalculateWindingNumbersBySweep(points, polygon);
+        for (size_t i = 0; i < points.size(); ++i) {
+            ASSERT_EQ(scalar_->CalculateWindingNumber2D(points.x_vec_[i], points.y_vec_[i], polygon),
+                      winding_numbers[i]);
+        }
+    }
+
+    // A figure of eight winds both ways.
+    Polygon eight;
+    for (auto [x, y] : {std::pair(0.f, 0.f), {2.f, 2.f}, {2.f, 0.f}, {0.f, 2.f}}) {
+        eight.AppendPoint(x, y);
+    }
+    eight.ClosePolygon();
+    PointBatch two_points;
+    two_points.AppendPoint(1.f, 0.5f);
+    two_points.AppendPoint(1.f, 1.5f);
+    const auto winding_numbers = CalculateWindingNumbersBySweep(two_points, eight);
+    EXPECT_EQ(scalar_->CalculateWindingNumber2D(1.f, 0.5f, eight), winding_numbers[0]);
+    EXPECT_EQ(scalar_->CalculateWindingNumber2D(1.f, 1.5f, eight), winding_numbers[1]);
+    EXPECT_EQ(-*winding_numbers[0], *winding_numbers[1]);
+}
+
+TEST_F(SweepLineTest, ResultsDoNotDependOnThreadCount) {
+    std::mt19937 random(47000);
+    const Polygon polygon = MakeStarShaped(random, 40, false);
+    std::uniform_real_distribution<float> coordinate(-9.f, 9.f);
+    PointBatch points;
+    for (int i = 0; i < 5000; ++i) {
+        points.AppendPoint(coordinate(random), coordinate(random));
+    }
+    const auto expected = CalculateWindingNumbersBySweep(points, polygon, 0.f, 1);
+    for (size_t thread_count : {2, 3, 8}) {
+        EXPECT_EQ(expected, CalculateWindingNumbersBySweep(points, polygon, 0.f, thread_count));
+    }
+    EXPECT_TRUE(CalculateWindingNumbersBySweep(PointBatch(), polygon).empty());
+}
+
+TEST_F(SweepLineTest, FailsWithUnclosedPolygon) {
+    Polygon polygon;
+    polygon.AppendPoint(0.f, 0.f);
+    polygon.AppendPoint(1.f, 0.f);
+    polygon.AppendPoint(1.f, 1.f);
+    PointBatch points;
+    points.AppendPoint(0.75f, 0.25f);
+    points.AppendPoint(5.f, 5.f);
+    for (const auto& winding_number : CalculateWindingNumbersBySweep(points, polygon)) {
+        EXPECT_FALSE(winding_number);
+    }
+    EXPECT_FALSE(CalculateWindingNumbersBySweep(points, Polygon())[0]);
+
+    polygon.AppendPoint(1e-4f, 0.f);
+    EXPECT_EQ(std::optional<int>(1), CalculateWindingNumbersBySweep(points, polygon, 1e-3f)[0]);
+}
+
+}  // namespace winding_number
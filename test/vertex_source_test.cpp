@@ -0,0 +1,113 @@
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cmath>
+#include <optional>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include <point_batch.hpp>
+#include <poly_io.hpp>
+#include <vertex_source.hpp>
+#include <winding.hpp>
+
+namespace winding_number {
+
+using poly::Polygon;
+
+constexpr double kPi = 3.14159265358979323846;
+
+class VertexSourceTest : public ::testing::Test {
+protected:
+    VertexSourceTest() : scalar_(IWindingNumberAlgorithm::Create("scalar")) {}
+
+    // A circle of radius 1 around the origin, traced `loops` times, counter-clockwise if loops > 0.
+    static auto Circle(int loops, size_t samples) {
+        return SampledCurve(
+                [](double t) { return std::make_pair(std::cos(t), std::sin(t)); }, 0.0, 2 * kPi * loops, samples);
+    }
+
+    std::unique_ptr<IWindingNumberAlgorithm> scalar_;
+};
+
+TEST_F(VertexSourceTest, RangeMatchesScalar) {
+    std::mt19937 random(43);
+    std::uniform_int_distribution<int> coordinate(0, 4);
+    for (int round = 0; round < 50; ++round) {
+        std::vector<std::pair<float, float>> vertices(1 + round % 12);
+        Polygon polygon;
+        for (auto& [x, y] : vertices) {
+            x = coordinate(random);
+            y = coordinate(random);
+            polygon.AppendPoint(x, y);
+        }
+        vertices.push_back(vertices.front());
+        polygon.ClosePolygon();
+        const VertexRange source(vertices.begin(), vertices.end());
+        for (float y = -0.5f; y <= 4.5f; y += 0.5f) {
+            for (float x = -0.5f; x <= 4.5f; x += 0.5f) {
+                EXPECT_EQ(scalar_->CalculateWindingNumber2D(x, y, polygon),
+                          CalculateWindingNumberFromSource(x, y, source))
+                        << "at " << x << ", " << y;
+            }
+        }
+    }
+}
+
+TEST_F(VertexSourceTest, SamplesParametricCurves) {
+    EXPECT_EQ(std::optional<int>(1), CalculateWindingNumberFromSource(0.f, 0.f, Circle(1, 64)));
+    EXPECT_EQ(std::optional<int>(0), CalculateWindingNumberFromSource(2.f, 0.f, Circle(1, 64)));
+    EXPECT_EQ(std::optional<int>(-3), CalculateWindingNumberFromSource(0.5f, 0.25f, Circle(-3, 300)));
+
+    // A million vertices, none of them stored.
+    EXPECT_EQ(std::optional<int>(2), CalculateWindingNumberFromSource(0.999f, 0.f, Circle(2, 1 << 20)));
+
+    // The first sample is the first vertex, so the boundary counts like any polygon vertex.
+    EXPECT_EQ(std::optional<int>(1), CalculateWindingNumberFromSource(1.f, 0.f, Circle(1, 8)));
+    EXPECT_FALSE(CalculateWindingNumberFromSource(0.f, 0.f, Circle(1, 0)));
+}
+
+TEST_F(VertexSourceTest, AcceptsAnyCallable) {
+    // A square generated on the fly, and one that never comes back to its first vertex.
+    auto square = [](auto&& visit) {
+        const std::array<std::array<float, 2>, 5> corners{{{0, 0}, {1, 0}, {1, 1}, {0, 1}, {0, 0}}};
+        for (const auto& [x, y] : corners) {
+            visit(x, y);
+        }
+    };
+    auto open = [](auto&& visit) {
+        visit(0.f, 0.f);
+        visit(1.f, 0.f);
+        visit(1.f, 1.f);
+    };
+    EXPECT_EQ(std::optional<int>(1), CalculateWindingNumberFromSource(0.5f, 0.5f, square));
+    EXPECT_FALSE(CalculateWindingNumberFromSource(0.5f, 0.5f, open));
+
+    auto almost_closed = [](auto&& visit) {
+        visit(0.f, 0.f);
+        visit(1.f, 0.f);
+        visit(1.f, 1.f);
+        visit(1e-7f, 0.f);
+    };
+    EXPECT_FALSE(CalculateWindingNumberFromSource(0.5f, 0.25f, almost_closed));
+    EXPECT_EQ(std::optional<int>(1), CalculateWindingNumberFromSource(0.5f, 0.25f, almost_closed, 1e-6f));
+}
+
+TEST_F(VertexSourceTest, BatchWalksTheSourceOnce) {
+    size_t walks = 0;
+    const auto circle = Circle(1, 100);
+    auto counted = [&walks, &circle](auto&& visit) {
+        ++walks;
+        circle(visit);
+    };
+    const auto points = poly::PointBatch::FromPoints({{0.f, 0.f}, {2.f, 0.f}, {1.f, 0.f}, {0.5f, -0.5f}});
+    const auto winding_numbers = CalculateWindingNumbersFromSource(points, counted);
+    EXPECT_EQ(1u, walks);
+    ASSERT_EQ(points.size(), winding_numbers.size());
+    for (size_t i = 0; i < points.size(); ++i) {
+        EXPECT_EQ(CalculateWindingNumberFromSource(points.x_vec_[i], points.y_vec_[i], circle), winding_numbers[i]);
+    }
+}
+
+}  // namespace winding_number
@@ -0,0 +1,113 @@
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <optional>
+#include <random>
+#include <string>
+
+#include <engine_test.hpp>
+#include <poly_io.hpp>
+#include <winding.hpp>
+#include <winding_accumulator.hpp>
+
+namespace winding_number {
+
+using poly::Polygon;
+
+class WindingAccumulatorTest : public EngineTest<> {
+protected:
+    WindingAccumulatorTest() :
+            malformed_polygons_file_path_((std::filesystem::current_path() / "malformed_polygons.txt").string()) {}
+
+    // Feeds a polygon to an accumulator one vertex at a time.
+    std::optional<int> Accumulate(float x, float y, const Polygon& polygon) {
+        WindingAccumulator accumulator(tolerance_);
+        accumulator.StartRecord(x, y);
+        for (size_t i = 0; i < polygon.size(); ++i) {
+            accumulator.AppendPoint(polygon.x_vec_[i], polygon.y_vec_[i]);
+        }
+        accumulator.EndRecord();
+        return accumulator.winding_number();
+    }
+
+    const std::string malformed_polygons_file_path_;
+};
+
+TEST_F(WindingAccumulatorTest, MatchesScalarForPolygonsFromFile) {
+    auto points_and_polygons = reader_->ReadPointsAndPolygonsFromFile(polygons_file_path_);
+    auto result = CalculateWindingNumbersFromFile(polygons_file_path_, *reader_, tolerance_);
+    ASSERT_TRUE(result.ok());
+    ASSERT_FALSE(points_and_polygons.empty());
+    ASSERT_EQ(points_and_polygons.size(), result.records.size());
+    for (size_t i = 0; i < points_and_polygons.size(); ++i) {
+        const auto& [x, y, polygon] = points_and_polygons[i];
+        const auto expected = scalar_->CalculateWindingNumber2D(x, y, polygon);
+        EXPECT_EQ(std::make_tuple(x, y, expected), result.records[i]) << "for record " << i;
+        EXPECT_EQ(expected, Accumulate(x, y, polygon)) << "for record " << i;
+    }
+    EXPECT_EQ(points_and_polygons.size(), result.statistics.records);
+}
+
+TEST_F(WindingAccumulatorTest, MatchesScalarOnRandomPolygons) {
+    // Small integer coordinates make vertices and edges land on grid points, and many of the polygons cross
+    // themselves.
+    std::mt19937 random(42);
+    std::uniform_int_distribution<int> coordinate(0, 4);
+    std::uniform_int_distribution<size_t> size(1, 24);
+    for (int round = 0; round < 50; ++round) {
+        Polygon polygon;
+        for (size_t points = size(random); points > 0; --points) {
+            polygon.AppendPoint(coordinate(random), coordinate(random));
+        }
+        polygon.ClosePolygon();
+        for (float y = -0.5f; y <= 4.5f; y += 0.5f) {
+            for (float x = -0.5f; x <= 4.5f; x += 0.5f) {
+                EXPECT_EQ(scalar_->CalculateWindingNumber2D(x, y, polygon), Accumulate(x, y, polygon))
+                        << "at " << x << ", " << y;
+            }
+        }
+    }
+}
+
+TEST_F(WindingAccumulatorTest, EvaluatesRecordsFromStrings) {
+    auto result = CalculateWindingNumberFromString("0.5 0.5 0.0 0.0 1.0 0.0 1.0 1.0 0.0 1.0 0.0 0.0", *reader_);
+    ASSERT_TRUE(result.ok());
+    EXPECT_EQ(std::make_tuple(0.5f, 0.5f, std::optional<int>(1)), result.record);
+
+    result = CalculateWindingNumberFromString("0.5 0.5 0.0 0.0 0.0 1.0 1.0 1.0 1.0 0.0 0.0 0.0", *reader_);
+    EXPECT_EQ(std::optional<int>(-1), std::get<2>(result.record));
+
+    // Parsed but not closed, and parsed with no polygon at all.
+    result = CalculateWindingNumberFromString("0.5 0.5 0.0 0.0 1.0 0.0 1.0 1.0", *reader_);
+    ASSERT_TRUE(result.ok());
+    EXPECT_FALSE(std::get<2>(result.record));
+    result = CalculateWindingNumberFromString("0.5 0.5", *reader_);
+    ASSERT_TRUE(result.ok());
+    EXPECT_FALSE(std::get<2>(result.record));
+
+    // Closed up to tolerance only.
+    result = CalculateWindingNumberFromString("0.5 0.5 0.0 0.0 1.0 0.0 1.0 1.0 0.0 1.0 0.0 1e-7", *reader_);
+    EXPECT_FALSE(std::get<2>(result.record));
+    result = CalculateWindingNumberFromString("0.5 0.5 0.0 0.0 1.0 0.0 1.0 1.0 0.0 1.0 0.0 1e-7", *reader_, tolerance_);
+    EXPECT_EQ(std::optional<int>(1), std::get<2>(result.record));
+
+    result = CalculateWindingNumberFromString("0.5 0.5 0.0 0.0 1.0 x", *reader_);
+    EXPECT_EQ(poly::ParseStatus::kMalformed, result.status);
+    EXPECT_EQ(20u, result.error_position);
+    EXPECT_EQ(poly::ParseStatus::kComment, CalculateWindingNumberFromString("# 1 2 3", *reader_).status);
+}
+
+TEST_F(WindingAccumulatorTest, SkipsMalformedLinesInFiles) {
+    auto result = CalculateWindingNumbersFromFile(malformed_polygons_file_path_, *reader_);
+    auto read = reader_->TryReadPointsAndPolygonsFromFile(malformed_polygons_file_path_);
+    ASSERT_TRUE(result.ok());
+    ASSERT_EQ(read.records.size(), result.records.size());
+    EXPECT_EQ(read.statistics.malformed_lines, result.statistics.malformed_lines);
+    for (size_t i = 0; i < read.records.size(); ++i) {
+        const auto& [x, y, polygon] = read.records[i];
+        EXPECT_EQ(scalar_->CalculateWindingNumber2D(x, y, polygon), std::get<2>(result.records[i]));
+    }
+    EXPECT_EQ(poly::ReadStatus::kNotAFile, CalculateWindingNumbersFromFile("no_such_file.txt", *reader_).status);
+}
+
+}  // namespace winding_number
@@ -5,6 +5,8 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <cmath>
 #include <filesystem>  // A C++17 capable compiler is assumed here.
 #include <optional>
 #include <string>
@@ -23,6 +25,7 @@ protected:
             reader_(poly::IPolygonReader::Create()),
             algorithm_(IWindingNumberAlgorithm::Create()),
             polygons_file_path_((std::filesystem::current_path() / "polygons.txt").string()),
+            multi_polygons_file_path_((std::filesystem::current_path() / "multipolygons.txt").string()),
             tolerance_(1e-6f) {
         algorithm_->tolerance(tolerance_);
     }
@@ -30,6 +33,7 @@ protected:
     std::unique_ptr<poly::IPolygonReader> reader_;
     std::unique_ptr<IWindingNumberAlgorithm> algorithm_;
     const std::string polygons_file_path_;
+    const std::string multi_polygons_file_path_;
     const float tolerance_;
 };
 
@@ -135,6 +139,175 @@ TEST_F(WindingNumberTest, WindingCalculationsTests){
 
 
 
+}
+
+TEST_F(WindingNumberTest, CanGetWindingNumbersForMultiPolygonsFromFile) {
+    std::vector<std::optional<int>> expected_winding_numbers = {0, 1, 1, 2, 1, std::nullopt};
+    auto points_and_multi_polygons = reader_->ReadPointsAndMultiPolygonsFromFile(multi_polygons_file_path_);
+    ASSERT_EQ(points_and_multi_polygons.size(), expected_winding_numbers.size());
+    for (size_t i = 0; i < expected_winding_numbers.size(); ++i) {
+        const auto& [x, y, multi_polygon] = points_and_multi_polygons[i];
+        EXPECT_EQ(expected_winding_numbers[i], algorithm_->CalculateWindingNumber2D(x, y, multi_polygon))
+                << "for expected_winding_number[" << i << "]";
+    }
+}
+
+TEST_F(WindingNumberTest, MultiPolygonBatchMatchesSinglePointCalls) {
+    auto [x, y, multi_polygon] =
+            reader_->CreatePointAndMultiPolygonFromString("0.0 0.0 0.0 0.0 4.0 0.0 4.0 4.0 0.0 4.0 0.0 0.0 | "
+                                                          "1.0 1.0 1.0 3.0 3.0 3.0 3.0 1.0 1.0 1.0");
+    poly::PointBatch batch = poly::PointBatch::FromPoints(
+            {{x, y}, {2.f, 2.f}, {0.5f, 0.5f}, {-1.f, 2.f}, {9.f, 9.f}, {1.f, 2.f}, {3.5f, 3.5f}});
+    auto winding_numbers = algorithm_->CalculateWindingNumbers2D(batch, multi_polygon);
+    ASSERT_EQ(batch.size(), winding_numbers.size());
+    for (size_t i = 0; i < batch.size(); ++i) {
+        EXPECT_EQ(algorithm_->CalculateWindingNumber2D(batch.x_vec_[i], batch.y_vec_[i], multi_polygon),
+                  winding_numbers[i]);
+    }
+    EXPECT_EQ(0, winding_numbers[1]);
+    EXPECT_EQ(1, winding_numbers[2]);
+}
+
+TEST_F(WindingNumberTest, CreatesRegisteredAlgorithmsByName) {
+    auto algorithms = IWindingNumberAlgorithm::Algorithms();
+    ASSERT_FALSE(algorithms.empty());
+    EXPECT_EQ(IWindingNumberAlgorithm::Create()->name(), algorithms[0].name);
+    for (const auto& info : algorithms) {
+        auto algorithm = IWindingNumberAlgorithm::Create(info.name);
+        ASSERT_TRUE(algorithm) << info.name;
+        EXPECT_EQ(info.name, algorithm->name());
+    }
+    EXPECT_EQ(nullptr, IWindingNumberAlgorithm::Create("no_such_algorithm"));
+}
+
+TEST_F(WindingNumberTest, ImplementationsOutsideTheRegistryOnlyNeedTheWindingNumber) {
+    class Outside : public IWindingNumberAlgorithm {
+    public:
+        std::optional<int> CalculateWindingNumber2D(float, float, poly::Polygon) override {
+            return 0;
+        }
+    };
+    Outside outside;
+    EXPECT_EQ("", outside.name());
+    EXPECT_EQ(std::optional<int>(0), outside.CalculateWindingNumber2D(0.f, 0.f, poly::Polygon()));
+}
+
+TEST_F(WindingNumberTest, RegisteredAlgorithmsAgreeOnPolygonsFromFile) {
+    auto points_and_polygons = reader_->ReadPointsAndPolygonsFromFile(polygons_file_path_);
+    ASSERT_FALSE(points_and_polygons.empty());
+    for (const auto& info : IWindingNumberAlgorithm::Algorithms()) {
+        auto algorithm = IWindingNumberAlgorithm::Create(info.name);
+        algorithm->tolerance(tolerance_);
+        for (size_t i = 0; i < points_and_polygons.size(); ++i) {
+            const auto& [x, y, polygon] = points_and_polygons[i];
+            EXPECT_EQ(algorithm_->CalculateWindingNumber2D(x, y, polygon),
+                      algorithm->CalculateWindingNumber2D(x, y, polygon))
+                    << info.name << " for record " << i;
+        }
+    }
+}
+
+TEST_F(WindingNumberTest, PreparedPolygonsMatchCallsThatPassThePolygon) {
+    auto points_and_polygons = reader_->ReadPointsAndPolygonsFromFile(polygons_file_path_);
+    ASSERT_FALSE(points_and_polygons.empty());
+    for (const auto& info : IWindingNumberAlgorithm::Algorithms()) {
+        auto algorithm = IWindingNumberAlgorithm::Create(info.name);
+        algorithm->tolerance(tolerance_);
+        for (size_t i = 0; i < points_and_polygons.size(); ++i) {
+            const auto& [x, y, polygon] = points_and_polygons[i];
+            const auto prepared = algorithm->Prepare(polygon);
+            poly::PointBatch points;
+            points.AppendPoint(x, y);
+            points.AppendPoint(x + 0.5f, y - 0.25f);
+            // Another polygon through the algorithm in between must not disturb the handle.
+            algorithm->CalculateWindingNumber2D(x, y, std::get<2>(points_and_polygons[0]));
+            EXPECT_EQ(algorithm->CalculateWindingNumbers2D(points, polygon),
+                      prepared->CalculateWindingNumbers2D(points))
+                    << info.name << " for record " << i;
+            EXPECT_EQ(algorithm->CalculateWindingNumber2D(x, y, polygon), prepared->CalculateWindingNumber2D(x, y))
+                    << info.name << " for record " << i;
+        }
+
+        Polygon unclosed;
+        unclosed.AppendPoint(0.0, 0.0);
+        unclosed.AppendPoint(1.0, 0.0);
+        unclosed.AppendPoint(1.0, 1.0);
+        EXPECT_EQ(std::nullopt, algorithm->Prepare(unclosed)->CalculateWindingNumber2D(0.75, 0.25)) << info.name;
+    }
+}
+
+TEST_F(WindingNumberTest, PreparedAlgorithmsFollowPolygonChanges) {
+    Polygon square;
+    square.AppendPoint(0.0, 0.0);
+    square.AppendPoint(1.0, 0.0);
+    square.AppendPoint(1.0, 1.0);
+    square.AppendPoint(0.0, 1.0);
+    square.ClosePolygon();
+    Polygon reversed = square;
+    std::reverse(reversed.x_vec_.begin(), reversed.x_vec_.end());
+    std::reverse(reversed.y_vec_.begin(), reversed.y_vec_.end());
+    Polygon unclosed = square;
+    unclosed.x_vec_.pop_back();
+    unclosed.y_vec_.pop_back();
+    for (const auto& info : IWindingNumberAlgorithm::Algorithms()) {
+        auto algorithm = IWindingNumberAlgorithm::Create(info.name);
+        EXPECT_EQ(1, algorithm->CalculateWindingNumber2D(0.5, 0.5, square)) << info.name;
+        EXPECT_EQ(1, algorithm->CalculateWindingNumber2D(0.25, 0.5, square)) << info.name;
+        EXPECT_EQ(-1, algorithm->CalculateWindingNumber2D(0.5, 0.5, reversed)) << info.name;
+        EXPECT_EQ(std::nullopt, algorithm->CalculateWindingNumber2D(0.5, 0.5, unclosed)) << info.name;
+        EXPECT_EQ(1, algorithm->CalculateWindingNumber2D(0.5, 0.5, square)) << info.name;
+    }
+}
+
+TEST_F(WindingNumberTest, HintsPickAlgorithmsWithTheRequiredPrecision) {
+    auto algorithms = IWindingNumberAlgorithm::Algorithms();
+    auto precision_of = [&](const std::string& name) {
+        return std::find_if(algorithms.begin(), algorithms.end(), [&](const auto& info) { return info.name == name; })
+                ->precision;
+    };
+    for (size_t polygon_size : {0, 4, 64, 100000}) {
+        for (size_t batch_size : {1, 16, 1000000}) {
+            AlgorithmHints hints;
+            hints.polygon_size = polygon_size;
+            hints.batch_size = batch_size;
+            hints.precision = Precision::kExactBoundary;
+            auto algorithm = IWindingNumberAlgorithm::Create(hints);
+            ASSERT_TRUE(algorithm);
+            EXPECT_EQ(Precision::kExactBoundary, precision_of(algorithm->name()))
+                    << algorithm->name() << " for " << polygon_size << " vertices and " << batch_size << " points";
+        }
+    }
+    AlgorithmHints large;
+    large.polygon_size = 100000;
+    large.batch_size = 100000;
+    EXPECT_EQ("bvh", IWindingNumberAlgorithm::Create(large)->name());
+    AlgorithmHints tiles;
+    tiles.polygon_size = 5;
+    tiles.batch_size = 1000;
+    EXPECT_EQ("small", IWindingNumberAlgorithm::Create(tiles)->name());
+    AlgorithmHints single;
+    single.batch_size = 1;
+    EXPECT_EQ("scalar", IWindingNumberAlgorithm::Create(single)->name());
+}
+
+TEST_F(WindingNumberTest, AutotunePicksAnAlgorithmWithTheRequiredPrecision) {
+    Polygon circle;
+    for (int i = 0; i < 200; ++i) {
+        circle.AppendPoint(std::cos(6.2831853f * i / 200), std::sin(6.2831853f * i / 200));
+    }
+    circle.ClosePolygon();
+    poly::PointBatch points;
+    for (int i = 0; i < 100; ++i) {
+        points.AppendPoint(-1.5f + 0.03f * i, 0.01f * i - 0.5f);
+    }
+    AlgorithmHints hints;
+    hints.precision = Precision::kExactBoundary;
+    auto algorithm = IWindingNumberAlgorithm::Create(hints, circle, points);
+    ASSERT_TRUE(algorithm);
+    EXPECT_NE("improved", algorithm->name());
+    EXPECT_NE("simd", algorithm->name());
+    EXPECT_NE("prepared_slope", algorithm->name());
+    EXPECT_EQ(1, algorithm->CalculateWindingNumber2D(0.f, 0.f, circle));
 }
 
 // Hint, you will probably also want to add more tests...